@@ -37,6 +37,12 @@
 #include "Model/WorldNode.h"
 
 #include <vecmath/bbox.h>
+#include <vecmath/ray.h>
+#include <vecmath/vec.h>
+
+#include <cstdio>
+#include <random>
+#include <vector>
 
 namespace TrenchBroom {
     using AABB = AABBTree<double, 3, Model::Node*>;
@@ -63,6 +69,52 @@ namespace TrenchBroom {
         }
     };
 
+    class CollectTreeNodes : public Model::NodeVisitor {
+    private:
+        std::vector<Model::Node*> m_nodes;
+    public:
+        const std::vector<Model::Node*>& nodes() const {
+            return m_nodes;
+        }
+    private:
+        void doVisit(Model::WorldNode*) override {}
+        void doVisit(Model::LayerNode*) override {}
+        void doVisit(Model::GroupNode*) override {}
+        void doVisit(Model::EntityNode* entity) override {
+            m_nodes.push_back(entity);
+        }
+        void doVisit(Model::BrushNode* brush) override {
+            m_nodes.push_back(brush);
+        }
+    };
+
+    /**
+     * Casts a fixed set of pseudo random rays through the given bounds and returns the average number of tree nodes
+     * visited by a ray query.
+     */
+    static double averageRayQueryVisits(const AABB& tree, const BOX& bounds) {
+        std::mt19937 rng(1337u);
+        std::uniform_real_distribution<double> unit(0.0, 1.0);
+        std::uniform_real_distribution<double> signedUnit(-1.0, 1.0);
+
+        const auto rayCount = 10000u;
+        auto totalVisits = size_t(0);
+        for (size_t i = 0; i < rayCount; ++i) {
+            auto origin = bounds.min;
+            auto direction = vm::vec3::zero();
+            for (size_t j = 0; j < 3u; ++j) {
+                origin[j] += bounds.size()[j] * unit(rng);
+                direction[j] = signedUnit(rng);
+            }
+            if (vm::is_zero(direction, vm::C::almost_zero())) {
+                direction = vm::vec3::pos_x();
+            }
+            totalVisits += tree.countIntersectorVisits(vm::ray3(origin, vm::normalize(direction)));
+        }
+
+        return static_cast<double>(totalVisits) / static_cast<double>(rayCount);
+    }
+
     TEST_CASE("AABBTreeBenchmark.benchBuildTree", "[AABBTreeBenchmark]") {
         const auto mapPath = IO::Disk::getCurrentWorkingDir() + IO::Path("fixture/benchmark/AABBTree/ne_ruins.map");
         const auto file = IO::Disk::openFile(mapPath);
@@ -81,5 +133,24 @@ namespace TrenchBroom {
                 world->acceptAndRecurse(builder);
             }
         }, "Add objects to AABB tree");
+
+        CollectTreeNodes collect;
+        world->acceptAndRecurse(collect);
+
+        std::vector<AABB> bulkTrees(100);
+        timeLambda([&collect, &bulkTrees]() {
+            for (auto& tree : bulkTrees) {
+                tree.clearAndBuild(collect.nodes(), [](const auto* node) { return node->physicalBounds(); });
+            }
+        }, "Bulk build AABB tree");
+
+        const auto& incrementalTree = trees.front();
+        const auto& bulkTree = bulkTrees.front();
+        const auto bounds = incrementalTree.bounds();
+
+        printf("Incrementally built tree: height %zu, %f nodes visited per ray query\n",
+               incrementalTree.height(), averageRayQueryVisits(incrementalTree, bounds));
+        printf("Bulk built tree: height %zu, %f nodes visited per ray query\n",
+               bulkTree.height(), averageRayQueryVisits(bulkTree, bounds));
     }
 }
@@ -0,0 +1,147 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <catch2/catch.hpp>
+
+#include "../../test/src/GTestCompat.h"
+
+#include "BenchmarkUtils.h"
+
+#include "Logger.h"
+#include "Assets/Palette.h"
+#include "Assets/Texture.h"
+#include "Assets/TextureCollection.h"
+#include "IO/DiskFileSystem.h"
+#include "IO/DiskIO.h"
+#include "IO/File.h"
+#include "IO/FileMatcher.h"
+#include "IO/IdMipTextureReader.h"
+#include "IO/Path.h"
+#include "IO/TextureCollectionLoader.h"
+#include "IO/WadFileSystem.h"
+
+#include <kdl/vector_utils.h>
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace IO {
+        static void writeInt32(std::ostream& stream, const std::int32_t value) {
+            stream.write(reinterpret_cast<const char*>(&value), sizeof(value));
+        }
+
+        static void writeName(std::ostream& stream, const std::string& name) {
+            char buffer[16];
+            std::memset(buffer, 0, sizeof(buffer));
+            std::strncpy(buffer, name.c_str(), sizeof(buffer) - 1u);
+            stream.write(buffer, sizeof(buffer));
+        }
+
+        /**
+         * Writes a WAD2 file containing the given number of 64*64 mip textures with random contents.
+         */
+        static void writeSyntheticWad(const Path& path, const size_t textureCount) {
+            static const std::int32_t Size = 64;
+            static const std::int32_t HeaderSize = 16 + 6 * 4;
+            static const std::int32_t TextureSize = HeaderSize + Size * Size + (Size / 2) * (Size / 2) + (Size / 4) * (Size / 4) + (Size / 8) * (Size / 8);
+
+            std::mt19937 rng(1337u);
+            std::uniform_int_distribution<int> index(0, 254);
+
+            std::ofstream stream(path.asString(), std::ios::out | std::ios::binary);
+            stream.write("WAD2", 4);
+            writeInt32(stream, static_cast<std::int32_t>(textureCount));
+            writeInt32(stream, 12 + static_cast<std::int32_t>(textureCount) * TextureSize);
+
+            for (size_t i = 0; i < textureCount; ++i) {
+                writeName(stream, "texture_" + std::to_string(i));
+                writeInt32(stream, Size);
+                writeInt32(stream, Size);
+
+                auto offset = HeaderSize;
+                for (std::int32_t mip = 0; mip < 4; ++mip) {
+                    writeInt32(stream, offset);
+                    offset += (Size >> mip) * (Size >> mip);
+                }
+
+                for (auto pixel = HeaderSize; pixel < TextureSize; ++pixel) {
+                    stream.put(static_cast<char>(index(rng)));
+                }
+            }
+
+            for (size_t i = 0; i < textureCount; ++i) {
+                writeInt32(stream, 12 + static_cast<std::int32_t>(i) * TextureSize);
+                writeInt32(stream, TextureSize);
+                writeInt32(stream, TextureSize);
+                stream.put('D');
+                stream.put(0);
+                stream.put(0);
+                stream.put(0);
+                writeName(stream, "texture_" + std::to_string(i));
+            }
+        }
+
+        static Assets::Palette makeSyntheticPalette() {
+            std::vector<unsigned char> data(3u * 256u);
+            for (size_t i = 0; i < data.size(); ++i) {
+                data[i] = static_cast<unsigned char>(i / 3u);
+            }
+            return Assets::Palette(data);
+        }
+
+        TEST_CASE("TextureLoaderBenchmark.loadWad", "[TextureLoaderBenchmark]") {
+            const auto root = Disk::getCurrentWorkingDir();
+            const auto wadPath = Path("TextureLoaderBenchmark.wad");
+            writeSyntheticWad(root + wadPath, 5000u);
+
+            NullLogger logger;
+            const DiskFileSystem fileSystem(root, true);
+            const TextureReader::TextureNameStrategy nameStrategy;
+            const IdMipTextureReader textureReader(nameStrategy, fileSystem, logger, makeSyntheticPalette());
+
+            std::vector<std::string> sequentialNames;
+            timeLambda([&]() {
+                WadFileSystem wadFS(root + wadPath, logger);
+                for (const auto& texturePath : wadFS.findItems(Path(""), FileExtensionMatcher("D"))) {
+                    auto texture = std::unique_ptr<Assets::Texture>(textureReader.readTexture(wadFS.openFile(texturePath)));
+                    sequentialNames.push_back(texture->name());
+                }
+            }, "Load 5000 textures from a WAD file sequentially");
+
+            std::vector<std::string> concurrentNames;
+            timeLambda([&]() {
+                FileTextureCollectionLoader collectionLoader(logger, { root }, {});
+                const auto collection = collectionLoader.loadTextureCollection(wadPath, { "D" }, textureReader);
+                concurrentNames = kdl::vec_transform(collection->textures(), [](const auto* texture) { return texture->name(); });
+            }, "Load 5000 textures from a WAD file concurrently");
+
+            CHECK(sequentialNames.size() == 5000u);
+            CHECK(concurrentNames == sequentialNames);
+
+            Disk::deleteFile(root + wadPath);
+        }
+    }
+}
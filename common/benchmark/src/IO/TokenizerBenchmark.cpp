@@ -0,0 +1,100 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <catch2/catch.hpp>
+
+#include "../../test/src/GTestCompat.h"
+
+#include "Macros.h"
+#include "IO/DiskIO.h"
+#include "IO/File.h"
+#include "IO/Path.h"
+#include "IO/Reader.h"
+#include "IO/StandardMapParser.h"
+#include "IO/TestParserStatus.h"
+#include "IO/WorldReader.h"
+#include "Model/WorldNode.h"
+
+#include <vecmath/bbox.h>
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+namespace TrenchBroom {
+    namespace IO {
+        static constexpr size_t NumIterations = 10;
+
+        template <typename L>
+        static void timeThroughput(L&& lambda, const size_t bytes, const std::string& message) {
+            const auto start = std::chrono::high_resolution_clock::now();
+            for (size_t i = 0; i < NumIterations; ++i) {
+                lambda();
+            }
+            const auto end = std::chrono::high_resolution_clock::now();
+
+            const auto seconds = std::chrono::duration<double>(end - start).count();
+            const auto megabytes = static_cast<double>(bytes * NumIterations) / (1024.0 * 1024.0);
+            printf("Throughput for '%s': %fMB/s (%fms per iteration)\n", message.c_str(), megabytes / seconds, seconds * 1000.0 / NumIterations);
+        }
+
+        TEST_CASE("TokenizerBenchmark.benchTokenizeMap", "[TokenizerBenchmark]") {
+            const auto mapPath = Disk::getCurrentWorkingDir() + Path("fixture/benchmark/AABBTree/ne_ruins.map");
+            const auto file = Disk::openFile(mapPath);
+            auto fileReader = file->reader().buffer();
+            const auto begin = std::begin(fileReader);
+            const auto end = std::end(fileReader);
+            const auto bytes = static_cast<size_t>(end - begin);
+
+            size_t tokenCount = 0;
+            double checksum = 0.0;
+            timeThroughput([&]() {
+                QuakeMapTokenizer tokenizer(begin, end);
+                auto token = tokenizer.nextToken();
+                while (!token.hasType(QuakeMapToken::Eof)) {
+                    if (token.hasType(QuakeMapToken::Number)) {
+                        checksum += token.toFloat<double>();
+                    }
+                    ++tokenCount;
+                    token = tokenizer.nextToken();
+                }
+            }, bytes, "Tokenize ne_ruins.map");
+
+            ASSERT_GT(tokenCount, 0u);
+            unused(checksum);
+        }
+
+        TEST_CASE("TokenizerBenchmark.benchParseMap", "[TokenizerBenchmark]") {
+            const auto mapPath = Disk::getCurrentWorkingDir() + Path("fixture/benchmark/AABBTree/ne_ruins.map");
+            const auto file = Disk::openFile(mapPath);
+            auto fileReader = file->reader().buffer();
+            const auto begin = std::begin(fileReader);
+            const auto end = std::end(fileReader);
+            const auto bytes = static_cast<size_t>(end - begin);
+
+            const vm::bbox3 worldBounds(8192.0);
+            timeThroughput([&]() {
+                TestParserStatus status;
+                WorldReader worldReader(begin, end);
+                auto world = worldReader.read(Model::MapFormat::Standard, worldBounds, status);
+                ASSERT_TRUE(world != nullptr);
+            }, bytes, "Read ne_ruins.map");
+        }
+    }
+}
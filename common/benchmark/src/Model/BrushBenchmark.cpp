@@ -0,0 +1,150 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <catch2/catch.hpp>
+
+#include "../../test/src/GTestCompat.h"
+
+#include "BenchmarkUtils.h"
+
+#include "Model/Brush.h"
+#include "Model/BrushBuilder.h"
+#include "Model/BrushFace.h"
+#include "Model/BrushGeometry.h"
+#include "Model/MapFormat.h"
+#include "Model/Polyhedron.h"
+#include "Model/WorldNode.h"
+
+#include <vecmath/bbox.h>
+#include <vecmath/mat.h>
+#include <vecmath/mat_ext.h>
+#include <vecmath/vec.h>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Model {
+        /**
+         * Creates a grid of cubes. If rotated is true, every cube is rotated around the Z axis so that its vertices
+         * are not integral anymore.
+         */
+        static std::vector<Brush> makeBrushGrid(const BrushBuilder& builder, const vm::bbox3& worldBounds, const size_t count, const bool rotated) {
+            const auto rotation = vm::rotation_matrix(vm::vec3::pos_z(), vm::to_radians(15.0));
+
+            std::vector<Brush> result;
+            result.reserve(count);
+            for (size_t i = 0; i < count; ++i) {
+                auto brush = builder.createCube(32.0, "texture");
+
+                const auto offset = vm::vec3(static_cast<FloatType>(i % 100u), static_cast<FloatType>(i / 100u), 0.0) * 64.0 - vm::vec3(3200.0, 3200.0, 0.0);
+                const auto transformation = rotated ? vm::translation_matrix(offset) * rotation : vm::translation_matrix(offset);
+                brush.transform(transformation, false, worldBounds);
+                result.push_back(std::move(brush));
+            }
+            return result;
+        }
+
+        /**
+         * Simulates dragging the given brushes along the X axis in grid sized steps, checking every step before
+         * applying it just like the transform command does.
+         */
+        static void dragBrushes(std::vector<Brush>& brushes, const vm::bbox3& worldBounds, const size_t stepCount) {
+            for (size_t i = 0; i < stepCount; ++i) {
+                const auto delta = vm::translation_matrix(vm::vec3(i % 2u == 0u ? 16.0 : -16.0, 0.0, 0.0));
+                for (auto& brush : brushes) {
+                    if (brush.canTransform(delta, worldBounds)) {
+                        brush.transform(delta, true, worldBounds);
+                    }
+                }
+            }
+        }
+
+        /**
+         * Estimates the memory occupied by the geometry of the given brush, excluding allocator overhead.
+         */
+        static size_t geometrySize(const Brush& brush) {
+            return sizeof(BrushGeometry)
+                + brush.vertexCount() * sizeof(BrushVertex)
+                + brush.edgeCount() * (sizeof(BrushEdge) + 2u * sizeof(BrushHalfEdge))
+                + brush.faceCount() * sizeof(BrushFaceGeometry);
+        }
+
+        /**
+         * Returns the estimated size of the geometries of the given copies which are not shared with the given
+         * brushes.
+         */
+        static size_t unsharedGeometrySize(const std::vector<Brush>& copies, const std::vector<Brush>& brushes) {
+            auto result = size_t(0);
+            for (size_t i = 0; i < copies.size(); ++i) {
+                if (!copies[i].sharesGeometryWith(brushes[i])) {
+                    result += geometrySize(copies[i]);
+                }
+            }
+            return result;
+        }
+
+        TEST_CASE("BrushBenchmark.snapshotBrushes", "[BrushBenchmark]") {
+            const vm::bbox3 worldBounds(8192.0);
+            WorldNode world(MapFormat::Standard);
+            const BrushBuilder builder(&world, worldBounds);
+
+            auto brushes = makeBrushGrid(builder, worldBounds, 10000u, false);
+
+            auto totalSize = size_t(0);
+            for (const auto& brush : brushes) {
+                totalSize += geometrySize(brush);
+            }
+            std::printf("Geometry of 10k brushes: %zu KiB\n", totalSize / 1024u);
+
+            // brush snapshots used to keep only the faces and rebuild the geometry when they were restored
+            auto restored = std::vector<Brush>();
+            timeLambda([&]() {
+                restored.clear();
+                restored.reserve(brushes.size());
+                for (const auto& brush : brushes) {
+                    restored.emplace_back(worldBounds, brush.faces());
+                }
+            }, "rebuild 10k brushes from their faces");
+            CHECK(unsharedGeometrySize(restored, brushes) == totalSize);
+
+            // a brush snapshot keeps a copy of the brush, which shares the geometry until either is modified
+            auto snapshot = std::vector<Brush>();
+            timeLambda([&]() { snapshot = brushes; }, "snapshot 10k brushes");
+            CHECK(unsharedGeometrySize(snapshot, brushes) == 0u);
+
+            dragBrushes(brushes, worldBounds, 1u);
+            std::printf("Geometry held by the snapshot after transforming the brushes: %zu KiB\n",
+                unsharedGeometrySize(snapshot, brushes) / 1024u);
+        }
+
+        TEST_CASE("BrushBenchmark.dragBrushes", "[BrushBenchmark]") {
+            const vm::bbox3 worldBounds(8192.0);
+            WorldNode world(MapFormat::Standard);
+            const BrushBuilder builder(&world, worldBounds);
+
+            auto gridBrushes = makeBrushGrid(builder, worldBounds, 10000u, false);
+            timeLambda([&]() { dragBrushes(gridBrushes, worldBounds, 10u); }, "drag 10k grid aligned brushes 10 steps (in place)");
+
+            auto rotatedBrushes = makeBrushGrid(builder, worldBounds, 10000u, true);
+            timeLambda([&]() { dragBrushes(rotatedBrushes, worldBounds, 10u); }, "drag 10k rotated brushes 10 steps (rebuild)");
+        }
+    }
+}
@@ -0,0 +1,105 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <catch2/catch.hpp>
+
+#include "../../test/src/GTestCompat.h"
+
+#include "IO/DiskIO.h"
+#include "IO/File.h"
+#include "IO/Path.h"
+#include "IO/Reader.h"
+#include "IO/TestParserStatus.h"
+#include "IO/WorldReader.h"
+#include "Model/LayerNode.h"
+#include "Model/PickResult.h"
+#include "Model/WorldNode.h"
+
+#include <vecmath/bbox.h>
+#include <vecmath/ray.h>
+#include <vecmath/vec.h>
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Model {
+        /**
+         * Returns a fixed set of pseudo random rays that start within the given bounds.
+         */
+        static std::vector<vm::ray3> makePickRays(const vm::bbox3& bounds, const size_t count) {
+            std::mt19937 rng(1337u);
+            std::uniform_real_distribution<FloatType> unit(0.0, 1.0);
+            std::uniform_real_distribution<FloatType> signedUnit(-1.0, 1.0);
+
+            std::vector<vm::ray3> result;
+            result.reserve(count);
+            while (result.size() < count) {
+                auto origin = bounds.min;
+                auto direction = vm::vec3::zero();
+                for (size_t i = 0; i < 3u; ++i) {
+                    origin[i] += bounds.size()[i] * unit(rng);
+                    direction[i] = signedUnit(rng);
+                }
+                if (!vm::is_zero(direction, vm::C::almost_zero())) {
+                    result.emplace_back(origin, vm::normalize(direction));
+                }
+            }
+            return result;
+        }
+
+        template <typename L>
+        static void timePicks(L&& lambda, const size_t pickCount, const std::string& message) {
+            const auto start = std::chrono::high_resolution_clock::now();
+            const auto hitCount = lambda();
+            const auto end = std::chrono::high_resolution_clock::now();
+
+            const auto seconds = std::chrono::duration<double>(end - start).count();
+            printf("%s: %zu picks, %zu hits, %f picks/s\n", message.c_str(), pickCount, hitCount,
+                   static_cast<double>(pickCount) / seconds);
+        }
+
+        TEST_CASE("PickBenchmark.benchPick", "[PickBenchmark]") {
+            const auto mapPath = IO::Disk::getCurrentWorkingDir() + IO::Path("fixture/benchmark/AABBTree/ne_ruins.map");
+            const auto file = IO::Disk::openFile(mapPath);
+            auto fileReader = file->reader().buffer();
+
+            IO::TestParserStatus status;
+            IO::WorldReader worldReader(std::begin(fileReader), std::end(fileReader));
+
+            const vm::bbox3 worldBounds(8192.0);
+            auto world = worldReader.read(MapFormat::Standard, worldBounds, status);
+
+            const auto pickRays = makePickRays(world->defaultLayer()->physicalBounds(), 100000u);
+
+            timePicks([&]() {
+                auto hitCount = size_t(0);
+                for (const auto& pickRay : pickRays) {
+                    PickResult pickResult;
+                    world->pick(pickRay, pickResult);
+                    hitCount += pickResult.size();
+                }
+                return hitCount;
+            }, pickRays.size(), "Pick with single rays");
+        }
+    }
+}
@@ -0,0 +1,81 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <catch2/catch.hpp>
+
+#include "../../test/src/GTestCompat.h"
+
+#include "BenchmarkUtils.h"
+
+#include "FloatType.h"
+#include "Model/Polyhedron.h"
+#include "Model/Polyhedron3.h"
+#include "Model/Polyhedron_Instantiation.h"
+
+#include <kdl/parallel.h>
+
+#include <vecmath/bbox.h>
+#include <vecmath/vec.h>
+
+#include <random>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Model {
+        /**
+         * Returns a fixed set of pseudo random point clouds, each of which spans a convex polyhedron.
+         */
+        static std::vector<std::vector<vm::vec3>> makePointClouds(const size_t count, const size_t pointsPerCloud) {
+            std::mt19937 rng(1337u);
+            std::uniform_real_distribution<FloatType> coord(-64.0, 64.0);
+
+            std::vector<std::vector<vm::vec3>> result(count);
+            for (auto& points : result) {
+                for (size_t i = 0; i < pointsPerCloud; ++i) {
+                    points.emplace_back(coord(rng), coord(rng), coord(rng));
+                }
+            }
+            return result;
+        }
+
+        static void buildAndDestroy(const std::vector<std::vector<vm::vec3>>& pointClouds, const size_t threadCount) {
+            kdl::parallel_for(pointClouds.size(), [&](const size_t i) {
+                const Polyhedron3 polyhedron(pointClouds[i]);
+            }, threadCount);
+        }
+
+        TEST_CASE("PolyhedronBenchmark.benchBuildAndDestroy", "[PolyhedronBenchmark]") {
+            const auto cuboidCount = 200000u;
+            timeLambda([&]() {
+                for (size_t i = 0; i < cuboidCount; ++i) {
+                    const Polyhedron3 polyhedron(vm::bbox3(vm::vec3(-16.0, -16.0, -16.0), vm::vec3(16.0, 16.0, 16.0)));
+                }
+            }, "Build and destroy 200000 cuboids");
+
+            const auto pointClouds = makePointClouds(20000u, 32u);
+            timeLambda([&]() {
+                buildAndDestroy(pointClouds, 1u);
+            }, "Build and destroy 20000 convex hulls on one thread");
+
+            timeLambda([&]() {
+                buildAndDestroy(pointClouds, kdl::parallel_default_thread_count());
+            }, "Build and destroy 20000 convex hulls on all threads");
+        }
+    }
+}
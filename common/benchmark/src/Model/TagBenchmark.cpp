@@ -0,0 +1,132 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <catch2/catch.hpp>
+
+#include "../../test/src/GTestCompat.h"
+
+#include "BenchmarkUtils.h"
+
+#include "Model/Brush.h"
+#include "Model/BrushBuilder.h"
+#include "Model/BrushFace.h"
+#include "Model/BrushNode.h"
+#include "Model/LayerNode.h"
+#include "Model/MapFormat.h"
+#include "Model/Tag.h"
+#include "Model/TagManager.h"
+#include "Model/TagMatcher.h"
+#include "Model/WorldNode.h"
+
+#include <vecmath/bbox.h>
+#include <vecmath/mat.h>
+#include <vecmath/mat_ext.h>
+#include <vecmath/vec.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Model {
+        static std::vector<SmartTag> makeSmartTags() {
+            return {
+                SmartTag("Trigger", {}, std::make_unique<EntityClassNameTagMatcher>("trigger*", "trigger")),
+                SmartTag("Clip", {}, std::make_unique<TextureNameTagMatcher>("clip*")),
+                SmartTag("Skip", {}, std::make_unique<TextureNameTagMatcher>("skip*")),
+                SmartTag("Hint", {}, std::make_unique<TextureNameTagMatcher>("hint*")),
+                SmartTag("Liquid", {}, std::make_unique<TextureNameTagMatcher>("*water*")),
+                SmartTag("Detail", {}, std::make_unique<ContentFlagsTagMatcher>(1 << 27)),
+                SmartTag("Sky", {}, std::make_unique<TextureNameTagMatcher>("sky*"))
+            };
+        }
+
+        /**
+         * Adds a grid of cubes to the default layer of the given world, using textures from a pool of 256 texture
+         * names, some of which match the texture name tags above.
+         */
+        static std::vector<BrushNode*> addBrushGrid(WorldNode& world, const vm::bbox3& worldBounds, const size_t count) {
+            const BrushBuilder builder(&world, worldBounds);
+            const auto prefixes = std::vector<std::string>{ "base/wall", "base/floor", "clip", "skip", "hint", "*water", "sky" };
+
+            std::vector<BrushNode*> result;
+            result.reserve(count);
+            for (size_t i = 0; i < count; ++i) {
+                const auto textureIndex = i % 256u;
+                const auto textureName = prefixes[textureIndex % prefixes.size()] + std::to_string(textureIndex);
+                auto brush = builder.createCube(32.0, textureName);
+
+                const auto offset = vm::vec3(static_cast<FloatType>(i % 256u), static_cast<FloatType>(i / 256u), 0.0) * 32.0 - vm::vec3(4096.0, 4096.0, 0.0);
+                brush.transform(vm::translation_matrix(offset), false, worldBounds);
+
+                auto* brushNode = world.createBrush(std::move(brush));
+                world.defaultLayer()->addChild(brushNode);
+                result.push_back(brushNode);
+            }
+            return result;
+        }
+
+        TEST_CASE("TagBenchmark.tagBrushes", "[TagBenchmark]") {
+            const vm::bbox3 worldBounds(8192.0);
+            WorldNode world(MapFormat::Standard);
+            const auto brushNodes = addBrushGrid(world, worldBounds, 65536u);
+
+            TagManager tagManager;
+            tagManager.registerSmartTags(makeSmartTags());
+
+            auto matchCount = size_t(0);
+            timeLambda([&]() {
+                for (auto* brushNode : brushNodes) {
+                    for (const auto& face : brushNode->brush().faces()) {
+                        for (const auto& tag : tagManager.smartTags()) {
+                            if (tag.matches(face)) {
+                                ++matchCount;
+                            }
+                        }
+                    }
+                }
+            }, "match every smart tag against every face of 64k brushes");
+            CHECK(matchCount > 0u);
+
+            timeLambda([&]() {
+                for (auto* brushNode : brushNodes) {
+                    brushNode->initializeTags(tagManager);
+                }
+            }, "initialize tags of 64k brushes");
+
+            timeLambda([&]() {
+                for (auto* brushNode : brushNodes) {
+                    brushNode->updateTags(tagManager);
+                }
+            }, "update tags of 64k brushes");
+
+            const auto& clipTag = tagManager.smartTag("Clip");
+            auto clipFaceCount = size_t(0);
+            for (auto* brushNode : brushNodes) {
+                for (const auto& face : brushNode->brush().faces()) {
+                    if (face.hasTag(clipTag)) {
+                        CHECK(face.attributes().textureName().substr(0, 4) == "clip");
+                        ++clipFaceCount;
+                    }
+                }
+            }
+            CHECK(clipFaceCount > 0u);
+        }
+    }
+}
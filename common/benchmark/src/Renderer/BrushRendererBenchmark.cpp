@@ -31,6 +31,8 @@
 #include "Model/MapFormat.h"
 #include "Renderer/BrushRenderer.h"
 
+#include <kdl/parallel.h>
+
 #include <vector>
 #include <chrono>
 #include <string>
@@ -129,6 +131,36 @@ namespace TrenchBroom {
             kdl::vec_clear_and_delete(brushes);
             kdl::vec_clear_and_delete(textures);
         }
+
+        TEST_CASE("BrushRendererBenchmark.benchValidateThreads", "[BrushRendererBenchmark]") {
+            auto brushesTextures = makeBrushes();
+            std::vector<Model::BrushNode*> brushes = brushesTextures.first;
+            std::vector<Assets::Texture*> textures = brushesTextures.second;
+
+            // 1, 2, 4, ... threads up to the number of hardware threads
+            const auto maxThreadCount = kdl::parallel_default_thread_count();
+            std::vector<size_t> threadCounts;
+            for (size_t threadCount = 1u; threadCount < maxThreadCount; threadCount *= 2u) {
+                threadCounts.push_back(threadCount);
+            }
+            threadCounts.push_back(maxThreadCount);
+
+            for (const auto threadCount : threadCounts) {
+                // include building the vertex caches in the timing since that is part of the parallel work
+                for (auto* brush : brushes) {
+                    brush->invalidateVertexCache();
+                }
+
+                BrushRenderer r;
+                r.addBrushes(brushes);
+
+                timeLambda([&](){ r.validate(threadCount); },
+                           "validate " + std::to_string(brushes.size()) + " brushes with " + std::to_string(threadCount) + " thread(s)");
+            }
+
+            kdl::vec_clear_and_delete(brushes);
+            kdl::vec_clear_and_delete(textures);
+        }
     }
 }
 
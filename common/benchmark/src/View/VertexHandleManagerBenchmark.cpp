@@ -0,0 +1,96 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <catch2/catch.hpp>
+
+#include "../../test/src/GTestCompat.h"
+
+#include "BenchmarkUtils.h"
+
+#include "PreferenceManager.h"
+#include "Preferences.h"
+#include "Model/Hit.h"
+#include "Model/PickResult.h"
+#include "Renderer/PerspectiveCamera.h"
+#include "View/VertexHandleManager.h"
+
+#include <vecmath/ray.h>
+#include <vecmath/vec.h>
+
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace View {
+        TEST_CASE("VertexHandleManagerBenchmark.pick", "[VertexHandleManagerBenchmark]") {
+            std::mt19937 rng(1337u);
+            std::uniform_int_distribution<int> coord(-256, 256);
+
+            VertexHandleManager manager;
+            while (manager.totalHandleCount() < 100000u) {
+                manager.add(vm::vec3(16.0 * coord(rng), 16.0 * coord(rng), 16.0 * coord(rng)));
+            }
+
+            const Renderer::Camera::Viewport viewport(0, 0, 1920, 1080);
+            const Renderer::PerspectiveCamera camera(90.0f, 1.0f, 8000.0f, viewport, vm::vec3f(-1024.0f, -512.0f, 256.0f), vm::vec3f::pos_x(), vm::vec3f::pos_z());
+
+            std::vector<vm::ray3> pickRays;
+            for (int x = 0; x < viewport.width; x += 96) {
+                for (int y = 0; y < viewport.height; y += 108) {
+                    pickRays.emplace_back(camera.pickRay(x, y));
+                }
+            }
+
+            const auto handleRadius = static_cast<FloatType>(pref(Preferences::HandleRadius));
+            auto exhaustiveHits = size_t(0);
+            timeLambda([&]() {
+                for (const auto& pickRay : pickRays) {
+                    Model::PickResult pickResult;
+                    manager.pick([&](const vm::vec3& position) {
+                        const auto distance = camera.pickPointHandle(pickRay, position, handleRadius);
+                        if (vm::is_nan(distance)) {
+                            return Model::Hit::NoHit;
+                        }
+                        return Model::Hit::hit(VertexHandleManager::HandleHitType, distance, vm::point_at_distance(pickRay, distance), position);
+                    }, pickResult);
+                    exhaustiveHits += pickResult.size();
+                }
+            }, "Pick 100k vertex handles " + std::to_string(pickRays.size()) + " times by testing every handle");
+
+            auto indexedHits = size_t(0);
+            timeLambda([&]() {
+                for (const auto& pickRay : pickRays) {
+                    Model::PickResult pickResult;
+                    manager.pick(pickRay, camera, pickResult);
+                    indexedHits += pickResult.size();
+                }
+            }, "Pick 100k vertex handles " + std::to_string(pickRays.size()) + " times using the spatial index");
+
+            CHECK(indexedHits == exhaustiveHits);
+
+            timeLambda([&]() {
+                for (const auto& pickRay : pickRays) {
+                    manager.select(vm::point_at_distance(pickRay, 512.0));
+                }
+            }, "Select " + std::to_string(pickRays.size()) + " handles by position among 100k handles");
+        }
+    }
+}
@@ -22,14 +22,23 @@
 
 #include "Exceptions.h"
 
+#include <kdl/parallel.h>
+
 #include <vecmath/scalar.h>
 #include <vecmath/bbox.h>
 #include <vecmath/bbox_io.h>
+#include <vecmath/plane.h>
 #include <vecmath/ray.h>
 #include <vecmath/intersection.h>
 
+#include <algorithm>
+#include <array>
 #include <cassert>
+#include <cstdint>
 #include <iosfwd>
+#include <iterator>
+#include <limits>
+#include <string>
 #include <unordered_map>
 #include <vector>
 
@@ -37,9 +46,12 @@ namespace TrenchBroom {
 /**
  * An axis aligned bounding box tree that allows for quick ray intersection queries.
  *
+ * The nodes of the tree are stored in a contiguous array and refer to each other by their indices. Nodes that are
+ * removed from the tree are recycled when new nodes are inserted.
+ *
  * @tparam T the floating point type
  * @tparam S the number of dimensions for vector types
- * @tparam U the node data to store in the leafs
+ * @tparam U the node data to store in the leafs, must be default constructible
  */
     template <typename T, size_t S, typename U>
     class AABBTree {
@@ -50,453 +62,408 @@ namespace TrenchBroom {
         using FloatType = T;
         static constexpr size_t Components = S;
     private:
-        class InnerNode;
-        class LeafNode;
+        using Index = std::uint32_t;
+        static constexpr Index InvalidIndex = std::numeric_limits<Index>::max();
 
-        class Visitor {
-        public:
-            virtual ~Visitor() = default;
+        /**
+         * A set of planes which still need to be tested when searching for the items in a convex volume.
+         */
+        using PlaneMask = std::uint32_t;
 
-            virtual bool visit(const InnerNode* innerNode) = 0;
-            virtual void visit(const LeafNode* leaf) = 0;
-        };
+        /**
+         * A node of the tree. An inner node does not carry data. It's only purpose is to structure the tree. Its bounds
+         * is the smallest bounding box that contains the bounds of its children, and its height is the maximum of the
+         * heights of its children plus one.
+         *
+         * A leaf node represents actual data, which is stored in m_data at the node's index. It does not have any
+         * children. Its bounds equals the bounds supplied when the node was inserted into the tree, and its height is
+         * always 1.
+         *
+         * For a tree of doubles in three dimensions, a node occupies 64 bytes, so visiting a node touches a single
+         * cache line in most cases.
+         */
+        struct Node {
+            Box bounds;
+            Index parent;
+            Index left;
+            Index right;
+            Index height;
 
-        template <typename I_V, typename L_V>
-        class LambdaVisitor : public Visitor {
-        private:
-            I_V m_innerNodeVisitor;
-            L_V m_leafNodeVisitor;
-        public:
-            LambdaVisitor(I_V innerNodeVisitor, L_V leafNodeVisitor) :
-                m_innerNodeVisitor(std::move(innerNodeVisitor)),
-                m_leafNodeVisitor(std::move(leafNodeVisitor)) {}
-
-            bool visit(const InnerNode* innerNode) override { return m_innerNodeVisitor(innerNode); }
-            void visit(const LeafNode* leafNode)   override { m_leafNodeVisitor(leafNode); }
+            bool isLeaf() const {
+                return left == InvalidIndex;
+            }
         };
 
-#if !defined __GNUC__ || defined __clang__
         /**
-         * Deduction guide.
-         *
-         * Note that as of GCC 9.2, there appears to be a bug in GCC that disallows deduction guides in non-namespace scope.
-         * Luckily, GCC does not need a guide to deduce the template parameters of LambdaVisitor, but clang does!
+         * An object to be inserted into the tree by a bulk build, along with its bounds and the center of its bounds.
          */
-        template <typename I_V, typename L_V>
-        LambdaVisitor(I_V innerNodeVisitor, L_V outerNodeVisitor) -> LambdaVisitor<I_V, L_V>;
-#endif
-
-        class Node {
-        public:
-            Box m_bounds;
-            InnerNode* m_parent;
-        protected:
-            explicit Node(const Box& bounds) :
-                m_bounds(bounds),
-                m_parent(nullptr) {}
-        public:
-            virtual ~Node() = default;
-
-            /**
-             * Return the bounds of this node.
-             *
-             * @return the bounds
-             */
-            const Box& bounds() const {
-                return m_bounds;
-            }
-
-            /**
-             * Return the height of this node. A leaf always has a height of 1, and an inner node has a height equal to the
-             * maximum of the heights of its children plus one.
-             *
-             * @return the height
-             */
-            virtual size_t height() const = 0;
-
-            /**
-             * Inserts a new node into the subtree rooted at `this`.
-             *
-             * @param bounds the bounds of the data to be inserted
-             * @param data the data to be inserted
-             * @return a pair containing the new subtree root (may be `this`, or a new node), and the newly inserted LeafNode
-             */
-            virtual std::pair<Node*, LeafNode*> insert(const Box& bounds, const U& data) = 0;
-
-            /**
-             * Accepts the given visitor.
-             *
-             * @param visitor the visitor to accept
-             */
-            virtual void accept(Visitor& visitor) const = 0;
-        public:
-            /**
-             * Appends a textual representation of this node to the given output stream.
-             *
-             * @param str the stream to append to
-             */
-            void appendTo(std::ostream& str) const {
-                appendTo(str, "  ", 0);
-            }
-
-            /**
-             * Appends a textual representation of this node to the given output stream using the given indent string and
-             * the given level of indentation.
-             *
-             * @param str the stream to append to
-             * @param indent the indent string
-             * @param level the level of indentation
-             */
-            virtual void appendTo(std::ostream& str, const std::string& indent, size_t level) const = 0;
-
-            virtual void checkParentPointers(const Node* expectedParent) const = 0;
-        protected:
-            /**
-             * Updates the bounds of this node.
-             *
-             * @param bounds the new bounds
-             */
-            void setBounds(const Box& bounds) {
-                m_bounds = bounds;
-            }
-
-            /**
-             * Appends a textual representation of this node's bounds to the given output stream.
-             *
-             * @param str the stream to append to
-             */
-            void appendBounds(std::ostream& str) const {
-                str << "[ ( " << m_bounds.min << " ) ( " << m_bounds.max  << " ) ]";
-            }
+        struct BuildItem {
+            Box bounds;
+            vm::vec<T,S> center;
+            U data;
+            Index leaf = InvalidIndex;
         };
 
         /**
-         * An inner node of an AABB tree does not carry data. It's only purpose is to structure the tree. Its bounds is
-         * the smallest bounding box that contains the bounds of its children.
-         */
-        class InnerNode : public Node {
-        private:
-            Node* m_left;
-            Node* m_right;
-            size_t m_height;
-        public:
-            InnerNode(Node* left, Node* right) :
-                Node(merge(left->bounds(), right->bounds())),
-                m_left(left),
-                m_right(right),
-                m_height(0) {
-                assert(m_left != nullptr);
-                assert(m_right != nullptr);
-
-                m_left->m_parent = this;
-                m_right->m_parent = this;
-
-                updateHeight();
-            }
-
-        private: // node removal private
-            /**
-             * Children (or grandchildren etc.) changed. Update the height and bounds.
-             * Recurses up the tree along the m_parent chain until it reaches the root.
-             *
-             * @return the new root of the tree
-             */
-            Node* updateAndReturnRoot() {
-                updateHeight();
-                updateBounds();
-
-                if (this->m_parent == nullptr) {
-                    return this;
-                }
+         * The number of bins that the objects are sorted into along each axis when searching for a split during a bulk
+         * build.
+         */
+        static constexpr size_t BuildBinCount = 16u;
 
-                return this->m_parent->updateAndReturnRoot();
-            }
+        /**
+         * The depth after which a bulk build switches from splitting using the surface area heuristic to splitting at
+         * the median. This bounds the height of the tree for pathological inputs.
+         */
+        static constexpr size_t MaxSurfaceAreaSplitDepth = 48u;
 
-            /**
-             * One of our direct children is being swapped for a new node.
-             *
-             * @return the new root of the tree
-             */
-            Node* replaceChild(Node* child, Node* replacement) {
-                replacement->m_parent = this;
+        /**
+         * The minimum number of objects in a subtree for a bulk build to build its two children concurrently.
+         */
+        static constexpr size_t MinParallelBuildCount = 2048u;
 
-                if (child == m_left) {
-                    m_left = replacement;
-                } else {
-                    assert(child == m_right);
-                    m_right = replacement;
-                }
+        /**
+         * An inverted box that serves as the neutral element when merging bounds during a bulk build.
+         */
+        static constexpr auto EmptyBuildBounds = Box(vm::vec<T,S>::fill(std::numeric_limits<T>::max()), vm::vec<T,S>::fill(std::numeric_limits<T>::lowest()));
+    private:
+        std::vector<Node> m_nodes;
+        std::vector<U> m_data;
+        std::vector<Index> m_freeNodes;
+        Index m_root;
+        std::unordered_map<U, Index> m_leafForData;
+    public:
+        AABBTree() : m_root(InvalidIndex) {}
 
-                return updateAndReturnRoot();
-            }
-        public: // Node removal public
-            /**
-             * One of our direct children is being deleted. `this` will turn into a LeafNode.
-             *
-             * @param child either m_left or m_right, which is being deleted
-             * @return the new root of the tree
-             */
-            Node* handleChildDeletion(LeafNode* child) {
-                Node* replacementForThis;
-                if (child == m_left) {
-                    replacementForThis = m_right;
-                } else {
-                    assert(child == m_right);
-                    replacementForThis = m_left;
-                }
+        /**
+         * Indicates whether a node with the given data exists in this tree.
+         *
+         * @param data the data to find
+         * @return true if a node with the given data exists and false otherwise
+         */
+        bool contains(const U& data) const {
+            auto it = m_leafForData.find(data);
+            return it != m_leafForData.end();
+        }
 
-                // Clear m_left/m_right so our destructor doesn't delete our children.
-                // The caller is going to delete one of them (`child`),
-                // and we will reuse the other one as the replacement for `this`.
-                m_left = nullptr;
-                m_right = nullptr;
-
-                // Special case when `this` is already the tree root
-                if (this->m_parent == nullptr) {
-                    Node* newTreeRoot = replacementForThis;
-                    newTreeRoot->m_parent = nullptr;
-                    delete this;
-                    return newTreeRoot;
-                }
+        /**
+         * Clears this tree and rebuilds it from the given objects.
+         *
+         * Rather than inserting the objects one by one, the tree is built top down in a single pass. At each level, the
+         * objects are split into two groups such that the sum of the surface areas of the groups' bounds, weighted by
+         * the number of objects in each group, is minimal. The resulting tree can be queried more efficiently than a
+         * tree built by repeated insertion. Large subtrees are built concurrently.
+         *
+         * The nodes are stored in depth first order, so that every inner node is immediately followed by its left
+         * child.
+         *
+         * @param objects the objects to insert, a list of DataType
+         * @param getBounds a function from DataType -> Box to compute the bounds of each object
+         *
+         * @throws NodeTreeException if the given objects contain duplicates, or if the bounds of any object contains NaN;
+         * the tree is empty in this case
+         */
+        template <typename DataList, typename GetBounds>
+        void clearAndBuild(const DataList& objects, GetBounds&& getBounds) {
+            clear();
 
-                Node* newTreeRoot = this->m_parent->replaceChild(this, replacementForThis);
-                delete this;
-                return newTreeRoot;
+            std::vector<BuildItem> items;
+            items.reserve(static_cast<size_t>(std::distance(std::begin(objects), std::end(objects))));
+            for (const U& object : objects) {
+                const auto bounds = getBounds(object);
+                check(bounds);
+                items.push_back(BuildItem{ bounds, bounds.center(), object });
             }
 
-        public: // Node overrides
-            ~InnerNode() override {
-                delete m_left;
-                delete m_right;
+            if (items.empty()) {
+                return;
             }
 
-            size_t height() const override {
-                return m_height;
+            if (items.size() > MaxNodeCount / 2u) {
+                throw NodeTreeException("Too many objects for AABB tree");
             }
 
-            std::pair<Node*, LeafNode*> insert(const Box& bounds, const U& data) override {
-                // Select the subtree which is increased the least by inserting a node with the given bounds.
-                // Then insert the node into that subtree and update our reference to it.
-                auto*& subtree = selectLeastIncreaser(m_left, m_right, bounds);
+            m_leafForData.reserve(items.size());
+            for (const auto& item : items) {
+                if (!m_leafForData.emplace(item.data, InvalidIndex).second) {
+                    m_leafForData.clear();
+                    throw NodeTreeException("Data already in tree");
+                }
+            }
 
-                Node* newSubtree;
-                LeafNode* insertedLeafNode;
-                std::tie(newSubtree, insertedLeafNode) = subtree->insert(bounds, data);
+            // fork until there is roughly one subtree per hardware thread
+            auto parallelDepth = size_t(0);
+            while ((size_t(1) << parallelDepth) < kdl::parallel_default_thread_count()) {
+                ++parallelDepth;
+            }
 
-                // Update the parent pointer
-                newSubtree->m_parent = this;
+            m_nodes.resize(2u * items.size() - 1u);
+            m_data.resize(m_nodes.size());
+            build(std::begin(items), std::end(items), 0u, parallelDepth, 0u, InvalidIndex);
+            m_root = 0u;
 
-                // Subtree is either a reference to m_left or m_right
-                if (subtree == m_left) {
-                    m_left = newSubtree;
-                } else {
-                    assert(subtree == m_right);
-                    m_right = newSubtree;
-                }
+            // the leafs are registered here because the map must not be modified concurrently
+            for (const auto& item : items) {
+                m_leafForData[item.data] = item.leaf;
+            }
+        }
+    private:
+        static constexpr size_t MaxNodeCount = static_cast<size_t>(InvalidIndex);
 
-                // Update our data.
-                updateBounds();
-                updateHeight();
-
-                return std::make_pair(this, insertedLeafNode);
-            }
-
-        private:
-            /**
-             * Selects one of the two given nodes such that it increases the given bounds the least.
-             *
-             * @tparam TT the type of the nodes
-             * @param node1 the first node to test
-             * @param node2 the second node to test
-             * @param bounds the bounds to test against
-             * @return node1 if it increases the given bounds volume by a smaller or equal amount than node2 would, and
-             *     node2 otherwise
-             */
-            template <typename TT>
-            static TT*& selectLeastIncreaser(TT*& node1, TT*& node2, const Box& bounds) {
-                const auto node1Contains = node1->bounds().contains(bounds);
-                const auto node2Contains = node2->bounds().contains(bounds);
-
-                if (node1Contains && !node2Contains) {
-                    return node1;
-                } else if (!node1Contains && node2Contains) {
-                    return node2;
-                } else if (!node1Contains && !node2Contains) {
-                    const auto new1 = vm::merge(node1->bounds(), bounds);
-                    const auto new2 = vm::merge(node2->bounds(), bounds);
-                    const auto vol1 = node1->bounds().volume();
-                    const auto vol2 = node2->bounds().volume();
-                    const auto diff1 = new1.volume() - vol1;
-                    const auto diff2 = new2.volume() - vol2;
-
-                    if (diff1 < diff2) {
-                        return node1;
-                    } else if (diff2 < diff1) {
-                        return node2;
-                    }
-                }
+        /**
+         * Builds a subtree containing the items in the given range, storing its root at the given index and its
+         * descendants at the following indices. A subtree with n items occupies 2n - 1 nodes. The children of subtrees
+         * above the given parallel depth are built concurrently if they are large enough. The index of the created
+         * leaf is stored in each item.
+         */
+        template <typename I>
+        void build(I first, I last, const size_t depth, const size_t parallelDepth, const Index index, const Index parent) {
+            assert(first != last);
 
-                static auto choice = 0u;
+            if (std::next(first) == last) {
+                m_nodes[index] = Node{ first->bounds, parent, InvalidIndex, InvalidIndex, 1u };
+                m_data[index] = first->data;
+                first->leaf = index;
+                return;
+            }
 
-                if (node1->height() < node2->height()) {
-                    return node1;
-                } else if (node2->height() < node1->height()) {
-                    return node2;
+            const auto mid = splitForBuild(first, last, depth);
+            const auto parallel = depth < parallelDepth && static_cast<size_t>(std::distance(first, last)) >= MinParallelBuildCount;
+
+            const auto left = static_cast<Index>(index + 1u);
+            const auto right = static_cast<Index>(index + 2u * static_cast<size_t>(std::distance(first, mid)));
+            kdl::parallel_for(2u, [&](const size_t i) {
+                if (i == 0u) {
+                    build(first, mid, depth + 1u, parallelDepth, left, index);
                 } else {
-                    if (choice++ % 2 == 0) {
-                        return node1;
-                    } else {
-                        return node2;
-                    }
+                    build(mid, last, depth + 1u, parallelDepth, right, index);
                 }
-            }
+            }, parallel ? 2u : 1u);
 
-            void updateBounds() {
-                this->setBounds(merge(m_left->bounds(), m_right->bounds()));
-            }
+            const auto& leftNode = m_nodes[left];
+            const auto& rightNode = m_nodes[right];
+            m_nodes[index] = Node{ vm::merge(leftNode.bounds, rightNode.bounds), parent, left, right, std::max(leftNode.height, rightNode.height) + 1u };
+        }
 
-            void updateHeight() {
-                m_height = std::max(m_left->height(), m_right->height()) + 1;
-                assert(m_height > 0);
+        /**
+         * Reorders the items in the given range such that the items in [first, mid) and [mid, last) form the subtrees
+         * of an inner node, and returns mid. Both subranges are guaranteed to be non-empty.
+         *
+         * The split position is found by sorting the item centers into bins along the axis on which the centers are
+         * spread out the most, and evaluating the surface area heuristic for every split between two adjacent bins. If
+         * no such split exists, because all centers coincide, or if the tree has become too deep, the items are split
+         * at the median instead.
+         */
+        template <typename I>
+        static I splitForBuild(I first, I last, const size_t depth) {
+            auto centerBounds = Box(first->center, first->center);
+            for (auto it = std::next(first); it != last; ++it) {
+                expand(centerBounds, it->center, it->center);
+            }
+            const auto centerSize = centerBounds.size();
+
+            auto axis = size_t(0);
+            for (size_t i = 1; i < S; ++i) {
+                if (centerSize[i] > centerSize[axis]) {
+                    axis = i;
+                }
             }
 
-            void accept(Visitor& visitor) const override {
-                if (visitor.visit(this)) {
-                    m_left->accept(visitor);
-                    m_right->accept(visitor);
+            const auto min = centerBounds.min[axis];
+            const auto size = centerSize[axis];
+            if (depth < MaxSurfaceAreaSplitDepth && size > static_cast<T>(0)) {
+                const auto scale = static_cast<T>(BuildBinCount) / size;
+                std::array<size_t, BuildBinCount> binCounts{};
+                std::array<Box, BuildBinCount> binBounds;
+                binBounds.fill(EmptyBuildBounds);
+                for (auto it = first; it != last; ++it) {
+                    const auto bin = buildBinIndex(it->center[axis], min, scale);
+                    expand(binBounds[bin], it->bounds.min, it->bounds.max);
+                    ++binCounts[bin];
                 }
-            }
-        public:
-            void appendTo(std::ostream& str, const std::string& indent, const size_t level) const override {
-                for (size_t i = 0; i < level; ++i)
-                    str << indent;
 
-                str << "O ";
-                this->appendBounds(str);
-                str << std::endl;
+                // rightCosts[i] is the cost of the items in the bins [i, BuildBinCount)
+                std::array<T, BuildBinCount> rightCosts{};
+                std::array<size_t, BuildBinCount> rightCounts{};
+                auto rightBounds = EmptyBuildBounds;
+                auto rightCount = size_t(0);
+                for (size_t i = BuildBinCount - 1u; i > 0u; --i) {
+                    expand(rightBounds, binBounds[i].min, binBounds[i].max);
+                    rightCount += binCounts[i];
+                    rightCosts[i] = rightCount == 0u ? static_cast<T>(0) : surfaceArea(rightBounds) * static_cast<T>(rightCount);
+                    rightCounts[i] = rightCount;
+                }
 
-                m_left->appendTo(str, indent, level + 1);
-                m_right->appendTo(str, indent, level + 1);
-            }
+                auto bestCost = std::numeric_limits<T>::max();
+                auto bestBin = BuildBinCount;
+                auto leftBounds = EmptyBuildBounds;
+                auto leftCount = size_t(0);
+                for (size_t i = 0u; i < BuildBinCount - 1u; ++i) {
+                    expand(leftBounds, binBounds[i].min, binBounds[i].max);
+                    leftCount += binCounts[i];
+
+                    if (leftCount > 0u && rightCounts[i + 1u] > 0u) {
+                        const auto cost = surfaceArea(leftBounds) * static_cast<T>(leftCount) + rightCosts[i + 1u];
+                        if (cost < bestCost) {
+                            bestCost = cost;
+                            bestBin = i;
+                        }
+                    }
+                }
 
-            void checkParentPointers([[maybe_unused]] const Node* expectedParent) const override {
-                assert(this->m_parent == expectedParent);
-                m_left->checkParentPointers(this);
-                m_left->checkParentPointers(this);
+                if (bestBin < BuildBinCount) {
+                    return std::partition(first, last, [&](const BuildItem& item) {
+                        return buildBinIndex(item.center[axis], min, scale) <= bestBin;
+                    });
+                }
             }
-        };
+
+            const auto mid = std::next(first, std::distance(first, last) / 2);
+            std::nth_element(first, mid, last, [&](const BuildItem& lhs, const BuildItem& rhs) {
+                return lhs.center[axis] < rhs.center[axis];
+            });
+            return mid;
+        }
 
         /**
-         * A leaf node represents actual data. It does not have any children. Its bounds equals the bounds supplied when
-         * the node was inserted into the tree. A leaf has a height of 1 and a balance of 0.
+         * Expands the given box in place so that it contains the box given by min and max. Merging into
+         * EmptyBuildBounds yields the given box.
          */
-        class LeafNode : public Node {
-        private:
-            U m_data;
-        public:
-            LeafNode(const Box& bounds, const U& data) : Node(bounds), m_data(data) {}
-
-            /**
-             * Deletes this. Returns the new root of the tree.
-             */
-            Node* deleteThis() {
-                Node* newRoot = (this->m_parent != nullptr)
-                                ? this->m_parent->handleChildDeletion(this)
-                                : nullptr;
-                delete this;
-                return newRoot;
-            }
-
-            /**
-             * Returns the data associated with this node.
-             *
-             * @return the data associated with this node
-             */
-            U& data() {
-                return m_data;
+        static void expand(Box& box, const vm::vec<T,S>& min, const vm::vec<T,S>& max) {
+            for (size_t i = 0; i < S; ++i) {
+                box.min[i] = std::min(box.min[i], min[i]);
+                box.max[i] = std::max(box.max[i], max[i]);
             }
+        }
 
-            /**
-             * Returns the data associated with this node.
-             *
-             * @return the data associated with this node
-             */
-            const U& data() const {
-                return m_data;
-            }
+        static size_t buildBinIndex(const T value, const T min, const T scale) {
+            const auto bin = static_cast<size_t>((value - min) * scale);
+            return std::min(bin, BuildBinCount - 1u);
+        }
 
-        public: // Node overrides
-            size_t height() const override {
-                return 1;
+        /**
+         * Returns a value that is proportional to the surface area of the given box.
+         */
+        static T surfaceArea(const Box& box) {
+            const auto size = box.size();
+            if constexpr (S == 1) {
+                return size[0];
+            } else {
+                auto result = static_cast<T>(0);
+                for (size_t i = 0; i < S; ++i) {
+                    for (size_t j = i + 1u; j < S; ++j) {
+                        result += size[i] * size[j];
+                    }
+                }
+                return result;
             }
+        }
 
-            /**
-             * Returns a new inner node that has this leaf as its left child and a new leaf representing the given bounds
-             * and data as its right child.
-             *
-             * @param bounds the bounds to insert
-             * @param data the data to insert
-             * @return a pair containing the new inner node that is the root of this subtree, and the newly inserted LeafNode
-             */
-            std::pair<Node*, LeafNode*> insert(const Box& bounds, const U& data) override {
-                auto* newLeaf = new LeafNode(bounds, data);
-                auto* newParent = new InnerNode(this, newLeaf);
-
-                return std::make_pair(newParent, newLeaf);
+        /**
+         * Returns the index of a node initialized with the given values, reusing a previously freed node if possible.
+         */
+        Index allocateNode(const Box& bounds, const Index parent, const Index left, const Index right, const Index height) {
+            if (!m_freeNodes.empty()) {
+                const auto index = m_freeNodes.back();
+                m_freeNodes.pop_back();
+                m_nodes[index] = Node{ bounds, parent, left, right, height };
+                return index;
             }
 
-            void accept(Visitor& visitor) const override {
-                visitor.visit(this);
+            if (m_nodes.size() >= MaxNodeCount) {
+                throw NodeTreeException("Too many objects for AABB tree");
             }
 
-            void appendTo(std::ostream& str, const std::string& indent, const size_t level) const override {
-                for (size_t i = 0; i < level; ++i)
-                    str << indent;
+            m_nodes.push_back(Node{ bounds, parent, left, right, height });
+            m_data.emplace_back();
+            return static_cast<Index>(m_nodes.size() - 1u);
+        }
 
-                str << "L ";
-                this->appendBounds(str);
-                str << ": " << m_data << std::endl;
-            }
+        void freeNode(const Index index) {
+            m_data[index] = U();
+            m_freeNodes.push_back(index);
+        }
 
-            virtual void checkParentPointers([[maybe_unused]] const Node* expectedParent) const override {
-                assert(this->m_parent == expectedParent);
+        /**
+         * Replaces the given child of the given parent node with the given replacement.
+         */
+        void replaceChild(const Index parent, const Index child, const Index replacement) {
+            auto& parentNode = m_nodes[parent];
+            if (parentNode.left == child) {
+                parentNode.left = replacement;
+            } else {
+                assert(parentNode.right == child);
+                parentNode.right = replacement;
             }
-        };
-    private:
-        Node* m_root;
-        std::unordered_map<U, LeafNode*> m_leafForData;
-    public:
-        AABBTree() : m_root(nullptr) {}
-
-        ~AABBTree() {
-            clear();
+            m_nodes[replacement].parent = parent;
         }
 
         /**
-         * Indicates whether a node with the given data exists in this tree.
-         *
-         * @param data the data to find
-         * @return true if a node with the given data exists and false otherwise
+         * Children (or grandchildren etc.) of the given node changed. Updates the height and bounds of the given node and
+         * of its ancestors.
          */
-        bool contains(const U& data) const {
-            auto it = m_leafForData.find(data);
-            return it != m_leafForData.end();
+        void updateAncestors(Index index) {
+            while (index != InvalidIndex) {
+                auto& node = m_nodes[index];
+                const auto& leftNode = m_nodes[node.left];
+                const auto& rightNode = m_nodes[node.right];
+
+                node.height = std::max(leftNode.height, rightNode.height) + 1u;
+                node.bounds = vm::merge(leftNode.bounds, rightNode.bounds);
+                index = node.parent;
+            }
         }
 
         /**
-         * Clears this tree and rebuilds it by inserting given objects.
+         * Selects one of the two given nodes such that it increases the given bounds the least.
          *
-         * @param objects the objects to insert, a list of DataType
-         * @param getBounds a function from DataType -> Box to compute the bounds of each object
+         * @param node1 the index of the first node to test
+         * @param node2 the index of the second node to test
+         * @param bounds the bounds to test against
+         * @return node1 if it increases the given bounds volume by a smaller or equal amount than node2 would, and
+         *     node2 otherwise
          */
-        template <typename DataList, typename GetBounds>
-        void clearAndBuild(const DataList& objects, GetBounds&& getBounds) {
-            clear();
-            for (const U& object : objects) {
-                insert(getBounds(object), object);
+        Index selectLeastIncreaser(const Index node1, const Index node2, const Box& bounds) const {
+            const auto& bounds1 = m_nodes[node1].bounds;
+            const auto& bounds2 = m_nodes[node2].bounds;
+            const auto node1Contains = bounds1.contains(bounds);
+            const auto node2Contains = bounds2.contains(bounds);
+
+            if (node1Contains && !node2Contains) {
+                return node1;
+            } else if (!node1Contains && node2Contains) {
+                return node2;
+            } else if (!node1Contains && !node2Contains) {
+                const auto new1 = vm::merge(bounds1, bounds);
+                const auto new2 = vm::merge(bounds2, bounds);
+                const auto vol1 = bounds1.volume();
+                const auto vol2 = bounds2.volume();
+                const auto diff1 = new1.volume() - vol1;
+                const auto diff2 = new2.volume() - vol2;
+
+                if (diff1 < diff2) {
+                    return node1;
+                } else if (diff2 < diff1) {
+                    return node2;
+                }
             }
-        }
 
+            static auto choice = 0u;
+
+            const auto height1 = m_nodes[node1].height;
+            const auto height2 = m_nodes[node2].height;
+            if (height1 < height2) {
+                return node1;
+            } else if (height2 < height1) {
+                return node2;
+            } else {
+                if (choice++ % 2 == 0) {
+                    return node1;
+                } else {
+                    return node2;
+                }
+            }
+        }
+    public:
         /**
          * Insert a node with the given bounds and data into this tree.
          *
@@ -513,16 +480,34 @@ namespace TrenchBroom {
                 throw NodeTreeException("Data already in tree");
             }
 
-            if (empty()) {
-                auto* insertedLeafNode = new LeafNode(bounds, data);
+            const auto leaf = allocateNode(bounds, InvalidIndex, InvalidIndex, InvalidIndex, 1u);
+            m_data[leaf] = data;
+            m_leafForData[data] = leaf;
 
-                m_root = insertedLeafNode;
-                m_leafForData[data] = insertedLeafNode;
-            } else {
-                LeafNode* insertedLeafNode;
-                std::tie(m_root, insertedLeafNode) = m_root->insert(bounds, data);
+            if (m_root == InvalidIndex) {
+                m_root = leaf;
+                return;
+            }
 
-                m_leafForData[data] = insertedLeafNode;
+            // Descend into the subtree which is increased the least by inserting a node with the given bounds until we
+            // reach a leaf. The new leaf and the leaf we found become the children of a new inner node.
+            auto sibling = m_root;
+            while (!m_nodes[sibling].isLeaf()) {
+                const auto& node = m_nodes[sibling];
+                sibling = selectLeastIncreaser(node.left, node.right, bounds);
+            }
+
+            const auto parent = m_nodes[sibling].parent;
+            const auto newParentBounds = vm::merge(m_nodes[sibling].bounds, bounds);
+            const auto newParent = allocateNode(newParentBounds, parent, sibling, leaf, 2u);
+            m_nodes[sibling].parent = newParent;
+            m_nodes[leaf].parent = newParent;
+
+            if (parent == InvalidIndex) {
+                m_root = newParent;
+            } else {
+                replaceChild(parent, sibling, newParent);
+                updateAncestors(parent);
             }
         }
 
@@ -538,12 +523,32 @@ namespace TrenchBroom {
                 return false;
             }
 
-            LeafNode* leaf = it->second;
-            assert(leaf->data() == data);
+            const auto leaf = it->second;
+            assert(m_data[leaf] == data);
             m_leafForData.erase(it);
 
-            m_root = leaf->deleteThis();
+            const auto parent = m_nodes[leaf].parent;
+            if (parent == InvalidIndex) {
+                // the tree is now empty
+                clear();
+                return true;
+            }
+
+            // The parent is replaced by the sibling of the removed leaf.
+            const auto& parentNode = m_nodes[parent];
+            const auto sibling = parentNode.left == leaf ? parentNode.right : parentNode.left;
+            const auto grandParent = parentNode.parent;
+
+            if (grandParent == InvalidIndex) {
+                m_root = sibling;
+                m_nodes[sibling].parent = InvalidIndex;
+            } else {
+                replaceChild(grandParent, parent, sibling);
+                updateAncestors(grandParent);
+            }
 
+            freeNode(leaf);
+            freeNode(parent);
             return true;
         }
 
@@ -574,10 +579,11 @@ namespace TrenchBroom {
          * Clears this node tree.
          */
         void clear() {
-            if (!empty()) {
-                delete m_root;
-                m_root = nullptr;
-            }
+            m_nodes.clear();
+            m_data.clear();
+            m_freeNodes.clear();
+            m_root = InvalidIndex;
+            m_leafForData.clear();
         }
 
         /**
@@ -586,7 +592,7 @@ namespace TrenchBroom {
          * @return true if this tree is empty and false otherwise
          */
         bool empty() const {
-            return m_root == nullptr;
+            return m_root == InvalidIndex;
         }
 
         /**
@@ -601,7 +607,7 @@ namespace TrenchBroom {
             if (empty()) {
                 return EmptyBox;
             } else {
-                return m_root->bounds();
+                return m_nodes[m_root].bounds;
             }
         }
 
@@ -611,7 +617,7 @@ namespace TrenchBroom {
          * @return the height of this tree
          */
         size_t height() const {
-            return empty() ? 0 : m_root->height();
+            return empty() ? 0 : static_cast<size_t>(m_nodes[m_root].height);
         }
 
         /**
@@ -637,22 +643,43 @@ namespace TrenchBroom {
         template <typename O>
         void findIntersectors(const vm::ray<T,S>& ray, O out) const {
             if (!empty()) {
-                LambdaVisitor visitor(
-                    [&](const InnerNode* innerNode) {
-                        return innerNode->bounds().contains(ray.origin) || !vm::is_nan(
-                            vm::intersect_ray_bbox(ray, innerNode->bounds()));
+                visit(m_root,
+                    [&](const Node& innerNode) {
+                        return intersects(ray, innerNode.bounds);
                     },
-                    [&](const LeafNode* leaf) {
-                        if (leaf->bounds().contains(ray.origin) || !vm::is_nan(vm::intersect_ray_bbox(ray, leaf->bounds()))) {
-                            out = leaf->data();
+                    [&](const Node& leaf, const U& data) {
+                        if (intersects(ray, leaf.bounds)) {
+                            out = data;
                             ++out;
                         }
                     }
                 );
-                m_root->accept(visitor);
             }
         }
 
+        /**
+         * Returns the number of nodes that are visited when searching for the intersectors of the given ray. Averaged
+         * over many rays, this is a measure of the quality of this tree.
+         *
+         * @param ray the ray to test
+         * @return the number of visited inner nodes and leafs
+         */
+        size_t countIntersectorVisits(const vm::ray<T,S>& ray) const {
+            size_t result = 0u;
+            if (!empty()) {
+                visit(m_root,
+                    [&](const Node& innerNode) {
+                        ++result;
+                        return intersects(ray, innerNode.bounds);
+                    },
+                    [&](const Node&, const U&) {
+                        ++result;
+                    }
+                );
+            }
+            return result;
+        }
+
         /**
          * Finds every data item in this tree whose bounding box contains the given point and returns a list of those items.
          *
@@ -676,18 +703,93 @@ namespace TrenchBroom {
         template <typename O>
         void findContainers(const vm::vec<T,S>& point, O out) const {
             if (!empty()) {
-                LambdaVisitor visitor(
-                    [&](const InnerNode* innerNode) {
-                        return innerNode->bounds().contains(point);
+                visit(m_root,
+                    [&](const Node& innerNode) {
+                        return innerNode.bounds.contains(point);
                     },
-                    [&](const LeafNode* leaf) {
-                        if (leaf->bounds().contains(point)) {
-                            out = leaf->data();
+                    [&](const Node& leaf, const U& data) {
+                        if (leaf.bounds.contains(point)) {
+                            out = data;
                             ++out;
                         }
                     }
                 );
-                m_root->accept(visitor);
+            }
+        }
+
+        /**
+         * Finds every data item in this tree whose bounding box intersects with the given box and returns a list of
+         * those items.
+         *
+         * @param box the box to test
+         * @return a list containing all found data items
+         */
+        List findIntersectors(const Box& box) const {
+            List result;
+            findIntersectors(box, std::back_inserter(result));
+            return result;
+        }
+
+        /**
+         * Finds every data item in this tree whose bounding box intersects with the given box and appends it to the
+         * given output iterator. Boxes that only touch the given box count as intersecting.
+         *
+         * @tparam O the output iterator type
+         * @param box the box to test
+         * @param out the output iterator to append to
+         */
+        template <typename O>
+        void findIntersectors(const Box& box, O out) const {
+            if (!empty()) {
+                visit(m_root,
+                    [&](const Node& innerNode) {
+                        return innerNode.bounds.intersects(box);
+                    },
+                    [&](const Node& leaf, const U& data) {
+                        if (leaf.bounds.intersects(box)) {
+                            out = data;
+                            ++out;
+                        }
+                    }
+                );
+            }
+        }
+
+        /**
+         * Finds every data item in this tree whose bounding box intersects with the convex volume bounded by the given
+         * planes and returns a list of those items.
+         *
+         * @param planes the planes bounding the volume, their normals must point out of the volume
+         * @return a list containing all found data items
+         */
+        List findIntersectors(const std::vector<vm::plane<T,S>>& planes) const {
+            List result;
+            findIntersectors(planes, std::back_inserter(result));
+            return result;
+        }
+
+        /**
+         * Finds every data item in this tree whose bounding box intersects with the convex volume bounded by the given
+         * planes and appends it to the given output iterator. The normals of the planes must point out of the volume, as
+         * is the case for the frustum planes of a camera.
+         *
+         * A bounding box is only rejected if it is completely in front of one of the planes, so some items whose bounding
+         * boxes are near the corners of the volume may be found even though they are outside of it. Once a node is found
+         * to be completely behind a plane, its descendants are not tested against that plane again, and the items of a
+         * subtree that is completely inside of the volume are appended without any further tests.
+         *
+         * @tparam O the output iterator type
+         * @param planes the planes bounding the volume, at most 32
+         * @param out the output iterator to append to
+         */
+        template <typename O>
+        void findIntersectors(const std::vector<vm::plane<T,S>>& planes, O out) const {
+            assert(planes.size() <= static_cast<size_t>(std::numeric_limits<PlaneMask>::digits));
+            if (!empty()) {
+                const auto mask = planes.size() == static_cast<size_t>(std::numeric_limits<PlaneMask>::digits)
+                    ? ~PlaneMask(0)
+                    : (PlaneMask(1) << planes.size()) - 1u;
+                findIntersectors(m_root, planes, mask, out);
             }
         }
 
@@ -698,9 +800,118 @@ namespace TrenchBroom {
          */
         void print(std::ostream& str) const {
             if (!empty()) {
-                m_root->appendTo(str);
+                appendTo(str, m_root, "  ", 0);
             }
         }
+    private:
+        static bool intersects(const vm::ray<T,S>& ray, const Box& bounds) {
+            return bounds.contains(ray.origin) || !vm::is_nan(vm::intersect_ray_bbox(ray, bounds));
+        }
+
+        /**
+         * Tests the bounds of the given node against the planes whose bits are set in the given mask and appends the data
+         * items of the subtree rooted at that node which may intersect with the volume bounded by the planes.
+         */
+        template <typename O>
+        void findIntersectors(const Index index, const std::vector<vm::plane<T,S>>& planes, PlaneMask mask, O& out) const {
+            const auto& node = m_nodes[index];
+            for (size_t i = 0; i < planes.size(); ++i) {
+                const auto bit = PlaneMask(1) << i;
+                if ((mask & bit) != 0u) {
+                    const auto& plane = planes[i];
+
+                    // find the corners of the bounds which are closest to and farthest from the plane
+                    auto nearest = node.bounds.max;
+                    auto farthest = node.bounds.min;
+                    for (size_t j = 0; j < S; ++j) {
+                        if (plane.normal[j] >= static_cast<T>(0)) {
+                            nearest[j] = node.bounds.min[j];
+                            farthest[j] = node.bounds.max[j];
+                        }
+                    }
+
+                    if (plane.point_distance(nearest) > static_cast<T>(0)) {
+                        // completely in front of the plane
+                        return;
+                    } else if (plane.point_distance(farthest) <= static_cast<T>(0)) {
+                        // completely behind the plane, so no descendant needs to be tested against it
+                        mask &= ~bit;
+                    }
+                }
+            }
+
+            if (node.isLeaf()) {
+                out = m_data[index];
+                ++out;
+            } else if (mask == 0u) {
+                visit(index,
+                    [](const Node&) {
+                        return true;
+                    },
+                    [&](const Node&, const U& data) {
+                        out = data;
+                        ++out;
+                    }
+                );
+            } else {
+                findIntersectors(node.left, planes, mask, out);
+                findIntersectors(node.right, planes, mask, out);
+            }
+        }
+
+        /**
+         * Visits the subtree rooted at the given node. The given inner node visitor is called for every inner node and
+         * determines whether the children of that node are visited. The given leaf visitor is called for every leaf along
+         * with the leaf's data.
+         */
+        template <typename I_V, typename L_V>
+        void visit(const Index index, const I_V& innerNodeVisitor, const L_V& leafVisitor) const {
+            const auto& node = m_nodes[index];
+            if (node.isLeaf()) {
+                leafVisitor(node, m_data[index]);
+            } else if (innerNodeVisitor(node)) {
+                visit(node.left, innerNodeVisitor, leafVisitor);
+                visit(node.right, innerNodeVisitor, leafVisitor);
+            }
+        }
+
+        /**
+         * Appends a textual representation of the subtree rooted at the given node to the given output stream using the
+         * given indent string and the given level of indentation.
+         *
+         * @param str the stream to append to
+         * @param index the index of the subtree root
+         * @param indent the indent string
+         * @param level the level of indentation
+         */
+        void appendTo(std::ostream& str, const Index index, const std::string& indent, const size_t level) const {
+            for (size_t i = 0; i < level; ++i)
+                str << indent;
+
+            const auto& node = m_nodes[index];
+            if (node.isLeaf()) {
+                str << "L ";
+                appendBounds(str, node.bounds);
+                str << ": " << m_data[index] << std::endl;
+            } else {
+                str << "O ";
+                appendBounds(str, node.bounds);
+                str << std::endl;
+
+                appendTo(str, node.left, indent, level + 1);
+                appendTo(str, node.right, indent, level + 1);
+            }
+        }
+
+        /**
+         * Appends a textual representation of the given bounds to the given output stream.
+         *
+         * @param str the stream to append to
+         * @param bounds the bounds to append
+         */
+        static void appendBounds(std::ostream& str, const Box& bounds) {
+            str << "[ ( " << bounds.min << " ) ( " << bounds.max  << " ) ]";
+        }
     };
 }
 
@@ -20,182 +20,261 @@
 #ifndef TrenchBroom_Allocator_h
 #define TrenchBroom_Allocator_h
 
+#include <algorithm>
 #include <cassert>
-#include <stack>
-#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
 
 // Undefine this to prevent false positives when looking for memory leaks.
 #define TB_ENABLE_ALLOCATOR 1
 
 namespace TrenchBroom {
-    template <class T, size_t PoolSize = 64, size_t BlocksPerChunk = 256>
+    /**
+     * Provides class specific operator new and delete for classes whose instances are created and destroyed in large
+     * numbers, such as the vertices, edges, half edges and faces of polyhedra.
+     *
+     * Memory is obtained in chunks that are aligned to their size and hold as many blocks as fit, each of which holds
+     * one instance. Every chunk keeps a list of its free blocks, and a chunk whose blocks are all free is returned to
+     * the system.
+     *
+     * Every thread has a cache of free blocks, so allocation and deallocation usually take constant time and need no
+     * locking. A thread whose cache is empty takes all free blocks of one chunk, or of a new chunk if no chunk has free
+     * blocks. A thread whose cache holds more than two chunks' worth of blocks returns one chunk's worth to the chunks
+     * they belong to. An instance may be deleted on a different thread than the one that created it, in which case its
+     * block is added to the cache of the deleting thread. When a thread exits, all blocks in its cache are returned.
+     *
+     * @tparam T the type of the instances to allocate
+     * @tparam ChunkSize the size of a chunk in bytes, must be a power of two
+     */
+    template <class T, size_t ChunkSize = 16384>
     class Allocator {
     private:
-        class Chunk {
-        private:
-            unsigned char m_blocks[BlocksPerChunk * sizeof(T)];
-            unsigned char m_firstFreeBlock;
-            unsigned char m_numFreeBlocks;
-        public:
-            Chunk() :
-                m_firstFreeBlock(0),
-                m_numFreeBlocks(BlocksPerChunk - 1) {
-                for (size_t i = 0; i < BlocksPerChunk - 1; i++)
-                    m_blocks[i * sizeof(T)] = static_cast<unsigned char>(i + 1);
-            }
+        struct FreeBlock {
+            FreeBlock* next;
+        };
 
-            bool contains(const T* t) const {
-                const unsigned char* block = reinterpret_cast<const unsigned char*>(t);
-                if (block < m_blocks)
-                    return false;
-                size_t offset = static_cast<size_t>(block - m_blocks);
-                return offset < (BlocksPerChunk - 1) * sizeof(T);
-            }
+        static constexpr size_t blockAlignment() {
+            return std::max(alignof(T), alignof(FreeBlock));
+        }
 
-            T* allocate() {
-                if (m_numFreeBlocks == 0)
-                    return nullptr;
+        static constexpr size_t blockSize() {
+            constexpr auto size = std::max(sizeof(T), sizeof(FreeBlock));
+            return (size + blockAlignment() - 1u) / blockAlignment() * blockAlignment();
+        }
 
-                unsigned char* block = m_blocks + m_firstFreeBlock * sizeof(T);
-                m_firstFreeBlock = *block;
-                m_numFreeBlocks--;
-                return reinterpret_cast<T*>(block);
-            }
+        /**
+         * The header at the start of a chunk. Chunks that have free blocks are kept in a doubly linked list.
+         */
+        struct Chunk {
+            FreeBlock* freeList;
+            size_t freeCount;
+            Chunk* previous;
+            Chunk* next;
+        };
 
-            void deallocate(T* t) {
-                assert(m_numFreeBlocks < BlocksPerChunk - 1);
-                assert(contains(t));
+        static constexpr size_t blocksOffset() {
+            return (sizeof(Chunk) + blockAlignment() - 1u) / blockAlignment() * blockAlignment();
+        }
 
-                unsigned char* block = reinterpret_cast<unsigned char*>(t);
-                assert(block >= m_blocks);
-                size_t offset = static_cast<size_t>(block - m_blocks);
-                assert(offset % sizeof(T) == 0);
+        static constexpr size_t blocksPerChunk() {
+            return (ChunkSize - blocksOffset()) / blockSize();
+        }
 
-                size_t index = offset / sizeof(T);
-                assert(index < BlocksPerChunk);
+        static_assert((ChunkSize & (ChunkSize - 1u)) == 0u, "chunk size must be a power of two");
 
-                *block = m_firstFreeBlock;
-                m_firstFreeBlock = static_cast<unsigned char>(index);
-                m_numFreeBlocks++;
-            }
+        /**
+         * The chunks shared by all threads.
+         */
+        struct Chunks {
+            std::mutex mutex;
+            Chunk* firstWithFreeBlocks = nullptr;
+            size_t count = 0u;
+        };
 
-            bool empty() const {
-                return m_numFreeBlocks == BlocksPerChunk - 1;
-            }
+        static Chunks& chunks() {
+            static Chunks c;
+            return c;
+        }
 
-            bool full() const {
-                return m_numFreeBlocks == 0;
-            }
+        /**
+         * The free blocks available to a thread. This is trivially destructible, so that it remains usable while the
+         * thread's other thread local objects are being destroyed.
+         */
+        struct ThreadCache {
+            FreeBlock* freeList;
+            size_t freeCount;
+            bool registered;
         };
 
-        using ChunkList = std::vector<Chunk*>;
-        using Pool = std::stack<T*>;
+        /**
+         * Returns the blocks in the cache of a thread to their chunks when the thread exits.
+         */
+        class ThreadCacheFlusher {
+        public:
+            void touch() {}
 
-        static Pool& pool() {
-            static Pool p;
-            return p;
-        }
+            ~ThreadCacheFlusher() {
+                auto& cache = threadCacheStorage();
+                returnBlocks(cache, cache.freeCount);
+            }
+        };
 
-        static ChunkList& fullChunks() {
-            static ChunkList chunks;
-            return chunks;
+        static ThreadCache& threadCacheStorage() {
+            thread_local ThreadCache cache = { nullptr, 0u, false };
+            return cache;
         }
 
-        static ChunkList& mixedChunks() {
-            static ChunkList chunks;
-            return chunks;
+        static ThreadCache& threadCache() {
+            auto& cache = threadCacheStorage();
+            if (!cache.registered) {
+                // constructs the flusher on first use so that it is destroyed when the thread exits
+                thread_local ThreadCacheFlusher flusher;
+                flusher.touch();
+                cache.registered = true;
+            }
+            return cache;
         }
 
-        static ChunkList emptyChunks() {
-            static ChunkList chunks;
-            return chunks;
+        static Chunk* chunkOf(const FreeBlock* block) {
+            return reinterpret_cast<Chunk*>(reinterpret_cast<std::uintptr_t>(block) & ~std::uintptr_t(ChunkSize - 1u));
         }
-    public:
-#ifdef TB_ENABLE_ALLOCATOR
-        void* operator new([[maybe_unused]] size_t size) {
-            assert(size == sizeof(T));
 
-            if (!pool().empty()) {
-                T* t = pool().top();
-                pool().pop();
-                return t;
+        static void link(Chunks& c, Chunk* chunk) {
+            chunk->previous = nullptr;
+            chunk->next = c.firstWithFreeBlocks;
+            if (chunk->next != nullptr) {
+                chunk->next->previous = chunk;
             }
+            c.firstWithFreeBlocks = chunk;
+        }
 
-            Chunk* chunk = nullptr;
-            if (mixedChunks().empty()) {
-                if (!emptyChunks().empty()) {
-                    chunk = emptyChunks().back();
-                    emptyChunks().pop_back();
-                } else {
-                    chunk = new Chunk();
-                }
+        static void unlink(Chunks& c, Chunk* chunk) {
+            if (chunk->previous != nullptr) {
+                chunk->previous->next = chunk->next;
             } else {
-                chunk = mixedChunks().back();
-                mixedChunks().pop_back();
+                c.firstWithFreeBlocks = chunk->next;
+            }
+            if (chunk->next != nullptr) {
+                chunk->next->previous = chunk->previous;
+            }
+        }
+
+        static Chunk* createChunk() {
+            static_assert(blocksPerChunk() >= 16u, "chunk size is too small");
+
+            auto* memory = static_cast<unsigned char*>(::operator new(ChunkSize, std::align_val_t(ChunkSize)));
+            auto* chunk = new (memory) Chunk{ nullptr, 0u, nullptr, nullptr };
+            for (size_t i = 0u; i < blocksPerChunk(); ++i) {
+                auto* block = reinterpret_cast<FreeBlock*>(memory + blocksOffset() + (blocksPerChunk() - i - 1u) * blockSize());
+                block->next = chunk->freeList;
+                chunk->freeList = block;
             }
+            chunk->freeCount = blocksPerChunk();
+            return chunk;
+        }
+
+        static void destroyChunk(Chunk* chunk) {
+            chunk->~Chunk();
+            ::operator delete(static_cast<void*>(chunk), std::align_val_t(ChunkSize));
+        }
+
+        /**
+         * Moves all free blocks of a chunk into the given cache, creating a new chunk if no chunk has free blocks.
+         */
+        static void takeBlocks(ThreadCache& cache) {
+            assert(cache.freeList == nullptr);
 
-            assert(!chunk->full());
-            T* block = chunk->allocate();
+            auto& c = chunks();
+            std::lock_guard<std::mutex> lock(c.mutex);
 
-            if (chunk->full()) {
-                fullChunks().push_back(chunk);
+            auto* chunk = c.firstWithFreeBlocks;
+            if (chunk != nullptr) {
+                unlink(c, chunk);
             } else {
-                mixedChunks().push_back(chunk);
+                chunk = createChunk();
+                ++c.count;
             }
-            return block;
+
+            cache.freeList = chunk->freeList;
+            cache.freeCount = chunk->freeCount;
+            chunk->freeList = nullptr;
+            chunk->freeCount = 0u;
         }
 
-        void operator delete(void* block) {
-            T* t = reinterpret_cast<T*>(block);
+        /**
+         * Returns the given number of blocks from the given cache to their chunks, and returns chunks whose blocks are
+         * all free to the system.
+         */
+        static void returnBlocks(ThreadCache& cache, const size_t count) {
+            assert(count <= cache.freeCount);
 
-            if (PoolSize > 0 && pool().size() < PoolSize) {
-                pool().push(t);
-                return;
-            }
+            auto& c = chunks();
+            std::lock_guard<std::mutex> lock(c.mutex);
 
-            typename ChunkList::reverse_iterator fullIt, fullEnd, mixedIt, mixedEnd;
-            fullIt = fullChunks().rbegin();
-            fullEnd = fullChunks().rend();
-            mixedIt = mixedChunks().rbegin();
-            mixedEnd = mixedChunks().rend();
-
-            Chunk* chunk = nullptr;
-            while (fullIt < fullEnd || mixedIt < mixedEnd) {
-                if (fullIt < fullEnd) {
-                    Chunk* fullChunk = *fullIt;
-                    if (fullChunk->contains(t)) {
-                        chunk = fullChunk;
-                        break;
-                    }
-                    ++fullIt;
+            for (size_t i = 0u; i < count; ++i) {
+                auto* block = cache.freeList;
+                cache.freeList = block->next;
+                --cache.freeCount;
+
+                auto* chunk = chunkOf(block);
+                block->next = chunk->freeList;
+                chunk->freeList = block;
+
+                if (++chunk->freeCount == 1u) {
+                    link(c, chunk);
                 }
-                if (mixedIt < mixedEnd) {
-                    Chunk* mixedChunk = *mixedIt;
-                    if (mixedChunk->contains(t)) {
-                        chunk = mixedChunk;
-                        break;
-                    }
-                    ++mixedIt;
+                if (chunk->freeCount == blocksPerChunk()) {
+                    unlink(c, chunk);
+                    destroyChunk(chunk);
+                    --c.count;
                 }
             }
+        }
 
-            assert(chunk != nullptr);
-
-            if (chunk->full()) {
-                fullChunks().erase((fullIt + 1).base());
-                mixedChunks().push_back(chunk);
+        static void* allocate() {
+            auto& cache = threadCache();
+            if (cache.freeList == nullptr) {
+                takeBlocks(cache);
             }
 
-            chunk->deallocate(t);
+            auto* block = cache.freeList;
+            cache.freeList = block->next;
+            --cache.freeCount;
+            return block;
+        }
+
+        static void deallocate(void* block) {
+            auto& cache = threadCache();
+            auto* freeBlock = static_cast<FreeBlock*>(block);
+            freeBlock->next = cache.freeList;
+            cache.freeList = freeBlock;
+            ++cache.freeCount;
 
-            if (chunk->empty()) {
-                mixedChunks().erase((mixedIt + 1).base());
-                if (emptyChunks().size() < 2)
-                    emptyChunks().push_back(chunk);
-                else
-                    delete chunk;
+            if (cache.freeCount > 2u * blocksPerChunk()) {
+                returnBlocks(cache, blocksPerChunk());
             }
         }
+    public:
+        /**
+         * Returns the number of chunks that are currently allocated. Only exposed for testing.
+         */
+        static size_t chunkCount() {
+            auto& c = chunks();
+            std::lock_guard<std::mutex> lock(c.mutex);
+            return c.count;
+        }
+
+#ifdef TB_ENABLE_ALLOCATOR
+        void* operator new([[maybe_unused]] size_t size) {
+            assert(size == sizeof(T));
+            return allocate();
+        }
+
+        void operator delete(void* block) {
+            deallocate(block);
+        }
 #endif
     };
 }
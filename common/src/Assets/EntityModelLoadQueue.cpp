@@ -0,0 +1,174 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "EntityModelLoadQueue.h"
+
+#include "Exceptions.h"
+#include "Assets/EntityModel.h"
+#include "IO/EntityModelLoader.h"
+
+#include <algorithm>
+#include <exception>
+#include <utility>
+
+#include <QString>
+
+namespace TrenchBroom {
+    namespace Assets {
+        namespace {
+            /**
+             * Collects the messages logged while loading a model on a worker thread.
+             */
+            class CollectingLogger : public Logger {
+            private:
+                std::vector<EntityModelLoadQueue::LogMessage>& m_messages;
+            public:
+                explicit CollectingLogger(std::vector<EntityModelLoadQueue::LogMessage>& messages) :
+                m_messages(messages) {}
+            private:
+                void doLog(const LogLevel level, const std::string& message) override {
+                    m_messages.push_back({ level, message });
+                }
+
+                void doLog(const LogLevel level, const QString& message) override {
+                    m_messages.push_back({ level, message.toStdString() });
+                }
+            };
+        }
+
+        EntityModelLoadQueue::EntityModelLoadQueue(const IO::EntityModelLoader& loader, const size_t threadCount) :
+        m_loader(loader),
+        m_stopping(false) {
+            const auto actualThreadCount = std::max(threadCount, size_t(1));
+            for (size_t i = 0; i < actualThreadCount; ++i) {
+                m_workers.emplace_back([this]() { work(); });
+            }
+        }
+
+        EntityModelLoadQueue::~EntityModelLoadQueue() {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_stopping = true;
+                m_requests.clear();
+            }
+            m_requestAvailable.notify_all();
+
+            for (auto& worker : m_workers) {
+                worker.join();
+            }
+        }
+
+        void EntityModelLoadQueue::enqueue(const IO::Path& path, const size_t frameIndex) {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (isPending(path)) {
+                    return;
+                }
+                m_requests.push_back({ path, frameIndex });
+            }
+            m_requestAvailable.notify_one();
+        }
+
+        bool EntityModelLoadQueue::pending(const IO::Path& path) const {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return isPending(path);
+        }
+
+        bool EntityModelLoadQueue::busy() const {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return !m_requests.empty() || !m_loadingPaths.empty() || !m_results.empty();
+        }
+
+        std::vector<EntityModelLoadQueue::Result> EntityModelLoadQueue::takeResults() {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto results = std::vector<Result>();
+            std::swap(results, m_results);
+            return results;
+        }
+
+        void EntityModelLoadQueue::waitUntilIdle() {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_requestFinished.wait(lock, [&]() { return m_requests.empty() && m_loadingPaths.empty(); });
+        }
+
+        /**
+         * A model is pending if it is waiting to be loaded, being loaded, or if its result has not been taken yet.
+         * Must be called with the mutex held.
+         */
+        bool EntityModelLoadQueue::isPending(const IO::Path& path) const {
+            return std::any_of(std::begin(m_requests), std::end(m_requests), [&](const auto& request) { return request.path == path; })
+                || std::find(std::begin(m_loadingPaths), std::end(m_loadingPaths), path) != std::end(m_loadingPaths)
+                || std::any_of(std::begin(m_results), std::end(m_results), [&](const auto& result) { return result.path == path; });
+        }
+
+        void EntityModelLoadQueue::work() {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            while (true) {
+                m_requestAvailable.wait(lock, [&]() { return m_stopping || !m_requests.empty(); });
+                if (m_stopping) {
+                    return;
+                }
+
+                const auto request = m_requests.front();
+                m_requests.pop_front();
+                m_loadingPaths.push_back(request.path);
+
+                lock.unlock();
+                auto result = load(request);
+                lock.lock();
+
+                m_loadingPaths.erase(std::find(std::begin(m_loadingPaths), std::end(m_loadingPaths), request.path));
+                m_results.push_back(std::move(result));
+                m_requestFinished.notify_all();
+            }
+        }
+
+        EntityModelLoadQueue::Result EntityModelLoadQueue::load(const Request& request) const {
+            auto result = Result{ request.path, nullptr, {} };
+            CollectingLogger logger(result.messages);
+
+            // any exception escaping a worker thread would terminate the application, so other exceptions than
+            // ours are reported as a failed model
+            try {
+                result.model = m_loader.initializeModel(request.path, logger);
+            } catch (const Exception& e) {
+                logger.error() << e.what();
+                return result;
+            } catch (const std::exception& e) {
+                logger.error() << "Could not load entity model " << request.path.asString() << ": " << e.what();
+                result.model = nullptr;
+                return result;
+            }
+
+            if (result.model != nullptr && request.frameIndex < result.model->frameCount()) {
+                try {
+                    m_loader.loadFrame(request.path, request.frameIndex, *result.model, logger);
+                } catch (const Exception& e) {
+                    logger.error() << "Could not load entity model frame " << request.path.asString() << ":" << request.frameIndex << ": " << e.what();
+                } catch (const std::exception& e) {
+                    logger.error() << "Could not load entity model " << request.path.asString() << ": " << e.what();
+                    result.model = nullptr;
+                }
+            }
+
+            return result;
+        }
+    }
+}
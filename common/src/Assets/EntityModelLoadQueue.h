@@ -0,0 +1,132 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef TrenchBroom_EntityModelLoadQueue
+#define TrenchBroom_EntityModelLoadQueue
+
+#include "Logger.h"
+#include "IO/Path.h"
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace IO {
+        class EntityModelLoader;
+    }
+
+    namespace Assets {
+        class EntityModel;
+
+        /**
+         * Loads entity models on a pool of worker threads.
+         *
+         * Each request loads a model and one of its frames. Every model is loaded at most once per request, even if it
+         * is requested again while it is waiting or being loaded. The loaded models are collected by calling
+         * takeResults() on the thread that uses them, typically the GL thread. The messages which the loader logs while
+         * loading a model are stored with the result and must be forwarded to a logger by the caller, since loggers are
+         * not thread safe.
+         *
+         * The given loader must allow loading different models concurrently.
+         */
+        class EntityModelLoadQueue {
+        public:
+            struct LogMessage {
+                LogLevel level;
+                std::string message;
+            };
+
+            struct Result {
+                IO::Path path;
+                /**
+                 * The loaded model, or null if it could not be loaded.
+                 */
+                std::unique_ptr<EntityModel> model;
+                std::vector<LogMessage> messages;
+            };
+        private:
+            struct Request {
+                IO::Path path;
+                size_t frameIndex;
+            };
+
+            const IO::EntityModelLoader& m_loader;
+
+            mutable std::mutex m_mutex;
+            std::condition_variable m_requestAvailable;
+            std::condition_variable m_requestFinished;
+            std::deque<Request> m_requests;
+            std::vector<IO::Path> m_loadingPaths;
+            std::vector<Result> m_results;
+            bool m_stopping;
+
+            std::vector<std::thread> m_workers;
+        public:
+            /**
+             * Creates a new queue and starts the given number of worker threads, but at least one.
+             */
+            EntityModelLoadQueue(const IO::EntityModelLoader& loader, size_t threadCount);
+
+            /**
+             * Discards all requests that have not been started yet and waits for the worker threads to finish the
+             * models they are currently loading.
+             */
+            ~EntityModelLoadQueue();
+
+            /**
+             * Requests loading the model with the given path and the frame with the given index. Does nothing if the
+             * model is already waiting to be loaded or being loaded.
+             */
+            void enqueue(const IO::Path& path, size_t frameIndex);
+
+            /**
+             * Indicates whether the model with the given path is waiting to be loaded or being loaded.
+             */
+            bool pending(const IO::Path& path) const;
+
+            /**
+             * Indicates whether any model is waiting to be loaded or being loaded, or whether any results have not been
+             * taken yet.
+             */
+            bool busy() const;
+
+            /**
+             * Returns the results of all requests that were finished since this function was last called.
+             */
+            std::vector<Result> takeResults();
+
+            /**
+             * Blocks until all requests have been finished.
+             */
+            void waitUntilIdle();
+        private:
+            bool isPending(const IO::Path& path) const;
+            void work();
+            Result load(const Request& request) const;
+        };
+    }
+}
+
+#endif /* defined(TrenchBroom_EntityModelLoadQueue) */
@@ -23,11 +23,14 @@
 #include "Logger.h"
 #include "Macros.h"
 #include "Assets/EntityModel.h"
+#include "Assets/EntityModelLoadQueue.h"
 #include "Assets/ModelDefinition.h"
 #include "IO/EntityModelLoader.h"
 #include "Model/EntityNode.h"
 #include "Renderer/TexturedIndexRangeRenderer.h"
 
+#include <kdl/parallel.h>
+
 namespace TrenchBroom {
     namespace Assets {
         EntityModelManager::EntityModelManager(const int magFilter, const int minFilter, Logger& logger) :
@@ -38,10 +41,17 @@ namespace TrenchBroom {
         m_resetTextureMode(false) {}
 
         EntityModelManager::~EntityModelManager() {
-            clear();
+            m_loadQueue.reset();
+            clearModels();
         }
 
         void EntityModelManager::clear() {
+            // discard the models which are being loaded for the previous state
+            resetLoadQueue();
+            clearModels();
+        }
+
+        void EntityModelManager::clearModels() {
             m_renderers.clear();
             m_models.clear();
             m_rendererMismatches.clear();
@@ -60,12 +70,13 @@ namespace TrenchBroom {
         }
 
         void EntityModelManager::setLoader(const IO::EntityModelLoader* loader) {
-            clear();
+            m_loadQueue.reset();
             m_loader = loader;
+            clear();
         }
 
         Renderer::TexturedRenderer* EntityModelManager::renderer(const Assets::ModelSpecification& spec) const {
-            auto* entityModel = safeGetModel(spec.path);
+            auto* entityModel = loadedModel(spec.path, spec.frameIndex);
 
             if (entityModel == nullptr) {
                 return nullptr;
@@ -110,6 +121,85 @@ namespace TrenchBroom {
             }
         }
 
+        const EntityModelFrame* EntityModelManager::requestFrame(const Assets::ModelSpecification& spec) const {
+            auto* model = loadedModel(spec.path, spec.frameIndex);
+            if (model == nullptr) {
+                return nullptr;
+            } else if (spec.frameIndex >= model->frameCount()) {
+                return nullptr;
+            } else {
+                if (!model->frame(spec.frameIndex)->loaded()) {
+                    loadFrame(spec, *model);
+                }
+                return model->frame(spec.frameIndex);
+            }
+        }
+
+        bool EntityModelManager::hasPendingModels() const {
+            return m_loadQueue != nullptr && m_loadQueue->busy();
+        }
+
+        std::vector<IO::Path> EntityModelManager::collectLoadedModels() {
+            auto result = std::vector<IO::Path>();
+            if (m_loadQueue == nullptr) {
+                return result;
+            }
+
+            for (auto& loadResult : m_loadQueue->takeResults()) {
+                const auto& path = loadResult.path;
+                if (m_models.count(path) > 0 || m_modelMismatches.count(path) > 0) {
+                    // the model was loaded synchronously in the meantime
+                    continue;
+                }
+
+                for (const auto& message : loadResult.messages) {
+                    m_logger.log(message.level, message.message);
+                }
+
+                if (loadResult.model != nullptr) {
+                    const auto [pos, success] = m_models.insert({ path, std::move(loadResult.model) });
+                    assert(success); unused(success);
+
+                    m_unpreparedModels.push_back(pos->second.get());
+                    m_logger.debug() << "Loaded entity model " << path;
+                    result.push_back(path);
+                } else {
+                    m_modelMismatches.insert(path);
+                }
+            }
+
+            return result;
+        }
+
+        void EntityModelManager::waitForPendingModels() const {
+            if (m_loadQueue != nullptr) {
+                m_loadQueue->waitUntilIdle();
+            }
+        }
+
+        void EntityModelManager::resetLoadQueue() {
+            m_loadQueue.reset();
+            if (m_loader != nullptr) {
+                m_loadQueue = std::make_unique<EntityModelLoadQueue>(*m_loader, kdl::parallel_default_thread_count());
+            }
+        }
+
+        EntityModel* EntityModelManager::loadedModel(const IO::Path& path, const size_t frameIndex) const {
+            if (path.isEmpty()) {
+                return nullptr;
+            }
+
+            auto it = m_models.find(path);
+            if (it != std::end(m_models)) {
+                return it->second.get();
+            }
+
+            if (m_modelMismatches.count(path) == 0 && m_loadQueue != nullptr) {
+                m_loadQueue->enqueue(path, frameIndex);
+            }
+            return nullptr;
+        }
+
         EntityModel* EntityModelManager::model(const IO::Path& path) const {
             if (path.isEmpty()) {
                 return nullptr;
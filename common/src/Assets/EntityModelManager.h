@@ -47,6 +47,7 @@ namespace TrenchBroom {
     namespace Assets {
         class EntityModel;
         class EntityModelFrame;
+        class EntityModelLoadQueue;
         struct ModelSpecification;
 
         class EntityModelManager {
@@ -61,6 +62,7 @@ namespace TrenchBroom {
 
             Logger& m_logger;
             const IO::EntityModelLoader* m_loader;
+            std::unique_ptr<EntityModelLoadQueue> m_loadQueue;
 
             int m_minFilter;
             int m_magFilter;
@@ -81,10 +83,43 @@ namespace TrenchBroom {
 
             void setTextureMode(int minFilter, int magFilter);
             void setLoader(const IO::EntityModelLoader* loader);
+            /**
+             * Returns the renderer for the given model specification. If the model has not been loaded yet, it is
+             * requested from the load queue and null is returned.
+             */
             Renderer::TexturedRenderer* renderer(const ModelSpecification& spec) const;
 
+            /**
+             * Returns the frame for the given model specification, loading the model synchronously if necessary.
+             */
             const EntityModelFrame* frame(const ModelSpecification& spec) const;
+
+            /**
+             * Returns the frame for the given model specification if its model has already been loaded. Otherwise,
+             * the model is requested from the load queue and null is returned. Once the model has been loaded, it
+             * is returned by collectLoadedModels().
+             */
+            const EntityModelFrame* requestFrame(const ModelSpecification& spec) const;
+
+            /**
+             * Indicates whether any requested models are still being loaded or have not been collected yet.
+             */
+            bool hasPendingModels() const;
+
+            /**
+             * Adds the models which have been loaded in the background since the last call to this manager and
+             * returns their paths. Must be called on the thread that uses this manager.
+             */
+            std::vector<IO::Path> collectLoadedModels();
+
+            /**
+             * Blocks until all requested models have been loaded. Must be called before the loader is modified.
+             */
+            void waitForPendingModels() const;
         private:
+            void resetLoadQueue();
+            void clearModels();
+            EntityModel* loadedModel(const IO::Path& path, size_t frameIndex) const;
             EntityModel* model(const IO::Path& path) const;
             EntityModel* safeGetModel(const IO::Path& path) const;
             std::unique_ptr<EntityModel> loadModel(const IO::Path& path) const;
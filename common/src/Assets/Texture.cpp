@@ -24,9 +24,14 @@
 
 #include <algorithm> // for std::max
 #include <cassert>
+#include <cstdint>
 
 namespace TrenchBroom {
     namespace Assets {
+        // textures are only activated on the thread that owns the OpenGL context
+        static std::uint64_t activationCount = 0;
+        static std::uint64_t lazyUploadCount = 0;
+
         Texture::Texture(const std::string& name, const size_t width, const size_t height, const Color& averageColor, Buffer&& buffer, const GLenum format, const TextureType type) :
         m_collection(nullptr),
         m_name(name),
@@ -39,7 +44,12 @@ namespace TrenchBroom {
         m_type(type),
         m_culling(TextureCulling::CullDefault),
         m_blendFunc{TextureBlendFunc::Enable::UseDefault, GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA},
-        m_textureId(0) {
+        m_textureId(0),
+        m_minFilter(GL_NEAREST),
+        m_magFilter(GL_NEAREST),
+        m_resident(false),
+        m_decodeFailed(false),
+        m_lastActivation(0) {
             assert(m_width > 0);
             assert(m_height > 0);
             assert(buffer.size() >= m_width * m_height * bytesPerPixelForFormat(format));
@@ -59,7 +69,12 @@ namespace TrenchBroom {
         m_culling(TextureCulling::CullDefault),
         m_blendFunc{TextureBlendFunc::Enable::UseDefault, GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA},
         m_textureId(0),
-        m_buffers(std::move(buffers)) {
+        m_buffers(std::move(buffers)),
+        m_minFilter(GL_NEAREST),
+        m_magFilter(GL_NEAREST),
+        m_resident(false),
+        m_decodeFailed(false),
+        m_lastActivation(0) {
             assert(m_width > 0);
             assert(m_height > 0);
 
@@ -84,7 +99,12 @@ namespace TrenchBroom {
         m_type(type),
         m_culling(TextureCulling::CullDefault),
         m_blendFunc{TextureBlendFunc::Enable::UseDefault, GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA},
-        m_textureId(0) {}
+        m_textureId(0),
+        m_minFilter(GL_NEAREST),
+        m_magFilter(GL_NEAREST),
+        m_resident(false),
+        m_decodeFailed(false),
+        m_lastActivation(0) {}
 
         Texture::~Texture() {
             if (m_collection == nullptr && m_textureId != 0) {
@@ -182,6 +202,21 @@ namespace TrenchBroom {
             m_overridden = overridden;
         }
 
+        void Texture::setBufferLoader(BufferLoader bufferLoader) {
+            assert(!isPrepared());
+            m_bufferLoader = std::move(bufferLoader);
+            m_buffers = BufferList();
+        }
+
+        bool Texture::lazy() const {
+            return static_cast<bool>(m_bufferLoader);
+        }
+
+        Texture::BufferList Texture::releaseBuffers() {
+            assert(!isPrepared());
+            return std::move(m_buffers);
+        }
+
         bool Texture::isPrepared() const {
             return m_textureId != 0;
         }
@@ -190,52 +225,25 @@ namespace TrenchBroom {
             assert(textureId > 0);
             assert(m_textureId == 0);
 
-            if (!m_buffers.empty()) {
-                glAssert(glPixelStorei(GL_UNPACK_SWAP_BYTES, false));
-                glAssert(glPixelStorei(GL_UNPACK_LSB_FIRST, false));
-                glAssert(glPixelStorei(GL_UNPACK_ROW_LENGTH, 0));
-                glAssert(glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0));
-                glAssert(glPixelStorei(GL_UNPACK_SKIP_ROWS, 0));
-                glAssert(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
-
-                glAssert(glBindTexture(GL_TEXTURE_2D, textureId));
-                glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, minFilter));
-                glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, magFilter));
-                glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT));
-                glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT));
-
-                if (m_type == TextureType::Masked) {
-                    // masked textures don't work well with automatic mipmaps, so we force GL_NEAREST filtering and don't generate any
-                    glAssert(glTexParameteri(GL_TEXTURE_2D, GL_GENERATE_MIPMAP, GL_FALSE));
-                    glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST));
-                    glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST));
-                } else if (m_buffers.size() == 1) {
-                    // generate mipmaps if we don't have any
-                    glAssert(glTexParameteri(GL_TEXTURE_2D, GL_GENERATE_MIPMAP, GL_TRUE));
-                } else {
-                    glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(m_buffers.size() - 1)));
-                }
-
-                // Upload only the first mipmap for masked textures.
-                const auto mipmapsToUpload = (m_type == TextureType::Masked) ? 1u : m_buffers.size();
-
-                for (size_t j = 0; j < mipmapsToUpload; ++j) {
-                    const auto mipSize = sizeAtMipLevel(m_width, m_height, j);
-
-                    const GLvoid* data = reinterpret_cast<const GLvoid*>(m_buffers[j].data());
-                    glAssert(glTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(j), GL_RGBA,
-                                          static_cast<GLsizei>(mipSize.x()),
-                                          static_cast<GLsizei>(mipSize.y()),
-                                          0, m_format, GL_UNSIGNED_BYTE, data));
-                }
+            m_minFilter = minFilter;
+            m_magFilter = magFilter;
 
+            if (!m_buffers.empty()) {
+                upload(textureId, m_buffers);
                 m_buffers.clear();
                 m_textureId = textureId;
+                m_resident = true;
+            } else if (lazy()) {
+                // the contents are uploaded when the texture is activated
+                m_textureId = textureId;
             }
         }
 
         void Texture::setMode(const int minFilter, const int magFilter) {
-            if (isPrepared()) {
+            m_minFilter = minFilter;
+            m_magFilter = magFilter;
+
+            if (isResident()) {
                 activate();
                 if (m_type == TextureType::Masked) {
                     // Force GL_NEAREST filtering for masked textures.
@@ -249,8 +257,53 @@ namespace TrenchBroom {
             }
         }
 
+        bool Texture::isResident() const {
+            return m_resident;
+        }
+
+        size_t Texture::residentSize() const {
+            // textures are stored as RGBA, and a full chain of mip levels adds another third
+            return m_resident && !m_decodeFailed ? m_width * m_height * 4u * 4u / 3u : 0u;
+        }
+
+        std::uint64_t Texture::lastActivation() const {
+            return m_lastActivation;
+        }
+
+        std::uint64_t Texture::currentActivation() {
+            return activationCount;
+        }
+
+        std::uint64_t Texture::lazyUploads() {
+            return lazyUploadCount;
+        }
+
+        void Texture::evict() {
+            if (lazy() && m_resident && !m_decodeFailed) {
+                // Redefine every mip level as an empty image to release its memory. The texture name is kept because
+                // it belongs to the collection.
+                glAssert(glBindTexture(GL_TEXTURE_2D, m_textureId));
+                for (size_t level = 0; (m_width >> level) > 0 || (m_height >> level) > 0; ++level) {
+                    glAssert(glTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(level), GL_RGBA, 0, 0, 0, m_format, GL_UNSIGNED_BYTE, nullptr));
+                }
+                glAssert(glBindTexture(GL_TEXTURE_2D, 0));
+                m_resident = false;
+            }
+        }
+
         void Texture::activate() const {
             if (isPrepared()) {
+                if (!m_resident) {
+                    // a texture that cannot be decoded is still considered resident so that it is not decoded every
+                    // frame, but it doesn't occupy any texture memory and is never evicted
+                    const auto buffers = m_bufferLoader();
+                    upload(m_textureId, buffers);
+                    m_resident = true;
+                    m_decodeFailed = buffers.empty();
+                    ++lazyUploadCount;
+                }
+                m_lastActivation = ++activationCount;
+
                 glAssert(glBindTexture(GL_TEXTURE_2D, m_textureId));
 
                 switch (m_culling) {
@@ -310,6 +363,10 @@ namespace TrenchBroom {
             return m_buffers;
         }
 
+        Texture::BufferList Texture::loadBuffers() const {
+            return lazy() ? m_bufferLoader() : BufferList();
+        }
+
         GLenum Texture::format() const {
             return m_format;
         }
@@ -318,6 +375,50 @@ namespace TrenchBroom {
             return m_type;
         }
 
+        void Texture::upload(const GLuint textureId, const BufferList& buffers) const {
+            if (buffers.empty()) {
+                return;
+            }
+
+            glAssert(glPixelStorei(GL_UNPACK_SWAP_BYTES, false));
+            glAssert(glPixelStorei(GL_UNPACK_LSB_FIRST, false));
+            glAssert(glPixelStorei(GL_UNPACK_ROW_LENGTH, 0));
+            glAssert(glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0));
+            glAssert(glPixelStorei(GL_UNPACK_SKIP_ROWS, 0));
+            glAssert(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
+
+            glAssert(glBindTexture(GL_TEXTURE_2D, textureId));
+            glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, m_minFilter));
+            glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, m_magFilter));
+            glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT));
+            glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT));
+
+            if (m_type == TextureType::Masked) {
+                // masked textures don't work well with automatic mipmaps, so we force GL_NEAREST filtering and don't generate any
+                glAssert(glTexParameteri(GL_TEXTURE_2D, GL_GENERATE_MIPMAP, GL_FALSE));
+                glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST));
+                glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST));
+            } else if (buffers.size() == 1) {
+                // generate mipmaps if we don't have any
+                glAssert(glTexParameteri(GL_TEXTURE_2D, GL_GENERATE_MIPMAP, GL_TRUE));
+            } else {
+                glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(buffers.size() - 1)));
+            }
+
+            // Upload only the first mipmap for masked textures.
+            const auto mipmapsToUpload = (m_type == TextureType::Masked) ? 1u : buffers.size();
+
+            for (size_t j = 0; j < mipmapsToUpload; ++j) {
+                const auto mipSize = sizeAtMipLevel(m_width, m_height, j);
+
+                const GLvoid* data = reinterpret_cast<const GLvoid*>(buffers[j].data());
+                glAssert(glTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(j), GL_RGBA,
+                                      static_cast<GLsizei>(mipSize.x()),
+                                      static_cast<GLsizei>(mipSize.y()),
+                                      0, m_format, GL_UNSIGNED_BYTE, data));
+            }
+        }
+
         void Texture::setCollection(TextureCollection* collection) {
             m_collection = collection;
         }
@@ -25,6 +25,8 @@
 
 #include <vecmath/forward.h>
 
+#include <cstdint>
+#include <functional>
 #include <set>
 #include <string>
 #include <vector>
@@ -74,6 +76,11 @@ namespace TrenchBroom {
         private:
             using Buffer = std::vector<unsigned char>;
             using BufferList = std::vector<Buffer>;
+        public:
+            /**
+             * Decodes the contents of a lazy texture. Returns an empty list if the contents cannot be decoded.
+             */
+            using BufferLoader = std::function<BufferList()>;
         private:
             TextureCollection* m_collection;
             std::string m_name;
@@ -99,6 +106,14 @@ namespace TrenchBroom {
 
             mutable GLuint m_textureId;
             mutable BufferList m_buffers;
+
+            // only set for lazy textures, see setBufferLoader
+            BufferLoader m_bufferLoader;
+            int m_minFilter;
+            int m_magFilter;
+            mutable bool m_resident;
+            mutable bool m_decodeFailed;
+            mutable std::uint64_t m_lastActivation;
         public:
             Texture(const std::string& name, size_t width, size_t height, const Color& averageColor, Buffer&& buffer, GLenum format, TextureType type);
             Texture(const std::string& name, size_t width, size_t height, const Color& averageColor, BufferList&& buffers, GLenum format, TextureType type);
@@ -133,10 +148,59 @@ namespace TrenchBroom {
             bool overridden() const;
             void setOverridden(bool overridden);
 
+            /**
+             * Makes this texture lazy. Its buffers are discarded, and the given function is called to decode them
+             * again whenever the texture is activated while it is prepared, but not resident.
+             */
+            void setBufferLoader(BufferLoader bufferLoader);
+            bool lazy() const;
+
+            /**
+             * Moves the contents out of this texture. Must not be called after the texture was prepared.
+             */
+            BufferList releaseBuffers();
+
             bool isPrepared() const;
             void prepare(GLuint textureId, int minFilter, int magFilter);
             void setMode(int minFilter, int magFilter);
 
+            /**
+             * Indicates whether the contents of this texture have been uploaded. Lazy textures become resident when
+             * they are activated and stop being resident when they are evicted.
+             */
+            bool isResident() const;
+
+            /**
+             * Returns the approximate number of bytes of texture memory that this texture occupies while it is
+             * resident, including its mip levels. Lazy textures whose contents could not be decoded occupy none.
+             */
+            size_t residentSize() const;
+
+            /**
+             * Returns a stamp that is larger for textures that were activated more recently. Textures that were never
+             * activated return 0.
+             */
+            std::uint64_t lastActivation() const;
+
+            /**
+             * Returns the stamp of the most recent activation of any texture.
+             */
+            static std::uint64_t currentActivation();
+
+            /**
+             * Returns how many times lazy textures have been decoded and uploaded when they were activated.
+             */
+            static std::uint64_t lazyUploads();
+
+            /**
+             * Releases the texture memory of a lazy texture. Its contents are decoded and uploaded again when it is
+             * activated the next time. Does nothing if this texture is not lazy or not resident.
+             */
+            void evict();
+
+            /**
+             * Binds this texture. A prepared lazy texture that is not resident is decoded and uploaded first.
+             */
             void activate() const;
             void deactivate() const;
         public: // exposed for tests only
@@ -145,12 +209,18 @@ namespace TrenchBroom {
              * Once prepare() is called, this will be an empty vector.
              */
             const BufferList& buffersIfUnprepared() const;
+
+            /**
+             * Decodes the contents of a lazy texture, or returns an empty list if this texture is not lazy.
+             */
+            BufferList loadBuffers() const;
             /**
              * Will be one of GL_RGB, GL_BGR, GL_RGBA, GL_BGRA.
              */
             GLenum format() const;
             TextureType type() const;
         private:
+            void upload(GLuint textureId, const BufferList& buffers) const;
             void setCollection(TextureCollection* collection);
             friend class TextureCollection;
         };
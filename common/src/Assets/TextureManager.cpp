@@ -59,7 +59,10 @@ namespace TrenchBroom {
         m_logger(logger),
         m_minFilter(minFilter),
         m_magFilter(magFilter),
-        m_resetTextureMode(false) {}
+        m_resetTextureMode(false),
+        m_memoryBudget(0),
+        m_lastEvictionActivation(0),
+        m_lastEvictionUploads(0) {}
 
         TextureManager::~TextureManager() {
             clear();
@@ -139,9 +142,14 @@ namespace TrenchBroom {
             m_resetTextureMode = true;
         }
 
+        void TextureManager::setMemoryBudget(const size_t memoryBudget) {
+            m_memoryBudget = memoryBudget;
+        }
+
         void TextureManager::commitChanges() {
             resetTextureMode();
             prepare();
+            evictTextures();
             kdl::vec_clear_and_delete(m_toRemove);
         }
 
@@ -184,6 +192,51 @@ namespace TrenchBroom {
             m_toPrepare.clear();
         }
 
+        /**
+         * Called by every view before it renders. Textures are only evicted if lazy textures were uploaded since the
+         * previous eviction, so that this runs at most once per frame across all views. Textures activated since the
+         * previous eviction were rendered in the current frame of some view, so they are kept to avoid uploading them
+         * again right away.
+         */
+        void TextureManager::evictTextures() {
+            if (m_memoryBudget == 0 || Texture::lazyUploads() == m_lastEvictionUploads) {
+                return;
+            }
+
+            const auto lastEvictionActivation = m_lastEvictionActivation;
+            m_lastEvictionActivation = Texture::currentActivation();
+            m_lastEvictionUploads = Texture::lazyUploads();
+
+            auto residentSize = size_t(0);
+            std::vector<Texture*> candidates;
+            for (auto* collection : m_collections) {
+                for (auto* texture : collection->textures()) {
+                    if (texture->lazy() && texture->residentSize() > 0) {
+                        residentSize += texture->residentSize();
+                        if (texture->usageCount() == 0 && texture->lastActivation() <= lastEvictionActivation) {
+                            candidates.push_back(texture);
+                        }
+                    }
+                }
+            }
+
+            if (residentSize <= m_memoryBudget) {
+                return;
+            }
+
+            std::sort(std::begin(candidates), std::end(candidates), [](const auto* lhs, const auto* rhs) {
+                return lhs->lastActivation() < rhs->lastActivation();
+            });
+
+            for (auto* texture : candidates) {
+                if (residentSize <= m_memoryBudget) {
+                    break;
+                }
+                residentSize -= texture->residentSize();
+                texture->evict();
+            }
+        }
+
         void TextureManager::updateTextures() {
             m_texturesByName.clear();
             m_textures.clear();
@@ -22,6 +22,7 @@
 
 #include "Notifier.h"
 
+#include <cstdint>
 #include <map>
 #include <string>
 #include <vector>
@@ -57,6 +58,10 @@ namespace TrenchBroom {
             int m_minFilter;
             int m_magFilter;
             bool m_resetTextureMode;
+
+            size_t m_memoryBudget;
+            std::uint64_t m_lastEvictionActivation;
+            std::uint64_t m_lastEvictionUploads;
         public:
             Notifier<> usageCountDidChange;
         public:
@@ -72,6 +77,14 @@ namespace TrenchBroom {
             void clear();
 
             void setTextureMode(int minFilter, int magFilter);
+
+            /**
+             * Sets the number of bytes of texture memory that lazy textures may occupy. When this budget is exceeded,
+             * the least recently activated lazy textures that are not used by any face are evicted. Textures used by
+             * faces or activated since the previous eviction are never evicted, so the budget may still be exceeded.
+             * A budget of 0 means that there is no limit.
+             */
+            void setMemoryBudget(size_t memoryBudget);
             void commitChanges();
 
             Texture* texture(const std::string& name) const;
@@ -81,6 +94,7 @@ namespace TrenchBroom {
         private:
             void resetTextureMode();
             void prepare();
+            void evictTextures();
 
             void updateTextures();
         };
@@ -141,6 +141,15 @@ namespace TrenchBroom {
                 return std::make_shared<CFile>(fixedPath);
             }
 
+            std::shared_ptr<MappedFile> mapFile(const Path& path) {
+                const Path fixedPath = fixPath(path);
+                if (!fileExists(fixedPath)) {
+                    throw FileNotFoundException(fixedPath.asString());
+                }
+
+                return std::make_shared<MappedFile>(fixedPath);
+            }
+
             std::string readFile(const Path& path) {
                 const Path fixedPath = fixPath(path);
 
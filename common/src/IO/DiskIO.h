@@ -28,6 +28,7 @@
 namespace TrenchBroom {
     namespace IO {
         class File;
+        class MappedFile;
 
         namespace Disk {
             bool isCaseSensitive();
@@ -39,6 +40,15 @@ namespace TrenchBroom {
 
             std::vector<Path> getDirectoryContents(const Path& path);
             std::shared_ptr<File> openFile(const Path& path);
+
+            /**
+             * Opens the file at the given path and maps it into memory. The returned file should only be kept while
+             * its contents are being parsed, see MappedFile.
+             *
+             * @throw FileNotFoundException if the file does not exist
+             * @throw FileSystemException if the file cannot be opened or read
+             */
+            std::shared_ptr<MappedFile> mapFile(const Path& path);
             std::string readFile(const Path& path);
             Path getCurrentWorkingDir();
 
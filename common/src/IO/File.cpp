@@ -21,6 +21,9 @@
 
 #include "Exceptions.h"
 #include "IO/IOUtils.h"
+#include "IO/PathQt.h"
+
+#include <QFile>
 
 namespace TrenchBroom {
     namespace IO {
@@ -79,7 +82,7 @@ namespace TrenchBroom {
         }
 
         Reader CFile::reader() const {
-            return Reader::from(m_file);
+            return Reader::from(m_file, m_size);
         }
 
         size_t CFile::size() const {
@@ -90,6 +93,60 @@ namespace TrenchBroom {
             return m_file;
         }
 
+        MappedFile::MappedFile(const Path& path) :
+        File(path),
+        m_file(std::make_unique<QFile>(pathAsQString(path))),
+        m_begin(nullptr),
+        m_end(nullptr) {
+            if (!m_file->open(QIODevice::ReadOnly)) {
+                throw FileSystemException("Cannot open file " + path.asString());
+            }
+
+            const auto size = m_file->size();
+            if (size <= 0) {
+                return;
+            }
+
+#ifndef _WIN32
+            const auto* data = m_file->map(0, size);
+            if (data != nullptr) {
+                m_begin = reinterpret_cast<const char*>(data);
+                m_end = m_begin + size;
+                return;
+            }
+#endif
+
+            // mapping is not supported for all kinds of files, and on Windows, a mapped file cannot be modified or
+            // deleted by other programs until it is unmapped, so read the contents and close the file instead
+            m_buffer = std::make_unique<char[]>(static_cast<size_t>(size));
+            if (m_file->read(m_buffer.get(), size) != size) {
+                throw FileSystemException("Cannot read file " + path.asString());
+            }
+            m_file->close();
+
+            m_begin = m_buffer.get();
+            m_end = m_begin + size;
+        }
+
+        // unmaps the file, if necessary, and closes it
+        MappedFile::~MappedFile() = default;
+
+        Reader MappedFile::reader() const {
+            return Reader::from(m_begin, m_end);
+        }
+
+        size_t MappedFile::size() const {
+            return static_cast<size_t>(m_end - m_begin);
+        }
+
+        const char* MappedFile::begin() const {
+            return m_begin;
+        }
+
+        const char* MappedFile::end() const {
+            return m_end;
+        }
+
         FileView::FileView(const Path& path, std::shared_ptr<File> file, const size_t offset, const size_t length) :
         File(path),
         m_file(std::move(file)),
@@ -26,6 +26,8 @@
 #include <cstdio>
 #include <memory>
 
+class QFile;
+
 namespace TrenchBroom {
     namespace IO {
         /**
@@ -134,6 +136,50 @@ namespace TrenchBroom {
             std::FILE* file() const;
         };
 
+        /**
+         * A file that is backed by a physical file on the disk which is mapped into memory. The file is opened and
+         * mapped in the constructor and unmapped and closed in the destructor.
+         *
+         * The contents are paged in lazily by the operating system, and readers obtained from this file access the
+         * mapped memory directly, so buffering them does not copy the file contents. If the file cannot be mapped, its
+         * contents are read into a memory buffer instead. On Windows, the contents are always read into a buffer
+         * because other programs cannot modify or delete a file while it is mapped.
+         *
+         * If another program truncates the file while it is mapped, accessing the removed part of the mapping raises
+         * SIGBUS. Therefore, instances of this class should only be kept while the file contents are being parsed, and
+         * files that are kept open for longer, such as archives, should be opened as a CFile instead.
+         */
+        class MappedFile : public File {
+        private:
+            std::unique_ptr<QFile> m_file;
+            std::unique_ptr<char[]> m_buffer;
+            const char* m_begin;
+            const char* m_end;
+        public:
+            /**
+             * Creates a new file with the given path, opens the file for reading and maps it into memory.
+             *
+             * @param path the path of the file
+             *
+             * @throw FileSystemException if the file cannot be opened or read
+             */
+            explicit MappedFile(const Path& path);
+            ~MappedFile() override;
+
+            Reader reader() const override;
+            size_t size() const override;
+
+            /**
+             * Returns the start of the memory region containing the file contents.
+             */
+            const char* begin() const;
+
+            /**
+             * Returns the end of the memory region containing the file contents (position after the last byte).
+             */
+            const char* end() const;
+        };
+
         /**
          * A file that is backed by a portion of a physical file.
          */
@@ -76,6 +76,10 @@ namespace TrenchBroom {
             return average;
         }
 
+        bool FreeImageTextureReader::doCanReadConcurrently() const {
+            return true;
+        }
+
         Assets::Texture* FreeImageTextureReader::doReadTexture(std::shared_ptr<File> file) const {
             auto reader = file->reader().buffer();
 
@@ -44,6 +44,10 @@ namespace TrenchBroom {
         M8TextureReader::M8TextureReader(const NameStrategy& nameStrategy, const FileSystem& fs, Logger& logger) :
         TextureReader(nameStrategy, fs, logger) {}
 
+        bool M8TextureReader::doCanReadConcurrently() const {
+            return true;
+        }
+
         Assets::Texture* M8TextureReader::doReadTexture(std::shared_ptr<File> file) const {
             const auto& path = file->path();
             BufferedReader reader = file->reader().buffer();
@@ -37,6 +37,7 @@ namespace TrenchBroom {
             M8TextureReader(const NameStrategy& nameStrategy, const FileSystem& fs, Logger& logger);
         private:
             Assets::Texture* doReadTexture(std::shared_ptr<File> file) const override;
+            bool doCanReadConcurrently() const override;
         };
     }
 }
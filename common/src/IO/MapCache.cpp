@@ -0,0 +1,408 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MapCache.h"
+
+#include "Color.h"
+#include "Exceptions.h"
+#include "IO/DiskIO.h"
+#include "IO/File.h"
+#include "IO/MapParser.h"
+#include "IO/NodeWriter.h"
+#include "IO/Path.h"
+#include "IO/Reader.h"
+#include "IO/ReaderException.h"
+#include "IO/SimpleParserStatus.h"
+#include "IO/WorldReader.h"
+#include "Model/BrushFace.h"
+#include "Model/BrushFaceAttributes.h"
+#include "Model/BrushNode.h"
+#include "Model/EntityAttributes.h"
+#include "Model/Node.h"
+#include "Model/WorldNode.h"
+
+#include <vecmath/bbox.h>
+#include <vecmath/vec.h>
+
+#include <array>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <QString>
+
+namespace TrenchBroom {
+    namespace IO {
+        namespace MapCacheLayout {
+            static const std::array<char, 4> Magic = { 'T', 'B', 'M', 'C' };
+            static const size_t HeaderSize = Magic.size() + sizeof(std::uint32_t) + sizeof(MapCache::Key);
+
+            enum class Record : std::uint8_t {
+                BeginEntity = 1,
+                EntityAttribute,
+                BeginBrush,
+                BrushFace,
+                EndBrush,
+                EndEntity,
+                EndFile
+            };
+        }
+
+        template <typename T>
+        static void writeValue(std::ostream& stream, const T value) {
+            stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+
+        static void writeRecord(std::ostream& stream, const MapCacheLayout::Record record) {
+            writeValue(stream, static_cast<std::uint8_t>(record));
+        }
+
+        static void writeString(std::ostream& stream, const std::string& str) {
+            writeValue(stream, static_cast<std::uint32_t>(str.size()));
+            stream.write(str.data(), static_cast<std::streamsize>(str.size()));
+        }
+
+        template <typename T, size_t S>
+        static void writeVec(std::ostream& stream, const vm::vec<T,S>& vec) {
+            for (size_t i = 0; i < S; ++i) {
+                writeValue(stream, vec[i]);
+            }
+        }
+
+        static void writeFilePosition(std::ostream& stream, const Model::Node* node) {
+            writeValue(stream, static_cast<std::uint64_t>(node->lineNumber()));
+            writeValue(stream, static_cast<std::uint64_t>(node->lineCount()));
+        }
+
+        MapCacheSerializer::MapCacheSerializer(std::ostream& stream) :
+        m_stream(stream) {}
+
+        void MapCacheSerializer::doBeginFile() {}
+
+        void MapCacheSerializer::doEndFile() {
+            writeRecord(m_stream, MapCacheLayout::Record::EndFile);
+        }
+
+        void MapCacheSerializer::doBeginEntity(const Model::Node* node) {
+            writeRecord(m_stream, MapCacheLayout::Record::BeginEntity);
+            writeValue(m_stream, static_cast<std::uint64_t>(node->lineNumber()));
+        }
+
+        void MapCacheSerializer::doEndEntity(const Model::Node* node) {
+            writeRecord(m_stream, MapCacheLayout::Record::EndEntity);
+            writeFilePosition(m_stream, node);
+        }
+
+        void MapCacheSerializer::doEntityAttribute(const Model::EntityAttribute& attribute) {
+            writeRecord(m_stream, MapCacheLayout::Record::EntityAttribute);
+            writeString(m_stream, attribute.name());
+            writeString(m_stream, attribute.value());
+        }
+
+        void MapCacheSerializer::doBeginBrush(const Model::BrushNode* brush) {
+            writeRecord(m_stream, MapCacheLayout::Record::BeginBrush);
+            writeValue(m_stream, static_cast<std::uint64_t>(brush->lineNumber()));
+        }
+
+        void MapCacheSerializer::doEndBrush(const Model::BrushNode* brush) {
+            writeRecord(m_stream, MapCacheLayout::Record::EndBrush);
+            writeFilePosition(m_stream, brush);
+        }
+
+        void MapCacheSerializer::doBrushFace(const Model::BrushFace& face) {
+            writeRecord(m_stream, MapCacheLayout::Record::BrushFace);
+            writeValue(m_stream, static_cast<std::uint64_t>(face.lineNumber()));
+
+            for (const auto& point : face.points()) {
+                writeVec(m_stream, point);
+            }
+
+            const auto& attributes = face.attributes();
+            writeString(m_stream, attributes.textureName());
+            writeVec(m_stream, attributes.offset());
+            writeVec(m_stream, attributes.scale());
+            writeValue(m_stream, attributes.rotation());
+            writeValue(m_stream, static_cast<std::int32_t>(attributes.surfaceContents()));
+            writeValue(m_stream, static_cast<std::int32_t>(attributes.surfaceFlags()));
+            writeValue(m_stream, attributes.surfaceValue());
+            writeVec(m_stream, static_cast<const vm::vec<float,4>&>(attributes.color()));
+
+            writeVec(m_stream, face.textureXAxis());
+            writeVec(m_stream, face.textureYAxis());
+        }
+
+        const std::uint32_t MapCache::Version = 2;
+
+        Path MapCache::cachePath(const Path& mapPath) {
+            return mapPath.addExtension("tbcache");
+        }
+
+        /**
+         * Computes a 64 bit FNV-1a hash of the map file contents. The game name, the map format and the cache version
+         * are mixed in so that a cache is never used for a different game configuration.
+         */
+        MapCache::Key MapCache::computeKey(const char* begin, const char* end, const std::string& gameName, const Model::MapFormat format) {
+            Key hash = 14695981039346656037ull;
+            const auto mix = [&](const char* cur, const char* last) {
+                while (cur != last) {
+                    hash ^= static_cast<unsigned char>(*cur++);
+                    hash *= 1099511628211ull;
+                }
+            };
+
+            const auto suffix = gameName + "\n" + Model::formatName(format) + "\n" + std::to_string(Version);
+            mix(begin, end);
+            mix(suffix.data(), suffix.data() + suffix.size());
+            return hash;
+        }
+
+        static void writeCache(const Model::WorldNode& world, const std::vector<MapCache::LogMessage>& messages, const MapCache::Key key, const Path& path) {
+            std::ofstream stream(path.asString().c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+            if (!stream.is_open()) {
+                throw FileSystemException("Cannot open file: " + path.asString());
+            }
+
+            stream.write(MapCacheLayout::Magic.data(), static_cast<std::streamsize>(MapCacheLayout::Magic.size()));
+            writeValue(stream, MapCache::Version);
+            writeValue(stream, key);
+
+            writeValue(stream, static_cast<std::uint32_t>(messages.size()));
+            for (const auto& message : messages) {
+                writeValue(stream, static_cast<std::uint8_t>(message.level));
+                writeString(stream, message.message);
+            }
+
+            NodeWriter writer(world, new MapCacheSerializer(stream));
+            writer.writeMap();
+
+            stream.close();
+            if (!stream) {
+                throw FileSystemException("Cannot write file: " + path.asString());
+            }
+        }
+
+        void MapCache::write(const Model::WorldNode& world, const std::vector<LogMessage>& messages, const Key key, const Path& path) {
+            const auto tempPath = path.addExtension("tmp");
+            try {
+                writeCache(world, messages, key, tempPath);
+                Disk::moveFile(tempPath, path, true);
+            } catch (const FileSystemException&) {
+                if (Disk::fileExists(tempPath)) {
+                    Disk::deleteFile(tempPath);
+                }
+                throw;
+            }
+        }
+
+        static size_t readLineNumber(Reader& reader) {
+            return reader.readSize<std::uint64_t>();
+        }
+
+        static std::string readString(Reader& reader) {
+            const auto size = reader.readSize<std::uint32_t>();
+            return reader.readString(size);
+        }
+
+        std::optional<MapCache> MapCache::open(const Path& path, const Key key) {
+            if (!Disk::fileExists(path)) {
+                return std::nullopt;
+            }
+
+            auto file = Disk::mapFile(path);
+            if (file->size() < MapCacheLayout::HeaderSize) {
+                return std::nullopt;
+            }
+
+            auto reader = file->reader();
+            std::array<char, 4> magic;
+            reader.read(magic.data(), magic.size());
+            if (magic != MapCacheLayout::Magic ||
+                reader.readUnsignedInt<std::uint32_t>() != Version ||
+                reader.read<Key, Key>() != key) {
+                return std::nullopt;
+            }
+
+            auto messages = std::vector<LogMessage>();
+            const auto messageCount = reader.readSize<std::uint32_t>();
+            messages.reserve(messageCount);
+            for (size_t i = 0; i < messageCount; ++i) {
+                const auto level = reader.readUnsignedChar<std::uint8_t>();
+                if (level > static_cast<std::uint8_t>(LogLevel::Error)) {
+                    throw ReaderException("Unknown map cache log level: " + std::to_string(static_cast<int>(level)));
+                }
+                messages.push_back({ static_cast<LogLevel>(level), readString(reader) });
+            }
+
+            const auto recordsPosition = reader.position();
+            return MapCache(std::move(file), std::move(messages), recordsPosition);
+        }
+
+        namespace {
+            /**
+             * Forwards the messages logged while parsing a map file to another logger and records them, so that they
+             * can be stored in the map cache.
+             */
+            class RecordingLogger : public Logger {
+            private:
+                Logger& m_logger;
+                std::vector<MapCache::LogMessage> m_messages;
+            public:
+                explicit RecordingLogger(Logger& logger) :
+                m_logger(logger) {}
+
+                const std::vector<MapCache::LogMessage>& messages() const {
+                    return m_messages;
+                }
+            private:
+                void doLog(const LogLevel level, const std::string& message) override {
+                    m_messages.push_back({ level, message });
+                    m_logger.log(level, message);
+                }
+
+                void doLog(const LogLevel level, const QString& message) override {
+                    m_messages.push_back({ level, message.toStdString() });
+                    m_logger.log(level, message);
+                }
+            };
+        }
+
+        std::unique_ptr<Model::WorldNode> MapCache::readWorld(const char* begin, const char* end, const std::string& gameName, const Model::MapFormat format, const vm::bbox3& worldBounds, const Path& path, Logger& logger) {
+            const auto key = computeKey(begin, end, gameName, format);
+            try {
+                if (const auto cache = open(path, key)) {
+                    // replaying the cache reports the same messages as parsing the map file did, but those are already
+                    // stored in the cache, so they must not be logged here
+                    NullLogger nullLogger;
+                    SimpleParserStatus parserStatus(nullLogger);
+                    WorldReader worldReader(begin, end);
+                    auto world = worldReader.read(*cache, format, worldBounds, parserStatus);
+
+                    for (const auto& message : cache->messages()) {
+                        logger.log(message.level, message.message);
+                    }
+                    return world;
+                }
+            } catch (const Exception& e) {
+                logger.warn() << "Could not read map cache '" << path << "', loading map file: " << e.what();
+            }
+
+            RecordingLogger recordingLogger(logger);
+            SimpleParserStatus parserStatus(recordingLogger);
+            WorldReader worldReader(begin, end);
+            auto world = worldReader.read(format, worldBounds, parserStatus);
+            try {
+                write(*world, recordingLogger.messages(), key, path);
+            } catch (const Exception& e) {
+                logger.warn() << "Could not write map cache '" << path << "': " << e.what();
+            }
+            return world;
+        }
+
+        MapCache::MapCache(std::shared_ptr<File> file, std::vector<LogMessage> messages, const size_t recordsPosition) :
+        m_file(std::move(file)),
+        m_messages(std::move(messages)),
+        m_recordsPosition(recordsPosition) {}
+
+        const std::vector<MapCache::LogMessage>& MapCache::messages() const {
+            return m_messages;
+        }
+
+        static Model::BrushFaceAttributes readFaceAttributes(Reader& reader) {
+            Model::BrushFaceAttributes attributes(readString(reader));
+            attributes.setOffset(reader.readVec<float, 2>());
+            attributes.setScale(reader.readVec<float, 2>());
+            attributes.setRotation(reader.readFloat<float>());
+            attributes.setSurfaceContents(reader.readInt<std::int32_t>());
+            attributes.setSurfaceFlags(reader.readInt<std::int32_t>());
+            attributes.setSurfaceValue(reader.readFloat<float>());
+            attributes.setColor(Color(reader.readVec<float, 4>()));
+            return attributes;
+        }
+
+        void MapCache::replay(const Model::MapFormat format, MapParser& parser, ParserStatus& status) const {
+            using MapCacheLayout::Record;
+
+            auto reader = m_file->reader();
+            reader.seekFromBegin(m_recordsPosition);
+
+            parser.formatSet(format);
+
+            // the attributes of an entity follow its begin record, so the entity is passed to the parser only once all
+            // of its attributes have been read
+            const MapParser::ExtraAttributes extraAttributes;
+            std::vector<Model::EntityAttribute> attributes;
+            std::optional<size_t> pendingEntityLine;
+            const auto flushEntity = [&]() {
+                if (pendingEntityLine) {
+                    parser.beginEntity(*pendingEntityLine, attributes, extraAttributes, status);
+                    attributes.clear();
+                    pendingEntityLine = std::nullopt;
+                }
+            };
+
+            while (true) {
+                const auto record = static_cast<Record>(reader.readUnsignedChar<std::uint8_t>());
+                switch (record) {
+                    case Record::BeginEntity:
+                        flushEntity();
+                        pendingEntityLine = readLineNumber(reader);
+                        break;
+                    case Record::EntityAttribute: {
+                        auto name = readString(reader);
+                        auto value = readString(reader);
+                        attributes.emplace_back(std::move(name), std::move(value));
+                        break;
+                    }
+                    case Record::BeginBrush:
+                        flushEntity();
+                        parser.beginBrush(readLineNumber(reader), status);
+                        break;
+                    case Record::BrushFace: {
+                        const auto line = readLineNumber(reader);
+                        const auto point1 = reader.readVec<FloatType, 3>();
+                        const auto point2 = reader.readVec<FloatType, 3>();
+                        const auto point3 = reader.readVec<FloatType, 3>();
+                        const auto faceAttributes = readFaceAttributes(reader);
+                        const auto texAxisX = reader.readVec<FloatType, 3>();
+                        const auto texAxisY = reader.readVec<FloatType, 3>();
+                        parser.brushFace(line, point1, point2, point3, faceAttributes, texAxisX, texAxisY, status);
+                        break;
+                    }
+                    case Record::EndBrush: {
+                        const auto startLine = readLineNumber(reader);
+                        const auto lineCount = readLineNumber(reader);
+                        parser.endBrush(startLine, lineCount, extraAttributes, status);
+                        break;
+                    }
+                    case Record::EndEntity: {
+                        flushEntity();
+                        const auto startLine = readLineNumber(reader);
+                        const auto lineCount = readLineNumber(reader);
+                        parser.endEntity(startLine, lineCount, status);
+                        break;
+                    }
+                    case Record::EndFile:
+                        return;
+                    default:
+                        throw ReaderException("Unknown map cache record: " + std::to_string(static_cast<int>(record)));
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,147 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TrenchBroom_MapCache
+#define TrenchBroom_MapCache
+
+#include "Logger.h"
+#include "IO/NodeSerializer.h"
+#include "Model/MapFormat.h"
+
+#include <vecmath/forward.h>
+
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Model {
+        class WorldNode;
+    }
+
+    namespace IO {
+        class File;
+        class MapParser;
+        class ParserStatus;
+        class Path;
+
+        /**
+         * Writes the nodes passed to it in a compact binary format that can be replayed by MapCache. The records
+         * correspond one to one to what MapFileSerializer writes, but all values are stored verbatim, including the
+         * file positions of the nodes and faces.
+         */
+        class MapCacheSerializer : public NodeSerializer {
+        private:
+            std::ostream& m_stream;
+        public:
+            explicit MapCacheSerializer(std::ostream& stream);
+        private:
+            void doBeginFile() override;
+            void doEndFile() override;
+
+            void doBeginEntity(const Model::Node* node) override;
+            void doEndEntity(const Model::Node* node) override;
+            void doEntityAttribute(const Model::EntityAttribute& attribute) override;
+            void doBeginBrush(const Model::BrushNode* brush) override;
+            void doEndBrush(const Model::BrushNode* brush) override;
+            void doBrushFace(const Model::BrushFace& face) override;
+        };
+
+        /**
+         * A binary cache of a parsed map file that is stored next to the map file. The cache records the entities,
+         * attributes and brush faces of the map exactly as they were parsed, and it is only valid for the map file
+         * contents, game and map format it was created for.
+         *
+         * Loading a map from its cache skips tokenizing and parsing the map file. The cached records are replayed
+         * into a map parser, so that the resulting nodes are identical to those created when parsing the map file.
+         * The messages that were logged while parsing the map file are stored with the cache so that they can be
+         * logged again when the map is loaded from the cache.
+         */
+        class MapCache {
+        public:
+            using Key = std::uint64_t;
+            static const std::uint32_t Version;
+
+            struct LogMessage {
+                LogLevel level;
+                std::string message;
+            };
+        private:
+            std::shared_ptr<File> m_file;
+            std::vector<LogMessage> m_messages;
+            size_t m_recordsPosition;
+        public:
+            /**
+             * Returns the path of the cache file for the map file with the given path.
+             */
+            static Path cachePath(const Path& mapPath);
+
+            /**
+             * Computes the key of the cache for the given map file contents, game and map format.
+             */
+            static Key computeKey(const char* begin, const char* end, const std::string& gameName, Model::MapFormat format);
+
+            /**
+             * Writes the given world and the messages logged while parsing it to a cache file with the given path and
+             * key. The cache is written to a temporary file first, which then replaces the cache file, so that an
+             * interrupted write never leaves a partial cache file behind.
+             *
+             * @throw FileSystemException if the cache file cannot be written
+             */
+            static void write(const Model::WorldNode& world, const std::vector<LogMessage>& messages, Key key, const Path& path);
+
+            /**
+             * Opens the cache file with the given path if it exists and if it was written with the given key and the
+             * current cache version.
+             *
+             * @return the opened cache or an empty optional if there is no valid cache file
+             */
+            static std::optional<MapCache> open(const Path& path, Key key);
+
+            /**
+             * Reads the world from the given map file contents. If the cache file with the given path is valid for the
+             * contents, game and map format, the world is read from the cache and the messages stored in the cache are
+             * logged. Otherwise, the map file is parsed and the cache file is written. Either way, every message is
+             * logged once and in the order in which it was logged while parsing the map file.
+             *
+             * If the cache file cannot be read or written, a warning is logged and the world is read from the map file.
+             */
+            static std::unique_ptr<Model::WorldNode> readWorld(const char* begin, const char* end, const std::string& gameName, Model::MapFormat format, const vm::bbox3& worldBounds, const Path& path, Logger& logger);
+        private:
+            MapCache(std::shared_ptr<File> file, std::vector<LogMessage> messages, size_t recordsPosition);
+        public:
+            /**
+             * Returns the messages that were logged while parsing the map file this cache was created for.
+             */
+            const std::vector<LogMessage>& messages() const;
+
+            /**
+             * Replays the cached records into the given parser.
+             *
+             * @throw ReaderException if the cache file is corrupt
+             */
+            void replay(Model::MapFormat format, MapParser& parser, ParserStatus& status) const;
+        };
+    }
+}
+
+#endif /* defined(TrenchBroom_MapCache) */
@@ -37,9 +37,13 @@ namespace TrenchBroom {
     }
 
     namespace IO {
+        class MapCache;
         class ParserStatus;
 
         class MapParser {
+        private:
+            // replays cached parser events
+            friend class MapCache;
         protected:
             class ExtraAttribute {
             public:
@@ -19,7 +19,11 @@
 
 #include "MapReader.h"
 
+#include "Exceptions.h"
+#include "Logger.h"
+#include "IO/MapCache.h"
 #include "IO/ParserStatus.h"
+#include "Model/Brush.h"
 #include "Model/BrushNode.h"
 #include "Model/BrushFace.h"
 #include "Model/EntityNode.h"
@@ -29,16 +33,55 @@
 #include "Model/ModelFactory.h"
 
 #include <kdl/map_utils.h>
+#include <kdl/parallel.h>
 #include <kdl/string_format.h>
 #include <kdl/string_utils.h>
 #include <kdl/vector_utils.h>
 
 #include <map>
+#include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
 namespace TrenchBroom {
     namespace IO {
+        namespace {
+            /**
+             * Records the messages logged while parsing instead of logging them, tagging each with the current
+             * position given by the given function.
+             */
+            template <typename Message>
+            class DeferringParserStatus : public ParserStatus {
+            private:
+                ParserStatus& m_status;
+                std::function<size_t()> m_position;
+                std::vector<Message> m_messages;
+            public:
+                DeferringParserStatus(ParserStatus& status, std::function<size_t()> position) :
+                ParserStatus(nullLogger(), ""),
+                m_status(status),
+                m_position(std::move(position)) {}
+
+                const std::vector<Message>& messages() const {
+                    return m_messages;
+                }
+            private:
+                static Logger& nullLogger() {
+                    static NullLogger logger;
+                    return logger;
+                }
+
+                void doProgress(const double progress) override {
+                    m_status.progress(progress);
+                }
+
+                void doLog(const LogLevel level, const std::string& str) override {
+                    m_messages.push_back(Message{ m_position(), level, str });
+                }
+            };
+        }
+
         MapReader::ParentInfo MapReader::ParentInfo::layer(const Model::IdType layerId) {
             return ParentInfo(Type_Layer, layerId);
         }
@@ -63,27 +106,37 @@ namespace TrenchBroom {
             return m_id;
         }
 
-        MapReader::MapReader(const char* begin, const char* end) :
+        MapReader::MapReader(const char* begin, const char* end, const BrushCreation brushCreation) :
         StandardMapParser(begin, end),
+        m_brushCreation(brushCreation),
         m_factory(nullptr),
         m_brushParent(nullptr),
         m_currentNode(nullptr) {}
 
-        MapReader::MapReader(const std::string& str) :
+        MapReader::MapReader(const std::string& str, const BrushCreation brushCreation) :
         StandardMapParser(str),
+        m_brushCreation(brushCreation),
         m_factory(nullptr),
         m_brushParent(nullptr),
         m_currentNode(nullptr) {}
 
+        MapReader::~MapReader() = default;
+
         void MapReader::readEntities(Model::MapFormat format, const vm::bbox3& worldBounds, ParserStatus& status) {
             m_worldBounds = worldBounds;
-            parseEntities(format, status);
+            parseAndCreateChildren(status, [&](ParserStatus& parserStatus) { parseEntities(format, parserStatus); });
+            resolveNodes(status);
+        }
+
+        void MapReader::readEntities(const MapCache& cache, Model::MapFormat format, const vm::bbox3& worldBounds, ParserStatus& status) {
+            m_worldBounds = worldBounds;
+            parseAndCreateChildren(status, [&](ParserStatus& parserStatus) { cache.replay(format, *this, parserStatus); });
             resolveNodes(status);
         }
 
         void MapReader::readBrushes(Model::MapFormat format, const vm::bbox3& worldBounds, ParserStatus& status) {
             m_worldBounds = worldBounds;
-            parseBrushes(format, status);
+            parseAndCreateChildren(status, [&](ParserStatus& parserStatus) { parseBrushes(format, parserStatus); });
         }
 
         void MapReader::readBrushFaces(Model::MapFormat format, const vm::bbox3& worldBounds, ParserStatus& status) {
@@ -226,18 +279,112 @@ namespace TrenchBroom {
         }
 
         void MapReader::createBrush(const size_t startLine, const size_t lineCount, const ExtraAttributes& extraAttributes, ParserStatus& status) {
-            try {
-                Model::BrushNode* brush = m_factory->createBrush(Model::Brush(m_worldBounds, std::move(m_faces)));
-                setFilePosition(brush, startLine, lineCount);
-                setExtraAttributes(brush, extraAttributes);
+            if (m_brushCreation == BrushCreation::Parallel) {
+                m_deferredChildren.push_back(DeferredChild{m_brushParent, nullptr, std::move(m_faces), startLine, lineCount, extraAttributes});
+                m_faces.clear();
+                return;
+            }
 
-                onBrush(m_brushParent, brush, status);
+            try {
+                addBrush(m_brushParent, Model::Brush(m_worldBounds, std::move(m_faces)), startLine, lineCount, extraAttributes, status);
                 m_faces.clear();
             } catch (GeometryException& e) {
                 status.error(startLine, kdl::str_to_string("Skipping brush: ", e.what()));
                 m_faces.clear(); // the faces will have been deleted by the brush's constructor
             }
+        }
+
+        void MapReader::addBrush(Model::Node* parent, Model::Brush brush, const size_t startLine, const size_t lineCount, const ExtraAttributes& extraAttributes, ParserStatus& status) {
+            auto brushNode = std::unique_ptr<Model::BrushNode>(m_factory->createBrush(std::move(brush)));
+            setFilePosition(brushNode.get(), startLine, lineCount);
+            setExtraAttributes(brushNode.get(), extraAttributes);
+
+            onBrush(parent, brushNode.release(), status);
+        }
+
+        /**
+         * Passes the given node to the subclass. If brush creation is deferred, this is deferred as well so that the
+         * nodes are passed to the subclass in file order.
+         */
+        void MapReader::addNode(Model::Node* parent, Model::Node* node, ParserStatus& status) {
+            if (m_brushCreation == BrushCreation::Parallel) {
+                m_deferredChildren.push_back(DeferredChild{parent, std::unique_ptr<Model::Node>(node), {}, 0u, 0u, {}});
+            } else {
+                onNode(parent, node, status);
+            }
+        }
+
+        /**
+         * Calls the given parse function. In parallel brush creation mode, the messages logged while parsing are
+         * deferred until the brush geometry has been computed, and are then reported together with the errors of the
+         * brushes in file order.
+         */
+        void MapReader::parseAndCreateChildren(ParserStatus& status, const std::function<void(ParserStatus&)>& parse) {
+            if (m_brushCreation != BrushCreation::Parallel) {
+                parse(status);
+                return;
+            }
+
+            DeferringParserStatus<DeferredMessage> deferringStatus(status, [&]() { return m_deferredChildren.size(); });
+            try {
+                parse(deferringStatus);
+            } catch (...) {
+                for (const auto& message : deferringStatus.messages()) {
+                    status.forward(message.level, message.str);
+                }
+                throw;
+            }
+
+            createDeferredChildren(status, deferringStatus.messages());
+        }
+
+        /**
+         * Computes the geometry of all deferred brushes in parallel and then passes the deferred nodes and brushes to
+         * the subclass in file order; called after the whole map is parsed. The given messages are reported in between
+         * so that they appear at the same position as in immediate mode.
+         */
+        void MapReader::createDeferredChildren(ParserStatus& status, const std::vector<DeferredMessage>& messages) {
+            std::vector<std::optional<Model::Brush>> brushes(m_deferredChildren.size());
+            std::vector<std::string> errors(m_deferredChildren.size());
+
+            kdl::parallel_for(m_deferredChildren.size(), [&](const size_t i) {
+                auto& child = m_deferredChildren[i];
+                if (child.node == nullptr) {
+                    try {
+                        brushes[i] = Model::Brush(m_worldBounds, std::move(child.faces));
+                    } catch (GeometryException& e) {
+                        errors[i] = e.what();
+                    }
+                }
+            });
+
+            auto deferredChildren = std::move(m_deferredChildren);
+            m_deferredChildren.clear();
+
+            auto message = std::begin(messages);
+            const auto reportMessages = [&](const size_t position) {
+                while (message != std::end(messages) && message->position <= position) {
+                    status.forward(message->level, message->str);
+                    ++message;
+                }
+            };
+
+            for (size_t i = 0u; i < deferredChildren.size(); ++i) {
+                // report the messages that were logged before this child was deferred
+                reportMessages(i);
+
+                auto& child = deferredChildren[i];
+                if (child.node != nullptr) {
+                    // the subclass takes ownership of the node; the remaining nodes are deleted if it throws
+                    onNode(child.parent, child.node.release(), status);
+                } else if (brushes[i].has_value()) {
+                    addBrush(child.parent, std::move(*brushes[i]), child.startLine, child.lineCount, child.extraAttributes, status);
+                } else {
+                    status.error(child.startLine, kdl::str_to_string("Skipping brush: ", errors[i]));
+                }
+            }
 
+            reportMessages(deferredChildren.size());
         }
 
         MapReader::ParentInfo::Type MapReader::storeNode(Model::Node* node, const std::vector<Model::EntityAttribute>& attributes, ParserStatus& status) {
@@ -249,7 +396,7 @@ namespace TrenchBroom {
                     Model::LayerNode* layer = kdl::map_find_or_default(m_layers, layerId,
                         static_cast<Model::LayerNode*>(nullptr));
                     if (layer != nullptr)
-                        onNode(layer, node, status);
+                        addNode(layer, node, status);
                     else
                         m_unresolvedNodes.push_back(std::make_pair(node, ParentInfo::layer(layerId)));
                     return ParentInfo::Type_Layer;
@@ -265,7 +412,7 @@ namespace TrenchBroom {
                         Model::GroupNode* group = kdl::map_find_or_default(m_groups, groupId,
                             static_cast<Model::GroupNode*>(nullptr));
                         if (group != nullptr)
-                            onNode(group, node, status);
+                            addNode(group, node, status);
                         else
                             m_unresolvedNodes.push_back(std::make_pair(node, ParentInfo::group(groupId)));
                         return ParentInfo::Type_Group;
@@ -275,7 +422,7 @@ namespace TrenchBroom {
                 }
             }
 
-            onNode(nullptr, node, status);
+            addNode(nullptr, node, status);
             return ParentInfo::Type_None;
         }
 
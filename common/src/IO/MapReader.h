@@ -28,13 +28,18 @@
 #include <vecmath/forward.h>
 #include <vecmath/bbox.h>
 
+#include <functional>
 #include <map>
+#include <memory>
 #include <string>
 #include <vector>
 
 namespace TrenchBroom {
+    enum class LogLevel;
+
     namespace Model {
         class AttributableNode;
+        class Brush;
         class BrushNode;
         class EntityAttribute;
         class GroupNode;
@@ -44,9 +49,26 @@ namespace TrenchBroom {
     }
 
     namespace IO {
+        class MapCache;
         class ParserStatus;
 
         class MapReader : public StandardMapParser {
+        public:
+            /**
+             * Controls when the geometry of the parsed brushes is computed.
+             */
+            enum class BrushCreation {
+                /**
+                 * Every brush is created on the parser thread as soon as its faces have been parsed.
+                 */
+                Immediate,
+                /**
+                 * The parser only collects the faces of every brush. Once parsing is done, the brush geometries are
+                 * computed by a pool of worker threads, and the nodes are then passed to the subclass in file order.
+                 * The result is identical to that of the immediate mode, and errors are reported in file order, too.
+                 */
+                Parallel
+            };
         protected:
             class ParentInfo {
             public:
@@ -82,7 +104,32 @@ namespace TrenchBroom {
             using NodeParentPair = std::pair<Model::Node*, ParentInfo>;
             using NodeParentList = std::vector<NodeParentPair>;
 
+            /**
+             * A node or a brush that is passed to the subclass only after all brush geometry has been computed. If
+             * node is null, then this represents a brush that is to be created from the given faces.
+             */
+            struct DeferredChild {
+                Model::Node* parent;
+                std::unique_ptr<Model::Node> node;
+                std::vector<Model::BrushFace> faces;
+                size_t startLine;
+                size_t lineCount;
+                ExtraAttributes extraAttributes;
+            };
+
+            /**
+             * A message that was logged while parsing in parallel brush creation mode. It is reported only once the
+             * geometry of the brushes that precede it has been computed, so that all messages appear in file order.
+             * The position is the number of children that were deferred before the message was logged.
+             */
+            struct DeferredMessage {
+                size_t position;
+                LogLevel level;
+                std::string str;
+            };
+
             vm::bbox3 m_worldBounds;
+            BrushCreation m_brushCreation;
             Model::ModelFactory* m_factory;
 
             Model::Node* m_brushParent;
@@ -92,11 +139,16 @@ namespace TrenchBroom {
             LayerMap m_layers;
             GroupMap m_groups;
             NodeParentList m_unresolvedNodes;
+            std::vector<DeferredChild> m_deferredChildren;
+        protected:
+            MapReader(const char* begin, const char* end, BrushCreation brushCreation = BrushCreation::Immediate);
+            explicit MapReader(const std::string& str, BrushCreation brushCreation = BrushCreation::Immediate);
+        public:
+            ~MapReader() override;
         protected:
-            MapReader(const char* begin, const char* end);
-            explicit MapReader(const std::string& str);
 
             void readEntities(Model::MapFormat format, const vm::bbox3& worldBounds, ParserStatus& status);
+            void readEntities(const MapCache& cache, Model::MapFormat format, const vm::bbox3& worldBounds, ParserStatus& status);
             void readBrushes(Model::MapFormat format, const vm::bbox3& worldBounds, ParserStatus& status);
             void readBrushFaces(Model::MapFormat format, const vm::bbox3& worldBounds, ParserStatus& status);
         private: // implement MapParser interface
@@ -111,6 +163,10 @@ namespace TrenchBroom {
             void createGroup(size_t line, const std::vector<Model::EntityAttribute>& attributes, const ExtraAttributes& extraAttributes, ParserStatus& status);
             void createEntity(size_t line, const std::vector<Model::EntityAttribute>& attributes, const ExtraAttributes& extraAttributes, ParserStatus& status);
             void createBrush(size_t startLine, size_t lineCount, const ExtraAttributes& extraAttributes, ParserStatus& status);
+            void addBrush(Model::Node* parent, Model::Brush brush, size_t startLine, size_t lineCount, const ExtraAttributes& extraAttributes, ParserStatus& status);
+            void addNode(Model::Node* parent, Model::Node* node, ParserStatus& status);
+            void parseAndCreateChildren(ParserStatus& status, const std::function<void(ParserStatus&)>& parse);
+            void createDeferredChildren(ParserStatus& status, const std::vector<DeferredMessage>& messages);
 
             ParentInfo::Type storeNode(Model::Node* node, const std::vector<Model::EntityAttribute>& attributes, ParserStatus& status);
             void stripParentAttributes(Model::AttributableNode* attributable, ParentInfo::Type parentType);
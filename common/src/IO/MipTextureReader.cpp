@@ -58,6 +58,10 @@ namespace TrenchBroom {
             }
         }
 
+        bool MipTextureReader::doCanReadConcurrently() const {
+            return true;
+        }
+
         Assets::Texture* MipTextureReader::doReadTexture(std::shared_ptr<File> file) const {
             static const size_t MipLevels = 4;
 
@@ -55,6 +55,12 @@ namespace TrenchBroom {
             void warn(const std::string& str);
             void error(const std::string& str);
             [[noreturn]] void errorAndThrow(const std::string& str);
+
+            /**
+             * Logs a message that was recorded by another parser status, e.g. to report messages in a different order
+             * than they were logged in. The message already contains its position, so only the prefix is added.
+             */
+            void forward(LogLevel level, const std::string& str);
         private:
             void log(LogLevel level, size_t line, size_t column, const std::string& str);
             std::string buildMessage(size_t line, size_t column, const std::string& str) const;
@@ -26,11 +26,21 @@
 #include <cerrno>
 #include <cstring>
 #include <functional>
+#include <mutex>
 #include <string>
 #include <vector>
 
 namespace TrenchBroom {
     namespace IO {
+        /**
+         * Guards the positions of the C files that file sources read from. Archive entries are file sources over the
+         * archive's file, and they can be read on several threads at once, e.g. when loading textures or entity models.
+         */
+        static std::mutex& fileSourceMutex() {
+            static std::mutex mutex;
+            return mutex;
+        }
+
         Reader::Source::~Source() = default;
 
         size_t Reader::Source::size() const {
@@ -76,10 +86,8 @@ namespace TrenchBroom {
         m_length(length),
         m_position(0) {
             assert(m_file != nullptr);
-            std::rewind(m_file);
         }
 
-
         size_t Reader::FileSource::doGetSize() const {
             return m_length;
         }
@@ -89,9 +97,9 @@ namespace TrenchBroom {
         }
 
         void Reader::FileSource::doRead(char* val, const size_t size) {
-            // We might consider removing this check under the assumption that the file position is set in the constructor
-            // of this reader and that no other reader will access the file while this reader is in use. This may be a
-            // reasonable assumption, since we usually read files one by one.
+            // Another reader may have moved the file position since our last read. Only seek if necessary, since
+            // seeking discards the file's buffer.
+            std::lock_guard<std::mutex> lock(fileSourceMutex());
 
             const auto pos = std::ftell(m_file);
             if (pos < 0) {
@@ -117,18 +125,18 @@ namespace TrenchBroom {
         }
 
         std::tuple<const char*, const char*, std::unique_ptr<char[]>> Reader::FileSource::doBuffer() const {
-            std::fseek(m_file, static_cast<long>(m_offset), SEEK_SET);
-
             auto buffer = std::make_unique<char[]>(m_length);
+
+            std::lock_guard<std::mutex> lock(fileSourceMutex());
+            if (std::fseek(m_file, static_cast<long>(m_offset), SEEK_SET) != 0) {
+                throwError("fseek failed");
+            }
+
             const auto read = std::fread(buffer.get(), 1, m_length, m_file);
             if (read != m_length) {
                 throwError("fread failed");
             }
 
-            if (std::fseek(m_file, static_cast<long>(m_offset + m_position), SEEK_SET) != 0) {
-                throwError("fseek failed");
-            }
-
             const char* begin = buffer.get();
             const char* end = begin + m_length;
             return std::make_tuple(begin, end, std::move(buffer));
@@ -190,9 +198,14 @@ namespace TrenchBroom {
         Reader::~Reader() = default;
 
         Reader Reader::from(std::FILE* file) {
+            std::lock_guard<std::mutex> lock(fileSourceMutex());
             return Reader(std::make_unique<FileSource>(file, 0, fileSize(file)));
         }
 
+        Reader Reader::from(std::FILE* file, const size_t size) {
+            return Reader(std::make_unique<FileSource>(file, 0, size));
+        }
+
         Reader Reader::from(const char* begin, const char* end) {
             return Reader(std::make_unique<BufferSource>(begin, end));
         }
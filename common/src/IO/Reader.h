@@ -123,7 +123,8 @@ namespace TrenchBroom {
             /**
              * A reader source that reads directly from a file. Note that the seek position of the underlying C file
              * is kept in sync with this file source's position automatically, that is, two readers can read from the
-             * same underlying file without causing problems.
+             * same underlying file without causing problems. Seeking and reading happen under a lock shared by all file
+             * sources, so this also holds if the readers are used on different threads.
              */
             class FileSource : public Source {
             private:
@@ -211,6 +212,15 @@ namespace TrenchBroom {
              * @throw ReaderException if the reader cannot be created
              */
             static Reader from(std::FILE* file);
+            /**
+             * Creates a new reader that reads from the given file, which has the given size. Unlike the above, this
+             * does not touch the file position, so it is safe to use while other readers read the same file.
+             *
+             * @param file the file to read from
+             * @param size the size of the file
+             * @return the reader
+             */
+            static Reader from(std::FILE* file, size_t size);
             /**
              * Creates a new reader that reads from the given memory region.
              *
@@ -42,16 +42,27 @@ namespace TrenchBroom {
         std::unique_ptr<Assets::TextureCollection> TextureCollectionLoader::loadTextureCollection(const Path& path, const std::vector<std::string>& textureExtensions, const TextureReader& textureReader) {
             auto collection = std::make_unique<Assets::TextureCollection>(path);
 
-            for (const auto& file : doFindTextures(path, textureExtensions)) {
+            // the textures are decoded concurrently, but they are returned in the order of the files
+            collection->addTextures(textureReader.readTextures(findTextures(path, textureExtensions)));
+
+            return collection;
+        }
+
+        std::unique_ptr<Assets::TextureCollection> TextureCollectionLoader::loadLazyTextureCollection(const Path& path, const std::vector<std::string>& textureExtensions, std::shared_ptr<const TextureReader> textureReader) {
+            auto collection = std::make_unique<Assets::TextureCollection>(path);
+            collection->addTextures(TextureReader::readTexturesLazily(std::move(textureReader), findTextures(path, textureExtensions)));
+            return collection;
+        }
+
+        TextureCollectionLoader::FileList TextureCollectionLoader::findTextures(const Path& path, const std::vector<std::string>& textureExtensions) {
+            FileList result;
+            for (auto& file : doFindTextures(path, textureExtensions)) {
                 const auto name = file->path().lastComponent().deleteExtension().asString();
-                if (shouldExclude(name)) {
-                    continue;
+                if (!shouldExclude(name)) {
+                    result.push_back(std::move(file));
                 }
-                auto* texture = textureReader.readTexture(file);
-                collection->addTexture(texture);
             }
-
-            return collection;
+            return result;
         }
 
         bool TextureCollectionLoader::shouldExclude(const std::string& textureName) {
@@ -50,7 +50,14 @@ namespace TrenchBroom {
             virtual ~TextureCollectionLoader();
         public:
             std::unique_ptr<Assets::TextureCollection> loadTextureCollection(const Path& path, const std::vector<std::string>& textureExtensions, const TextureReader& textureReader);
+
+            /**
+             * Loads a texture collection whose textures decode their contents on demand, see
+             * TextureReader::readTexturesLazily.
+             */
+            std::unique_ptr<Assets::TextureCollection> loadLazyTextureCollection(const Path& path, const std::vector<std::string>& textureExtensions, std::shared_ptr<const TextureReader> textureReader);
         private:
+            FileList findTextures(const Path& path, const std::vector<std::string>& textureExtensions);
             bool shouldExclude(const std::string& textureName);
             virtual FileList doFindTextures(const Path& path, const std::vector<std::string>& extensions) = 0;
         };
@@ -24,9 +24,15 @@
 #include "Assets/TextureBuffer.h"
 #include "IO/File.h"
 #include "IO/FileSystem.h"
+#include "IO/Reader.h"
+#include "IO/ReaderException.h"
 #include "IO/ResourceUtils.h"
 
+#include <kdl/parallel.h>
+
 #include <algorithm>
+#include <string>
+#include <vector>
 
 namespace TrenchBroom {
     namespace IO {
@@ -96,6 +102,84 @@ namespace TrenchBroom {
             }
         }
 
+        std::vector<Assets::Texture*> TextureReader::readTextures(const std::vector<std::shared_ptr<File>>& files) const {
+            return readTextures(files, nullptr);
+        }
+
+        std::vector<Assets::Texture*> TextureReader::readTexturesLazily(std::shared_ptr<const TextureReader> reader, const std::vector<std::shared_ptr<File>>& files) {
+            return reader->readTextures(files, reader);
+        }
+
+        /**
+         * Reads the contents of the given file into memory.
+         */
+        static std::shared_ptr<File> readContents(const File& file) {
+            auto reader = file.reader();
+            const auto size = reader.size();
+            auto buffer = std::make_unique<char[]>(size);
+            reader.read(buffer.get(), size);
+            return std::make_shared<OwningBufferFile>(file.path(), std::move(buffer), size);
+        }
+
+        std::vector<Assets::Texture*> TextureReader::readTextures(const std::vector<std::shared_ptr<File>>& files, const std::shared_ptr<const TextureReader>& lazyReader) const {
+            std::vector<std::unique_ptr<Assets::Texture>> textures(files.size());
+            std::vector<std::string> errors(files.size());
+
+            // Only decoding happens on worker threads. The files are read on this thread beforehand, since reading
+            // from the file system is not necessarily thread safe, and the files are read in batches so that only a
+            // few of them are held in memory at once.
+            const auto threadCount = doCanReadConcurrently() ? kdl::parallel_default_thread_count() : size_t(1);
+            const auto batchSize = threadCount > 1u ? 16u * threadCount : files.size();
+
+            std::vector<std::shared_ptr<File>> contents(files.size());
+            for (size_t batchStart = 0u; batchStart < files.size(); batchStart += batchSize) {
+                const auto batchEnd = std::min(batchStart + batchSize, files.size());
+                for (size_t i = batchStart; i < batchEnd; ++i) {
+                    try {
+                        contents[i] = threadCount > 1u ? readContents(*files[i]) : files[i];
+                    } catch (const ReaderException& e) {
+                        errors[i] = e.what();
+                    }
+                }
+
+                kdl::parallel_for(batchEnd - batchStart, [&](const size_t j) {
+                    const auto i = batchStart + j;
+                    if (contents[i] == nullptr) {
+                        return;
+                    }
+
+                    try {
+                        textures[i] = std::unique_ptr<Assets::Texture>(doReadTexture(std::move(contents[i])));
+                        if (lazyReader != nullptr && !textures[i]->buffersIfUnprepared().empty()) {
+                            // discard the contents right away so that only a few textures are decoded at any time
+                            textures[i]->setBufferLoader([reader = lazyReader, file = files[i]]() {
+                                try {
+                                    auto texture = std::unique_ptr<Assets::Texture>(reader->doReadTexture(file));
+                                    return texture->releaseBuffers();
+                                } catch (const AssetException&) {
+                                    return Assets::TextureBufferList();
+                                }
+                            });
+                        }
+                    } catch (const AssetException& e) {
+                        errors[i] = e.what();
+                    }
+                }, threadCount);
+            }
+
+            std::vector<Assets::Texture*> result;
+            result.reserve(files.size());
+            for (size_t i = 0; i < files.size(); ++i) {
+                if (textures[i] == nullptr) {
+                    const auto& path = files[i]->path();
+                    m_logger.error() << "Could not read texture '" << path << "': " << errors[i];
+                    textures[i] = loadDefaultTexture(m_fs, m_logger, textureName(path));
+                }
+                result.push_back(textures[i].release());
+            }
+            return result;
+        }
+
         std::string TextureReader::textureName(const std::string& textureName, const Path& path) const {
             return m_nameStrategy->textureName(textureName, path);
         }
@@ -104,6 +188,10 @@ namespace TrenchBroom {
             return m_nameStrategy->textureName(path.lastComponent().asString(), path);
         }
 
+        bool TextureReader::doCanReadConcurrently() const {
+            return false;
+        }
+
         bool TextureReader::checkTextureDimensions(const size_t width, const size_t height) {
             return width <= 8192 && height <= 8192;
         }
@@ -24,6 +24,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace TrenchBroom {
     class Logger;
@@ -119,10 +120,37 @@ namespace TrenchBroom {
              * @return an Assets::Texture object allocated with new
              */
             Assets::Texture* readTexture(std::shared_ptr<File> file) const;
+
+            /**
+             * Loads a texture from each of the given files and returns them in the order of the given files. If this
+             * reader can decode textures concurrently, the files are decoded on worker threads. Errors are logged on
+             * the calling thread once all files have been decoded, and the default texture is returned for each file
+             * that could not be loaded.
+             *
+             * @param files the files containing the textures
+             * @return the Assets::Texture objects allocated with new
+             */
+            std::vector<Assets::Texture*> readTextures(const std::vector<std::shared_ptr<File>>& files) const;
+
+            /**
+             * Like readTextures, but returns lazy textures. Each texture is decoded once to determine its dimensions,
+             * type and average color, and its contents are discarded right away. The textures keep the given reader
+             * and their files to decode their contents again when they are activated, so the file system and logger
+             * passed to the reader must outlive them.
+             *
+             * Textures that cannot be loaded are replaced by the default texture, which is not lazy.
+             *
+             * @param reader the reader to decode the textures with
+             * @param files the files containing the textures
+             * @return the Assets::Texture objects allocated with new
+             */
+            static std::vector<Assets::Texture*> readTexturesLazily(std::shared_ptr<const TextureReader> reader, const std::vector<std::shared_ptr<File>>& files);
         protected:
             std::string textureName(const std::string& textureName, const Path& path) const;
             std::string textureName(const Path& path) const;
         private:
+            std::vector<Assets::Texture*> readTextures(const std::vector<std::shared_ptr<File>>& files, const std::shared_ptr<const TextureReader>& lazyReader) const;
+
             /**
              * Loads a texture and returns an Assets::Texture object allocated with new. Should not throw exceptions to
              * report errors loading textures except for unrecoverable errors (out of memory, bugs, etc.).
@@ -131,6 +159,13 @@ namespace TrenchBroom {
              * @return an Assets::Texture object allocated with new
              */
             virtual Assets::Texture* doReadTexture(std::shared_ptr<File> file) const = 0;
+
+            /**
+             * Indicates whether doReadTexture may be called from several threads at once. This is only the case if
+             * it decodes the given file without touching the file system, the logger or any other shared state. If so,
+             * the files are read into memory on the calling thread and only decoded on worker threads.
+             */
+            virtual bool doCanReadConcurrently() const;
         protected:
             static bool checkTextureDimensions(size_t width, size_t height);
         public:
@@ -21,12 +21,87 @@
 #define TrenchBroom_Token
 
 #include <cassert>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
 #include <string>
 
 #include <kdl/string_utils.h>
 
 namespace TrenchBroom {
     namespace IO {
+        /**
+         * Parses the given range as a double value without allocating memory. Integers with at most 15 digits are
+         * converted directly, everything else is passed to std::strtod via a stack buffer. Yields the same value as
+         * kdl::str_to_double(std::string(begin, end)).value_or(0.0).
+         */
+        inline double parseDouble(const char* begin, const char* end) {
+            const char* c = begin;
+            const bool negative = c != end && *c == '-';
+            if (c != end && (*c == '-' || *c == '+')) {
+                ++c;
+            }
+
+            const char* digitsBegin = c;
+            long long integer = 0;
+            while (c != end && *c >= '0' && *c <= '9' && c - digitsBegin < 15) {
+                integer = integer * 10 + (*c - '0');
+                ++c;
+            }
+
+            if (c == end && c != digitsBegin) {
+                const auto value = static_cast<double>(integer);
+                return negative ? -value : value;
+            }
+
+            const auto length = static_cast<size_t>(end - begin);
+            char buffer[64];
+            if (length >= sizeof(buffer)) {
+                return kdl::str_to_double(std::string(begin, end)).value_or(0.0);
+            }
+
+            std::memcpy(buffer, begin, length);
+            buffer[length] = 0;
+
+            char* parseEnd = nullptr;
+            errno = 0;
+            const auto value = std::strtod(buffer, &parseEnd);
+            if (parseEnd == buffer || errno == ERANGE) {
+                return 0.0;
+            }
+            return value;
+        }
+
+        /**
+         * Parses the given range as a long value without allocating memory, see parseDouble. Yields the same value as
+         * kdl::str_to_long(std::string(begin, end)).value_or(0l).
+         */
+        inline long parseLong(const char* begin, const char* end) {
+            const char* c = begin;
+            const bool negative = c != end && *c == '-';
+            if (c != end && (*c == '-' || *c == '+')) {
+                ++c;
+            }
+
+            const char* digitsBegin = c;
+            long long value = 0;
+            while (c != end && *c >= '0' && *c <= '9' && c - digitsBegin < 18) {
+                value = value * 10 + (*c - '0');
+                ++c;
+            }
+
+            if (c == end && c != digitsBegin) {
+                value = negative ? -value : value;
+                if (value < std::numeric_limits<long>::min() || value > std::numeric_limits<long>::max()) {
+                    return 0l;
+                }
+                return static_cast<long>(value);
+            }
+
+            return kdl::str_to_long(std::string(begin, end)).value_or(0l);
+        }
+
         template <typename Type>
         class TokenTemplate {
         private:
@@ -93,12 +168,12 @@ namespace TrenchBroom {
 
             template <typename T>
             T toFloat() const {
-                return static_cast<T>(kdl::str_to_double(std::string(m_begin, m_end)).value_or(0.0));
+                return static_cast<T>(parseDouble(m_begin, m_end));
             }
 
             template <typename T>
             T toInteger() const {
-                return static_cast<T>(kdl::str_to_long(std::string(m_begin, m_end)).value_or(0l));
+                return static_cast<T>(parseLong(m_begin, m_end));
             }
         };
     }
@@ -24,6 +24,7 @@
 
 #include <kdl/string_format.h>
 
+#include <cassert>
 #include <string>
 
 namespace TrenchBroom {
@@ -138,6 +139,16 @@ namespace TrenchBroom {
             ++m_cur;
         }
 
+        void TokenizerState::advanceWithinLine(const size_t offset) {
+            assert(m_cur + offset <= m_end);
+            for (size_t i = 0; i < offset; ++i) {
+                assert(m_cur[i] != '\n' && m_cur[i] != '\r');
+                m_escaped = m_cur[i] == m_escapeChar && !m_escaped;
+            }
+            m_cur += offset;
+            m_column += offset;
+        }
+
         void TokenizerState::reset() {
             m_cur = m_begin;
             m_line = 1;
@@ -151,12 +162,15 @@ namespace TrenchBroom {
             }
         }
 
-        TokenizerState TokenizerState::snapshot() const {
-            return TokenizerState(*this);
+        TokenizerState::Snapshot TokenizerState::snapshot() const {
+            return Snapshot{m_cur, m_line, m_column, m_escaped};
         }
 
-        void TokenizerState::restore(const TokenizerState& snapshot) {
-            *this = snapshot;
+        void TokenizerState::restore(const Snapshot& snapshot) {
+            m_cur = snapshot.cur;
+            m_line = snapshot.line;
+            m_column = snapshot.column;
+            m_escaped = snapshot.escaped;
         }
     }
 }
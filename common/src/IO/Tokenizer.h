@@ -28,6 +28,17 @@
 namespace TrenchBroom {
     namespace IO {
         class TokenizerState {
+        public:
+            /**
+             * The mutable part of the tokenizer state. Snapshots are cheap to take and to restore because they don't
+             * copy the buffer bounds or the escape settings.
+             */
+            struct Snapshot {
+                const char* cur;
+                size_t line;
+                size_t column;
+                bool escaped;
+            };
         private:
             const char* m_begin;
             const char* m_cur;
@@ -65,12 +76,17 @@ namespace TrenchBroom {
 
             void advance(size_t offset);
             void advance();
+            /**
+             * Advances by the given number of characters, none of which may be a line break. This is faster than
+             * advance(offset) because it does not need to track line numbers.
+             */
+            void advanceWithinLine(size_t offset);
             void reset();
 
             void errorIfEof() const;
 
-            TokenizerState snapshot() const;
-            void restore(const TokenizerState& snapshot);
+            Snapshot snapshot() const;
+            void restore(const Snapshot& snapshot);
         };
 
         template <typename TokenType>
@@ -82,15 +98,15 @@ namespace TrenchBroom {
 
             class SaveState {
             private:
-                StatePtr m_state;
-                TokenizerState m_snapshot;
+                TokenizerState& m_state;
+                TokenizerState::Snapshot m_snapshot;
             public:
-                explicit SaveState(StatePtr state) :
+                explicit SaveState(TokenizerState& state) :
                 m_state(state),
-                m_snapshot(m_state->snapshot()) {}
+                m_snapshot(m_state.snapshot()) {}
 
                 ~SaveState() {
-                    m_state->restore(m_snapshot);
+                    m_state.restore(m_snapshot);
                 }
             };
 
@@ -127,7 +143,7 @@ namespace TrenchBroom {
             }
 
             Token peekToken(const TokenType skipTokens = 0u) {
-                SaveState oldState(m_state);
+                SaveState oldState(*m_state);
                 return nextToken(skipTokens);
             }
 
@@ -200,7 +216,7 @@ namespace TrenchBroom {
                 return m_state->length();
             }
         public:
-            TokenizerState snapshot() const {
+            TokenizerState::Snapshot snapshot() const {
                 return m_state->snapshot();
             }
 
@@ -208,7 +224,7 @@ namespace TrenchBroom {
                 m_state.reset(m_state->clone(begin, end));
             }
 
-            void restore(const TokenizerState& snapshot) {
+            void restore(const TokenizerState::Snapshot& snapshot) {
                 m_state->restore(snapshot);
             }
         protected:
@@ -256,63 +272,69 @@ namespace TrenchBroom {
                 return m_state->escaped();
             }
 
+            /**
+             * Scans an integer starting at the current position. The characters are examined without changing the
+             * state, which is only advanced if an integer followed by a delimiter or the end of the input was found.
+             */
             const char* readInteger(const std::string& delims) {
-                if (curChar() != '+' && curChar() != '-' && !isDigit(curChar())) {
+                const char* c = curPos();
+                const char* e = m_state->end();
+                if (c == e || (*c != '+' && *c != '-' && !isDigit(*c))) {
                     return nullptr;
                 }
 
-                const auto previousState = *m_state;
-                if (curChar() == '+' || curChar() == '-') {
-                    advance();
+                if (*c == '+' || *c == '-') {
+                    ++c;
                 }
-                while (!eof() && isDigit(curChar())) {
-                    advance();
-                }
-                if (eof() || isAnyOf(curChar(), delims)) {
+                c = scanDigits(c, e);
+
+                if (c == e || isAnyOf(*c, delims)) {
+                    m_state->advanceWithinLine(static_cast<size_t>(c - curPos()));
                     return curPos();
                 }
 
-                *m_state = previousState;
                 return nullptr;
             }
 
+            /**
+             * Scans a decimal number starting at the current position, see readInteger.
+             */
             const char* readDecimal(const std::string& delims) {
-                if (curChar() != '+' && curChar() != '-' && curChar() != '.' && !isDigit(curChar())) {
+                const char* c = curPos();
+                const char* e = m_state->end();
+                if (c == e || (*c != '+' && *c != '-' && *c != '.' && !isDigit(*c))) {
                     return nullptr;
                 }
 
-                const auto previousState = *m_state;
-                if (curChar() != '.') {
-                    advance();
-                    readDigits();
+                if (*c != '.') {
+                    c = scanDigits(c + 1, e);
                 }
 
-                if (curChar() == '.') {
-                    advance();
-                    readDigits();
+                if (c != e && *c == '.') {
+                    c = scanDigits(c + 1, e);
                 }
 
-                if (curChar() == 'e') {
-                    advance();
-                    if (curChar() == '+' || curChar() == '-' || isDigit(curChar())) {
-                        advance();
-                        readDigits();
+                if (c != e && *c == 'e') {
+                    ++c;
+                    if (c != e && (*c == '+' || *c == '-' || isDigit(*c))) {
+                        c = scanDigits(c + 1, e);
                     }
                 }
 
-                if (eof() || isAnyOf(curChar(), delims)) {
+                if (c == e || isAnyOf(*c, delims)) {
+                    m_state->advanceWithinLine(static_cast<size_t>(c - curPos()));
                     return curPos();
                 }
 
-                *m_state = previousState;
                 return nullptr;
             }
 
         private:
-            void readDigits() {
-                while (!eof() && isDigit(curChar())) {
-                    advance();
+            const char* scanDigits(const char* c, const char* e) const {
+                while (c != e && isDigit(*c)) {
+                    ++c;
                 }
+                return c;
             }
         protected:
             const char* readUntil(const std::string& delims) {
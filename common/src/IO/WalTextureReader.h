@@ -36,11 +36,12 @@ namespace TrenchBroom {
 
         class WalTextureReader : public TextureReader {
         private:
-            mutable Assets::Palette m_palette;
+            Assets::Palette m_palette;
         public:
             WalTextureReader(const NameStrategy& nameStrategy, const FileSystem& fs, Logger& logger, const Assets::Palette& palette = Assets::Palette());
         private:
             Assets::Texture* doReadTexture(std::shared_ptr<File> file) const override;
+            bool doCanReadConcurrently() const override;
             Assets::Texture* readQ2Wal(Reader& reader, const Path& path) const;
             Assets::Texture* readDkWal(Reader& reader, const Path& path) const;
             size_t readMipOffsets(size_t maxMipLevels, size_t offsets[], size_t width, size_t height, Reader& reader) const;
@@ -33,14 +33,23 @@
 
 namespace TrenchBroom {
     namespace IO {
-        WorldReader::WorldReader(const char* begin, const char* end) :
-        MapReader(begin, end) {}
+        WorldReader::WorldReader(const char* begin, const char* end, const BrushCreation brushCreation) :
+        MapReader(begin, end, brushCreation) {}
 
-        WorldReader::WorldReader(const std::string& str) :
-        MapReader(str) {}
+        WorldReader::WorldReader(const std::string& str, const BrushCreation brushCreation) :
+        MapReader(str, brushCreation) {}
 
         std::unique_ptr<Model::WorldNode> WorldReader::read(Model::MapFormat format, const vm::bbox3& worldBounds, ParserStatus& status) {
             readEntities(format, worldBounds, status);
+            return finishWorld(status);
+        }
+
+        std::unique_ptr<Model::WorldNode> WorldReader::read(const MapCache& cache, Model::MapFormat format, const vm::bbox3& worldBounds, ParserStatus& status) {
+            readEntities(cache, format, worldBounds, status);
+            return finishWorld(status);
+        }
+
+        std::unique_ptr<Model::WorldNode> WorldReader::finishWorld(ParserStatus& status) {
             sanitizeLayerSortIndicies(status);
             m_world->rebuildNodeTree();
             m_world->enableNodeTreeUpdates();
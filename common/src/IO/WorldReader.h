@@ -32,6 +32,7 @@ namespace TrenchBroom {
     }
 
     namespace IO {
+        class MapCache;
         class ParserStatus;
 
         /**
@@ -40,11 +41,20 @@ namespace TrenchBroom {
         class WorldReader : public MapReader {
             std::unique_ptr<Model::WorldNode> m_world;
         public:
-            WorldReader(const char* begin, const char* end);
-            explicit WorldReader(const std::string& str);
+            WorldReader(const char* begin, const char* end, BrushCreation brushCreation = BrushCreation::Parallel);
+            explicit WorldReader(const std::string& str, BrushCreation brushCreation = BrushCreation::Parallel);
 
             std::unique_ptr<Model::WorldNode> read(Model::MapFormat format, const vm::bbox3& worldBounds, ParserStatus& status);
-        private:            
+
+            /**
+             * Creates the world from the given cache instead of parsing the map file. The resulting world is identical
+             * to the one returned by read() for the map file the cache was created from.
+             *
+             * @throw ReaderException if the cache is corrupt
+             */
+            std::unique_ptr<Model::WorldNode> read(const MapCache& cache, Model::MapFormat format, const vm::bbox3& worldBounds, ParserStatus& status);
+        private:
+            std::unique_ptr<Model::WorldNode> finishWorld(ParserStatus& status);
             void sanitizeLayerSortIndicies(ParserStatus& status);            
         private: // implement MapReader interface
             Model::ModelFactory& initialize(Model::MapFormat format) override;
@@ -34,6 +34,8 @@ namespace TrenchBroom {
         m_fileIndex(fileIndex) {}
 
         std::shared_ptr<File> ZipFileSystem::ZipCompressedFile::doOpen() const {
+            std::lock_guard<std::mutex> lock(m_owner->m_archiveMutex);
+
             const auto path = Path(m_owner->filename(m_fileIndex));
 
             mz_zip_archive_file_stat stat;
@@ -23,6 +23,7 @@
 #include "IO/ImageFileSystem.h"
 
 #include <memory>
+#include <mutex>
 
 #include <miniz/miniz.h>
 
@@ -33,6 +34,12 @@ namespace TrenchBroom {
         class ZipFileSystem : public ImageFileSystem {
         private:
             mz_zip_archive m_archive;
+            /**
+             * Guards the archive, which keeps state while extracting files and reads the archive's C file directly,
+             * bypassing the lock that file sources use. Entity models are loaded on worker threads while the main
+             * thread loads textures from the same file system.
+             */
+            std::mutex m_archiveMutex;
         private:
             class ZipCompressedFile : public FileEntry {
             private:
@@ -40,6 +40,7 @@
 #include <vecmath/util.h>
 
 #include <algorithm> // for std::remove
+#include <cmath>
 #include <iterator>
 #include <set>
 #include <string>
@@ -64,16 +65,7 @@ namespace TrenchBroom {
 
         Brush::Brush(const Brush& other) :
         m_faces(other.m_faces),
-        m_geometry(other.m_geometry ? std::make_unique<BrushGeometry>(*other.m_geometry, CopyCallback()) : nullptr) {
-            if (m_geometry) {
-                for (BrushFaceGeometry* faceGeometry : m_geometry->faces()) {
-                    if (const auto faceIndex = faceGeometry->payload()) {
-                        BrushFace& face = m_faces[*faceIndex];
-                        face.setGeometry(faceGeometry);
-                    }
-                }
-            }
-        }
+        m_geometry(other.m_geometry) {}
 
         Brush::Brush(Brush&& other) noexcept :
         m_faces(std::move(other.m_faces)),
@@ -97,7 +89,7 @@ namespace TrenchBroom {
             // First, add all faces to the brush geometry
             BrushFace::sortFaces(m_faces);
             
-            auto geometry = std::make_unique<BrushGeometry>(worldBounds);
+            auto geometry = std::make_shared<BrushGeometry>(worldBounds);
             
             for (size_t i = 0u; i < m_faces.size(); ++i) {
                 BrushFace& face = m_faces[i];
@@ -135,12 +127,32 @@ namespace TrenchBroom {
             
             assert(checkFaceLinks());
         }
+
+        void Brush::detachGeometry() {
+            if (m_geometry == nullptr || m_geometry.use_count() == 1) {
+                return;
+            }
+
+            m_geometry = std::make_shared<BrushGeometry>(*m_geometry, CopyCallback());
+            for (BrushFaceGeometry* faceGeometry : m_geometry->faces()) {
+                if (const auto faceIndex = faceGeometry->payload()) {
+                    BrushFace& face = m_faces[*faceIndex];
+                    face.setGeometry(faceGeometry);
+                }
+            }
+
+            assert(checkFaceLinks());
+        }
         
         const vm::bbox3& Brush::bounds() const {
             ensure(m_geometry != nullptr, "geometry is null");
             return m_geometry->bounds();
         }
 
+        bool Brush::sharesGeometryWith(const Brush& other) const {
+            return m_geometry != nullptr && m_geometry == other.m_geometry;
+        }
+
         std::optional<size_t> Brush::findFace(const std::string& textureName) const {
             return kdl::vec_index_of(m_faces, [&](const BrushFace& face) { return face.attributes().textureName() == textureName; });
         }
@@ -882,6 +894,10 @@ namespace TrenchBroom {
         }
 
         bool Brush::canTransform(const vm::mat4x4& transformation, const vm::bbox3& worldBounds) const {
+            if (inPlaceTranslation(transformation, worldBounds)) {
+                return true;
+            }
+
             try {
                 auto testBrush = Brush(*this);
                 testBrush.transform(transformation, false, worldBounds);
@@ -892,11 +908,53 @@ namespace TrenchBroom {
         }
 
         void Brush::transform(const vm::mat4x4& transformation, const bool lockTextures, const vm::bbox3& worldBounds) {
+            const auto translation = inPlaceTranslation(transformation, worldBounds);
+
             for (auto& face : m_faces) {
                 face.transform(transformation, lockTextures);
             }
 
-            updateGeometryFromFaces(worldBounds);
+            if (translation) {
+                detachGeometry();
+                m_geometry->translate(*translation);
+            } else {
+                updateGeometryFromFaces(worldBounds);
+            }
+        }
+
+        static bool isIntegral(const vm::vec3& v) {
+            for (size_t i = 0; i < 3; ++i) {
+                if (std::trunc(v[i]) != v[i]) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        std::optional<vm::vec3> Brush::inPlaceTranslation(const vm::mat4x4& transformation, const vm::bbox3& worldBounds) const {
+            if (m_geometry == nullptr) {
+                return std::nullopt;
+            }
+
+            const auto offset = vm::vec3(transformation[3][0], transformation[3][1], transformation[3][2]);
+            if (!isIntegral(offset) || transformation != vm::translation_matrix(offset)) {
+                return std::nullopt;
+            }
+
+            const auto& bounds = m_geometry->bounds();
+            for (size_t i = 0; i < 3; ++i) {
+                if (bounds.min[i] + offset[i] <= worldBounds.min[i] || bounds.max[i] + offset[i] >= worldBounds.max[i]) {
+                    return std::nullopt;
+                }
+            }
+
+            for (const auto* vertex : m_geometry->vertices()) {
+                if (!isIntegral(vertex->position())) {
+                    return std::nullopt;
+                }
+            }
+
+            return offset;
         }
 
         bool Brush::contains(const vm::bbox3& bounds) const {
@@ -49,7 +49,11 @@ namespace TrenchBroom {
             using EdgeList = BrushEdgeList;
         private:
             std::vector<BrushFace> m_faces;
-            std::unique_ptr<BrushGeometry> m_geometry;
+            /**
+             * The geometry is shared between copies of this brush until one of them modifies it, see
+             * detachGeometry(). This makes copying a brush cheap, e.g. when taking snapshots or duplicating brushes.
+             */
+            std::shared_ptr<BrushGeometry> m_geometry;
         public:
             Brush();
             Brush(const vm::bbox3& worldBounds, std::vector<BrushFace> faces);
@@ -65,8 +69,18 @@ namespace TrenchBroom {
             void cleanup();
         private:
             void updateGeometryFromFaces(const vm::bbox3& worldBounds);
+            /**
+             * Ensures that this brush's geometry is not shared with any other brush. Must be called before the
+             * geometry is modified in place.
+             */
+            void detachGeometry();
         public:
             const vm::bbox3& bounds() const;
+
+            /**
+             * Indicates whether this brush and the given brush share the same geometry.
+             */
+            bool sharesGeometryWith(const Brush& other) const;
         public: // face management:
             std::optional<size_t> findFace(const std::string& textureName) const;
             std::optional<size_t> findFace(const vm::vec3& normal) const;
@@ -191,6 +205,16 @@ namespace TrenchBroom {
             // transformation
             bool canTransform(const vm::mat4x4& transformation, const vm::bbox3& worldBounds) const;
             void transform(const vm::mat4x4& transformation, bool lockTextures, const vm::bbox3& worldBounds);
+        private:
+            /**
+             * Returns the offset of the given transformation if it is a translation that can be applied by moving the
+             * vertices of this brush's geometry in place instead of rebuilding the geometry from the transformed faces.
+             *
+             * This is only the case if the offset and all vertex positions are integral and if the translated brush is
+             * strictly contained in the world bounds. Then rebuilding the geometry would yield exactly the translated
+             * vertex positions, so both ways of transforming this brush have bit identical results.
+             */
+            std::optional<vm::vec3> inPlaceTranslation(const vm::mat4x4& transformation, const vm::bbox3& worldBounds) const;
         public:
             bool contains(const vm::bbox3& bounds) const;
             bool contains(const Brush& brush) const;
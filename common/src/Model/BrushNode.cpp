@@ -54,6 +54,7 @@
 
 #include <algorithm> // for std::remove
 #include <iterator>
+#include <limits>
 #include <set>
 #include <string>
 #include <vector>
@@ -216,16 +217,45 @@ namespace TrenchBroom {
         }
 
         std::optional<std::tuple<FloatType, size_t>> BrushNode::findFaceHit(const vm::ray3& ray) const {
-            if (!vm::is_nan(vm::intersect_ray_bbox(ray, logicalBounds()))) {
-                for (size_t i = 0u; i < m_brush.faceCount(); ++i) {
-                    const auto& face = m_brush.face(i);
-                    const auto distance = face.intersectWithRay(ray);
-                    if (!vm::is_nan(distance)) {
-                        return std::make_tuple(distance, i);
+            if (vm::is_nan(vm::intersect_ray_bbox(ray, logicalBounds()))) {
+                return std::nullopt;
+            }
+
+            // The brush is the intersection of the half spaces behind its face planes. The ray enters the brush through
+            // the front facing plane it crosses last, unless it leaves the half space of a back facing plane before
+            // that. This way, the ray need not be tested against the face polygons.
+            auto enterDistance = -std::numeric_limits<FloatType>::max();
+            auto exitDistance = std::numeric_limits<FloatType>::max();
+            auto enterFaceIndex = m_brush.faceCount();
+
+            for (size_t i = 0u; i < m_brush.faceCount(); ++i) {
+                const auto& plane = m_brush.face(i).boundary();
+                const auto cos = vm::dot(plane.normal, ray.direction);
+                const auto originDistance = plane.point_distance(ray.origin);
+
+                if (cos == FloatType(0.0)) {
+                    if (originDistance > vm::C::almost_zero()) {
+                        // the ray is parallel to and in front of this plane
+                        return std::nullopt;
+                    }
+                } else {
+                    const auto distance = -originDistance / cos;
+                    if (cos < FloatType(0.0)) {
+                        if (distance > enterDistance) {
+                            enterDistance = distance;
+                            enterFaceIndex = i;
+                        }
+                    } else {
+                        exitDistance = std::min(exitDistance, distance);
                     }
                 }
             }
-            return std::nullopt;
+
+            if (enterFaceIndex == m_brush.faceCount() || enterDistance < FloatType(0.0) || enterDistance > exitDistance + vm::C::almost_zero()) {
+                return std::nullopt;
+            }
+
+            return std::make_tuple(enterDistance, enterFaceIndex);
         }
 
         Node* BrushNode::doGetContainer() const {
@@ -22,21 +22,18 @@
 #include "Model/BrushNode.h"
 #include "Model/BrushFace.h"
 
-#include <kdl/vector_utils.h>
-
 namespace TrenchBroom {
     namespace Model {
         BrushSnapshot::BrushSnapshot(BrushNode* brushNode) :
-        m_brushNode(brushNode) {
-            const Brush& brush = m_brushNode->brush();
-            for (const BrushFace& face : brush.faces()) {
-                BrushFace& copy = m_faces.emplace_back(face);
-                copy.setTexture(nullptr);
+        m_brushNode(brushNode),
+        m_brush(m_brushNode->brush()) {
+            for (BrushFace& face : m_brush.faces()) {
+                face.setTexture(nullptr);
             }
         }
 
-        void BrushSnapshot::doRestore(const vm::bbox3& worldBounds) {
-            m_brushNode->setBrush(Brush(worldBounds, std::move(m_faces)));
+        void BrushSnapshot::doRestore(const vm::bbox3& /* worldBounds */) {
+            m_brushNode->setBrush(std::move(m_brush));
         }
     }
 }
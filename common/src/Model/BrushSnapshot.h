@@ -20,19 +20,20 @@
 #ifndef TrenchBroom_BrushSnapshot
 #define TrenchBroom_BrushSnapshot
 
+#include "Model/Brush.h"
 #include "Model/NodeSnapshot.h"
 
-#include <vector>
-
 namespace TrenchBroom {
     namespace Model {
         class BrushNode;
-        class BrushFace;
 
         class BrushSnapshot : public NodeSnapshot {
         private:
             BrushNode* m_brushNode;
-            std::vector<BrushFace> m_faces;
+            /**
+             * A copy of the brush, which shares its geometry with the snapshotted brush until either is modified.
+             */
+            Brush m_brush;
         public:
             BrushSnapshot(BrushNode* brushNode);
         private:
@@ -21,9 +21,12 @@
 #define TrenchBroom_CollectContainedNodesVisitor
 
 #include "Model/CollectMatchingNodesVisitor.h"
+#include "Model/MatchNodesByBrushQuery.h"
 #include "Model/MatchSelectableNodes.h"
 #include "Model/NodePredicates.h"
 
+#include <vector>
+
 namespace TrenchBroom {
     namespace Model {
         template <typename I>
@@ -53,6 +56,16 @@ namespace TrenchBroom {
             CollectContainedNodesVisitor(I begin, I end, const Model::EditorContext& editorContext) :
             CollectMatchingNodesVisitor<NodePredicates::And<MatchSelectableNodes, MatchContainedNodes<I> >, UniqueNodeCollectionStrategy, StopRecursionIfMatched>(NodePredicates::And<MatchSelectableNodes, MatchContainedNodes<I> >(MatchSelectableNodes(editorContext), MatchContainedNodes<I>(begin, end))) {}
         };
+
+        /**
+         * Collects the same nodes as CollectContainedNodesVisitor, but uses the node tree of the given world to avoid
+         * testing every node against every brush. The visitor must be accepted by the given world.
+         */
+        class CollectContainedNodesInWorldVisitor : public CollectMatchingNodesVisitor<NodePredicates::And<MatchSelectableNodes, MatchNodesByBrushQuery>, UniqueNodeCollectionStrategy, StopRecursionIfMatched> {
+        public:
+            CollectContainedNodesInWorldVisitor(const WorldNode& world, const std::vector<BrushNode*>& brushes, const Model::EditorContext& editorContext) :
+            CollectMatchingNodesVisitor<NodePredicates::And<MatchSelectableNodes, MatchNodesByBrushQuery>, UniqueNodeCollectionStrategy, StopRecursionIfMatched>(NodePredicates::And<MatchSelectableNodes, MatchNodesByBrushQuery>(MatchSelectableNodes(editorContext), MatchNodesByBrushQuery(world, brushes, BrushQueryType::Contained))) {}
+        };
     }
 }
 #endif /* defined(TrenchBroom_CollectContainedNodesVisitor) */
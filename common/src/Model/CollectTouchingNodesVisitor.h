@@ -21,9 +21,12 @@
 #define TrenchBroom_CollectTouchingNodesVisitor
 
 #include "Model/CollectMatchingNodesVisitor.h"
+#include "Model/MatchNodesByBrushQuery.h"
 #include "Model/MatchSelectableNodes.h"
 #include "Model/NodePredicates.h"
 
+#include <vector>
+
 namespace TrenchBroom {
     namespace Model {
         template <typename I>
@@ -61,6 +64,16 @@ namespace TrenchBroom {
                 CollectTouchingNodesVisitor(I begin, I end, const Model::EditorContext& editorContext) :
                 CollectMatchingNodesVisitor<NodePredicates::And<MatchSelectableNodes, MatchTouchingNodes<I> >, UniqueNodeCollectionStrategy, StopRecursionIfMatched>(NodePredicates::And<MatchSelectableNodes, MatchTouchingNodes<I> >(MatchSelectableNodes(editorContext), MatchTouchingNodes<I>(begin, end))) {}
         };
+
+        /**
+         * Collects the same nodes as CollectTouchingNodesVisitor, but uses the node tree of the given world to avoid
+         * testing every node against every brush. The visitor must be accepted by the given world.
+         */
+        class CollectTouchingNodesInWorldVisitor : public CollectMatchingNodesVisitor<NodePredicates::And<MatchSelectableNodes, MatchNodesByBrushQuery>, UniqueNodeCollectionStrategy, StopRecursionIfMatched> {
+        public:
+            CollectTouchingNodesInWorldVisitor(const WorldNode& world, const std::vector<BrushNode*>& brushes, const Model::EditorContext& editorContext) :
+            CollectMatchingNodesVisitor<NodePredicates::And<MatchSelectableNodes, MatchNodesByBrushQuery>, UniqueNodeCollectionStrategy, StopRecursionIfMatched>(NodePredicates::And<MatchSelectableNodes, MatchNodesByBrushQuery>(MatchSelectableNodes(editorContext), MatchNodesByBrushQuery(world, brushes, BrushQueryType::Touching))) {}
+        };
     }
 }
 
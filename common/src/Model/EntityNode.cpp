@@ -23,6 +23,7 @@
 #include "Assets/EntityModel.h"
 #include "Model/BoundsContainsNodeVisitor.h"
 #include "Model/BoundsIntersectsNodeVisitor.h"
+#include "Model/Brush.h"
 #include "Model/BrushNode.h"
 #include "Model/ComputeNodeBoundsVisitor.h"
 #include "Model/EntityRotationPolicy.h"
@@ -122,6 +123,14 @@ namespace TrenchBroom {
             }
         }
 
+        void EntityNode::setBrushes(std::vector<std::pair<BrushNode*, Brush>> brushes) {
+            const NotifyNodeChange nodeChange(this);
+            for (auto& [brushNode, brush] : brushes) {
+                assert(brushNode->parent() == this);
+                brushNode->setBrush(std::move(brush));
+            }
+        }
+
         void EntityNode::cacheAttributes() {
             m_cachedOrigin = vm::parse<FloatType, 3>(attribute(AttributeNames::Origin, ""), vm::vec3::zero());
             if (vm::is_nan(m_cachedOrigin)) {
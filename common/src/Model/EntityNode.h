@@ -31,6 +31,7 @@
 #include <vecmath/util.h>
 
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace TrenchBroom {
@@ -41,6 +42,9 @@ namespace TrenchBroom {
     }
 
     namespace Model {
+        class Brush;
+        class BrushNode;
+
         class EntityNode : public AttributableNode, public Object {
         public:
             static const HitType::Type EntityHitType;
@@ -72,6 +76,13 @@ namespace TrenchBroom {
             const vm::mat4x4 modelTransformation() const;
             Assets::PitchType pitchType() const;
             FloatType area(vm::axis::type axis) const;
+
+            /**
+             * Replaces the brushes of the given child brush nodes of this brush entity. This notifies the observers
+             * of this entity in the same way as transforming it does, so it can be used to apply brushes that were
+             * transformed elsewhere.
+             */
+            void setBrushes(std::vector<std::pair<BrushNode*, Brush>> brushes);
         private:
             void cacheAttributes();
             void setOrigin(const vm::vec3& origin);
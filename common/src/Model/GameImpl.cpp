@@ -21,7 +21,10 @@
 
 #include "Ensure.h"
 #include "Exceptions.h"
+#include "Logger.h"
 #include "Macros.h"
+#include "PreferenceManager.h"
+#include "Preferences.h"
 #include "Assets/Palette.h"
 #include "Assets/EntityModel.h"
 #include "Assets/EntityDefinitionFileSpec.h"
@@ -38,6 +41,7 @@
 #include "IO/FileMatcher.h"
 #include "IO/GameConfigParser.h"
 #include "IO/IOUtils.h"
+#include "IO/MapCache.h"
 #include "IO/MdlParser.h"
 #include "IO/Md2Parser.h"
 #include "IO/Md3Parser.h"
@@ -163,11 +167,17 @@ namespace TrenchBroom {
         }
 
         std::unique_ptr<WorldNode> GameImpl::doLoadMap(const MapFormat format, const vm::bbox3& worldBounds, const IO::Path& path, Logger& logger) const {
-            IO::SimpleParserStatus parserStatus(logger);
-            auto file = IO::Disk::openFile(IO::Disk::fixPath(path));
+            const auto fixedPath = IO::Disk::fixPath(path);
+            auto file = IO::Disk::mapFile(fixedPath);
             auto fileReader = file->reader().buffer();
-            IO::WorldReader worldReader(std::begin(fileReader), std::end(fileReader));
-            return worldReader.read(format, worldBounds, parserStatus);
+            if (!pref(Preferences::MapCache)) {
+                IO::SimpleParserStatus parserStatus(logger);
+                IO::WorldReader worldReader(std::begin(fileReader), std::end(fileReader));
+                return worldReader.read(format, worldBounds, parserStatus);
+            }
+
+            const auto cachePath = IO::MapCache::cachePath(fixedPath);
+            return IO::MapCache::readWorld(std::begin(fileReader), std::end(fileReader), gameName(), format, worldBounds, cachePath, logger);
         }
 
         void GameImpl::doWriteMap(WorldNode& world, const IO::Path& path) const {
@@ -227,7 +237,7 @@ namespace TrenchBroom {
             const auto paths = extractTextureCollections(node);
 
             const auto fileSearchPaths = textureCollectionSearchPaths(documentPath);
-            IO::TextureLoader textureLoader(m_fs, fileSearchPaths, m_config.textureConfig(), logger);
+            IO::TextureLoader textureLoader(m_fs, fileSearchPaths, m_config.textureConfig(), logger, pref(Preferences::LazyTextureLoading));
             textureLoader.loadTextures(paths, textureManager);
         }
 
@@ -0,0 +1,118 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "MatchNodesByBrushQuery.h"
+
+#include "Model/BrushNode.h"
+#include "Model/EntityNode.h"
+#include "Model/GroupNode.h"
+#include "Model/Node.h"
+#include "Model/WorldNode.h"
+
+#include <kdl/parallel.h>
+
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+namespace TrenchBroom {
+    namespace Model {
+        struct MatchNodesByBrushQuery::Matches {
+            BrushQueryType type;
+            std::vector<const BrushNode*> brushes;
+            std::unordered_set<const Node*> matchingNodes;
+
+            bool test(const BrushNode* brush, const Node* node) const {
+                return type == BrushQueryType::Touching ? brush->intersects(node) : brush->contains(node);
+            }
+        };
+
+        MatchNodesByBrushQuery::MatchNodesByBrushQuery(const WorldNode& world, const std::vector<BrushNode*>& brushes, const BrushQueryType type) {
+            auto matches = std::make_shared<Matches>();
+            matches->type = type;
+            matches->brushes = std::vector<const BrushNode*>(std::begin(brushes), std::end(brushes));
+
+            const auto queryBrushes = std::unordered_set<const Node*>(std::begin(brushes), std::end(brushes));
+            const auto isExcluded = [&](const BrushNode* brush, const Node* node) {
+                return node == brush || (type == BrushQueryType::Touching && queryBrushes.count(node) > 0u);
+            };
+
+            // broad phase: find the query brushes whose bounds intersect the bounds of each node in the node tree
+            std::unordered_map<const Node*, std::vector<const BrushNode*>> candidateMap;
+            for (const auto* brush : brushes) {
+                for (const auto* node : world.findNodesIntersecting(brush->logicalBounds())) {
+                    if (!isExcluded(brush, node)) {
+                        candidateMap[node].push_back(brush);
+                    }
+                }
+            }
+
+            // narrow phase: test each candidate node against its query brushes until one of them matches
+            const auto candidates = std::vector<std::pair<const Node*, std::vector<const BrushNode*>>>(std::begin(candidateMap), std::end(candidateMap));
+            for (const auto& candidate : candidates) {
+                // entities compute their bounds lazily, which must not happen concurrently
+                candidate.first->logicalBounds();
+            }
+
+            std::vector<char> results(candidates.size(), 0);
+            kdl::parallel_for(candidates.size(), [&](const size_t i) {
+                const auto& [node, candidateBrushes] = candidates[i];
+                results[i] = std::any_of(std::begin(candidateBrushes), std::end(candidateBrushes), [&](const BrushNode* brush) {
+                    return matches->test(brush, node);
+                });
+            });
+
+            for (size_t i = 0; i < candidates.size(); ++i) {
+                if (results[i]) {
+                    matches->matchingNodes.insert(candidates[i].first);
+                }
+            }
+
+            m_matches = std::move(matches);
+        }
+
+        bool MatchNodesByBrushQuery::operator()(const WorldNode* /* world */) const {
+            return false;
+        }
+
+        bool MatchNodesByBrushQuery::operator()(const LayerNode* /* layer */) const {
+            return false;
+        }
+
+        bool MatchNodesByBrushQuery::operator()(const GroupNode* group) const {
+            const auto& bounds = group->logicalBounds();
+            for (const auto* brush : m_matches->brushes) {
+                if (brush->logicalBounds().intersects(bounds) && m_matches->test(brush, group)) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        bool MatchNodesByBrushQuery::operator()(const EntityNode* entity) const {
+            return m_matches->matchingNodes.count(entity) > 0u;
+        }
+
+        bool MatchNodesByBrushQuery::operator()(const BrushNode* brush) const {
+            return m_matches->matchingNodes.count(brush) > 0u;
+        }
+    }
+}
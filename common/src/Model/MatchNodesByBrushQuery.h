@@ -0,0 +1,74 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef TrenchBroom_MatchNodesByBrushQuery
+#define TrenchBroom_MatchNodesByBrushQuery
+
+#include <memory>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Model {
+        class BrushNode;
+        class EntityNode;
+        class GroupNode;
+        class LayerNode;
+        class Node;
+        class WorldNode;
+
+        enum class BrushQueryType {
+            /**
+             * Matches the nodes which intersect with any query brush, except for the query brushes themselves.
+             */
+            Touching,
+            /**
+             * Matches the nodes which are contained in any query brush other than themselves.
+             */
+            Contained
+        };
+
+        /**
+         * Matches the nodes of a world which touch or are contained in any of a set of query brushes.
+         *
+         * Testing every node against every query brush is too slow for large maps and selections, so the node tree of
+         * the world serves as a broad phase. For each query brush, only the brushes and entities whose bounds intersect
+         * the brush's bounds are tested exactly, and these tests are performed concurrently when the predicate is
+         * created. Groups are not in the node tree, so they are tested when the predicate is called, but only against
+         * the query brushes whose bounds intersect the group's bounds.
+         *
+         * The world must not be modified while this predicate is in use.
+         */
+        class MatchNodesByBrushQuery {
+        private:
+            struct Matches;
+            std::shared_ptr<const Matches> m_matches;
+        public:
+            MatchNodesByBrushQuery(const WorldNode& world, const std::vector<BrushNode*>& brushes, BrushQueryType type);
+
+            bool operator()(const WorldNode* world) const;
+            bool operator()(const LayerNode* layer) const;
+            bool operator()(const GroupNode* group) const;
+            bool operator()(const EntityNode* entity) const;
+            bool operator()(const BrushNode* brush) const;
+        };
+    }
+}
+
+#endif /* defined(TrenchBroom_MatchNodesByBrushQuery) */
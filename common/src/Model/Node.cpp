@@ -592,6 +592,10 @@ namespace TrenchBroom {
             return m_lineNumber;
         }
 
+        size_t Node::lineCount() const {
+            return m_lineCount;
+        }
+
         void Node::setFilePosition(const size_t lineNumber, const size_t lineCount) const {
             m_lineNumber = lineNumber;
             m_lineCount = lineCount;
@@ -618,6 +622,10 @@ namespace TrenchBroom {
             }
         }
 
+        bool Node::issuesValid() const {
+            return m_issuesValid;
+        }
+
         void Node::validateIssues(const std::vector<IssueGenerator*>& issueGenerators) {
             if (!m_issuesValid) {
                 for (const auto* generator : issueGenerators) {
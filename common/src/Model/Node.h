@@ -292,6 +292,7 @@ namespace TrenchBroom {
             void findNodesContaining(const vm::vec3& point, std::vector<Node*>& result);
         public: // file position
             size_t lineNumber() const;
+            size_t lineCount() const;
             void setFilePosition(size_t lineNumber, size_t lineCount) const;
             bool containsLine(size_t lineNumber) const;
         public: // issue management
@@ -301,8 +302,18 @@ namespace TrenchBroom {
             void setIssueHidden(IssueType type, bool hidden);
         public: // should only be called from this and from the world
             void invalidateIssues() const;
-        private:
+
+            /**
+             * Indicates whether the issues of this node have been generated since they were last invalidated.
+             */
+            bool issuesValid() const;
+
+            /**
+             * Generates the issues of this node using the given generators unless they are valid. Different nodes may
+             * be validated on different threads at the same time, provided that no node is modified meanwhile.
+             */
             void validateIssues(const std::vector<IssueGenerator*>& issueGenerators);
+        private:
             void clearIssues() const;
         public: // visitors
             /**
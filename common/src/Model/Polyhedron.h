@@ -1407,6 +1407,14 @@ namespace TrenchBroom {
              * @return a face or null if no face satisfies the criteria listed above
              */
             Face* findClosestFace(const std::vector<vm::vec<T,3>>& positions, T maxDistance = std::numeric_limits<T>::max());
+
+            /**
+             * Moves every vertex of this polyhedron by the given offset. The topology of this polyhedron is not changed,
+             * and the bounds are moved by the same offset.
+             *
+             * @param offset the offset to move by
+             */
+            void translate(const vm::vec<T,3>& offset);
         private:
             /**
              * Updates the bounds to the smallest bounding box that contains the positions of all vertices of this
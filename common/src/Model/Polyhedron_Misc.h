@@ -662,6 +662,15 @@ namespace TrenchBroom {
             return closestFace;
         }
 
+        template <typename T, typename FP, typename VP>
+        void Polyhedron<T,FP,VP>::translate(const vm::vec<T,3>& offset) {
+            for (auto* vertex : m_vertices) {
+                vertex->setPosition(vertex->position() + offset);
+            }
+            m_bounds.min = m_bounds.min + offset;
+            m_bounds.max = m_bounds.max + offset;
+        }
+
         template <typename T, typename FP, typename VP>
         void Polyhedron<T,FP,VP>::updateBounds() {
             auto builder = typename vm::bbox<T,3>::builder();
@@ -215,6 +215,14 @@ namespace TrenchBroom {
             return false;
         }
 
+        bool TagMatcher::isTextureMatcher() const {
+            return false;
+        }
+
+        bool TagMatcher::matchesFaceTexture(const std::string& /* textureName */, const Assets::Texture* /* texture */) const {
+            return false;
+        }
+
         SmartTag::SmartTag(const std::string& name, std::vector<TagAttribute> attributes, std::unique_ptr<TagMatcher> matcher) :
         Tag(name, std::move(attributes)),
         m_matcher(std::move(matcher)) {}
@@ -247,6 +255,15 @@ namespace TrenchBroom {
             }
         }
 
+        bool SmartTag::isTextureTag() const {
+            return m_matcher->isTextureMatcher();
+        }
+
+        bool SmartTag::matchesFaceTexture(const std::string& textureName, const Assets::Texture* texture) const {
+            assert(isTextureTag());
+            return m_matcher->matchesFaceTexture(textureName, texture);
+        }
+
         void SmartTag::enable(TagMatcherCallback& callback, MapFacade& facade) const {
             m_matcher->enable(callback, facade);
         }
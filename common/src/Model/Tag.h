@@ -30,6 +30,10 @@
 #include <vector>
 
 namespace TrenchBroom {
+    namespace Assets {
+        class Texture;
+    }
+
     namespace Model {
         class ConstTagVisitor;
         class TagManager;
@@ -329,6 +333,24 @@ namespace TrenchBroom {
              */
             virtual bool canDisable() const;
 
+            /**
+             * Indicates whether this tag matcher only matches brush faces, and decides whether it matches a brush face
+             * only by the face's texture name and texture. The results of such matchers can be cached per texture.
+             *
+             * @return true if this tag matcher only depends on the texture of a brush face and false otherwise
+             */
+            virtual bool isTextureMatcher() const;
+
+            /**
+             * Evaluates this tag matcher against a brush face with the given texture name and texture. Only called if
+             * this is a texture matcher.
+             *
+             * @param textureName the texture name of the brush face
+             * @param texture the texture of the brush face, may be null
+             * @return true if this matcher matches a brush face with the given texture and false otherwise
+             */
+            virtual bool matchesFaceTexture(const std::string& textureName, const Assets::Texture* texture) const;
+
             /**
              * Returns a new copy of this tag matcher.
              */
@@ -372,6 +394,23 @@ namespace TrenchBroom {
              */
             void update(Taggable& taggable) const;
 
+            /**
+             * Indicates whether this smart tag only applies to brush faces, depending only on their texture.
+             *
+             * @return true if this smart tag has a texture matcher and false otherwise
+             */
+            bool isTextureTag() const;
+
+            /**
+             * Indicates whether this smart tag matches a brush face with the given texture name and texture. Must only
+             * be called if this is a texture tag.
+             *
+             * @param textureName the texture name of the brush face
+             * @param texture the texture of the brush face, may be null
+             * @return true if this smart tag matches a brush face with the given texture and false otherwise
+             */
+            bool matchesFaceTexture(const std::string& textureName, const Assets::Texture* texture) const;
+
             /**
              * Modifies the current selection so that this tag would match it.
              *
@@ -20,8 +20,11 @@
 #include "TagManager.h"
 
 #include "Ensure.h"
+#include "Model/BrushFace.h"
+#include "Model/BrushFaceAttributes.h"
 #include "Model/Tag.h"
 #include "Model/TagType.h"
+#include "Model/TagVisitor.h"
 
 #include <algorithm>
 #include <stdexcept>
@@ -45,6 +48,21 @@ namespace TrenchBroom {
             return lhs < rhs;
         }
 
+        class TagManager::UpdateTextureTagsVisitor : public TagVisitor {
+        private:
+            const TagManager& m_tagManager;
+        public:
+            explicit UpdateTextureTagsVisitor(const TagManager& tagManager) :
+            m_tagManager(tagManager) {}
+
+            void visit(BrushFace& face) override {
+                m_tagManager.updateTextureTags(face);
+            }
+        };
+
+        TagManager::TagManager() :
+        m_textureTagMask(0) {}
+
         const std::vector<SmartTag>& TagManager::smartTags() const {
             return m_smartTags.get_data();
         }
@@ -81,6 +99,7 @@ namespace TrenchBroom {
 
         void TagManager::registerSmartTags(const std::vector<SmartTag>& tags) {
             m_smartTags = kdl::vector_set<SmartTag, TagCmp>(tags.size());
+            m_textureTagMask = 0;
             for (const auto& tag : tags) {
                 const size_t nextIndex = freeTagIndex();
                 auto [it, inserted] = m_smartTags.insert(tag);
@@ -90,17 +109,66 @@ namespace TrenchBroom {
                 }
 
                 it->setIndex(nextIndex);
+                if (it->isTextureTag()) {
+                    m_textureTagMask |= it->type();
+                }
             }
+            m_textureTags.clear();
         }
 
         void TagManager::clearSmartTags() {
             m_smartTags.clear();
+            m_textureTagMask = 0;
+            m_textureTags.clear();
         }
 
         void TagManager::updateTags(Taggable& taggable) const {
             for (const auto& tag : m_smartTags) {
-                tag.update(taggable);
+                if (!tag.isTextureTag()) {
+                    tag.update(taggable);
+                }
+            }
+
+            if (m_textureTagMask != 0) {
+                UpdateTextureTagsVisitor visitor(*this);
+                taggable.accept(visitor);
+            }
+        }
+
+        void TagManager::invalidateTextureTags() {
+            m_textureTags.clear();
+        }
+
+        void TagManager::updateTextureTags(BrushFace& face) const {
+            const auto mask = textureTagMask(face.attributes().textureName(), face.texture());
+            if ((face.tagMask() & m_textureTagMask) == mask) {
+                return;
+            }
+
+            for (const auto& tag : m_smartTags) {
+                if (tag.isTextureTag()) {
+                    if ((mask & tag.type()) != 0) {
+                        face.addTag(tag);
+                    } else {
+                        face.removeTag(tag);
+                    }
+                }
+            }
+        }
+
+        TagType::Type TagManager::textureTagMask(const std::string& textureName, const Assets::Texture* texture) const {
+            // faces with the same texture name can still have different textures while the textures are being set
+            auto it = m_textureTags.find(textureName);
+            if (it == std::end(m_textureTags) || it->second.texture != texture) {
+                auto mask = TagType::Type(0);
+                for (const auto& tag : m_smartTags) {
+                    if (tag.isTextureTag() && tag.matchesFaceTexture(textureName, texture)) {
+                        mask |= tag.type();
+                    }
+                }
+                it = m_textureTags.insert_or_assign(textureName, TextureTags{texture, mask}).first;
             }
+            return it->second.mask;
         }
 
         size_t TagManager::freeTagIndex() {
@@ -21,15 +21,28 @@
 #define TRENCHBROOM_TAGMANAGER_H
 
 #include "Model/Tag.h"
+#include "Model/TagType.h"
 
 #include <kdl/vector_set.h>
 
 #include <string>
+#include <unordered_map>
 
 namespace TrenchBroom {
+    namespace Assets {
+        class Texture;
+    }
+
     namespace Model {
+        class BrushFace;
+
         /**
          * Manages the tags used in a document and updates smart tags on taggable objects.
+         *
+         * Whether a texture tag matches a brush face only depends on the face's texture name and texture, so the
+         * texture tags matching a face are cached per texture name. The cache must be invalidated whenever the
+         * textures change, see invalidateTextureTags. Since the cache is updated when tags are updated, a tag
+         * manager must not update tags on several threads at once.
          */
         class TagManager {
         private:
@@ -40,8 +53,19 @@ namespace TrenchBroom {
                 bool operator()(const std::string& lhs, const std::string& rhs) const;
             };
 
+            struct TextureTags {
+                const Assets::Texture* texture;
+                TagType::Type mask;
+            };
+
+            class UpdateTextureTagsVisitor;
+
             kdl::vector_set<SmartTag, TagCmp> m_smartTags;
+            TagType::Type m_textureTagMask;
+            mutable std::unordered_map<std::string, TextureTags> m_textureTags;
         public:
+            TagManager();
+
             /**
              * Returns a vector containing all smart tags registered with this manager.
              */
@@ -106,7 +130,14 @@ namespace TrenchBroom {
              * @param taggable the object to update
              */
             void updateTags(Taggable& taggable) const;
+
+            /**
+             * Clears the cached texture tags. Must be called whenever the textures change.
+             */
+            void invalidateTextureTags();
         private:
+            void updateTextureTags(BrushFace& face) const;
+            TagType::Type textureTagMask(const std::string& textureName, const Assets::Texture* texture) const;
             size_t freeTagIndex();
         };
     }
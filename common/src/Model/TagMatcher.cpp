@@ -102,6 +102,10 @@ namespace TrenchBroom {
             return true;
         }
 
+        bool TextureTagMatcher::isTextureMatcher() const {
+            return true;
+        }
+
         TextureNameTagMatcher::TextureNameTagMatcher(const std::string& pattern) :
         m_pattern(pattern) {}
 
@@ -118,7 +122,11 @@ namespace TrenchBroom {
             return visitor.matches();
         }
 
-        bool TextureNameTagMatcher::matchesTexture(Assets::Texture *texture) const {
+        bool TextureNameTagMatcher::matchesFaceTexture(const std::string& textureName, const Assets::Texture* /* texture */) const {
+            return matchesTextureName(textureName);
+        }
+
+        bool TextureNameTagMatcher::matchesTexture(const Assets::Texture* texture) const {
             if (texture == nullptr) {
                 return false;
             }
@@ -157,7 +165,11 @@ namespace TrenchBroom {
             return visitor.matches();
         }
 
-        bool SurfaceParmTagMatcher::matchesTexture(Assets::Texture *texture) const {
+        bool SurfaceParmTagMatcher::matchesFaceTexture(const std::string& /* textureName */, const Assets::Texture* texture) const {
+            return matchesTexture(texture);
+        }
+
+        bool SurfaceParmTagMatcher::matchesTexture(const Assets::Texture* texture) const {
             if (texture == nullptr) {
                 return false;
             }
@@ -75,8 +75,9 @@ namespace TrenchBroom {
         public:
             void enable(TagMatcherCallback& callback, MapFacade& facade) const override;
             bool canEnable() const override;
+            bool isTextureMatcher() const override;
         private:
-            virtual bool matchesTexture(Assets::Texture* texture) const = 0;
+            virtual bool matchesTexture(const Assets::Texture* texture) const = 0;
         };
 
         class TextureNameTagMatcher : public TextureTagMatcher {
@@ -86,8 +87,9 @@ namespace TrenchBroom {
             explicit TextureNameTagMatcher(const std::string& pattern);
             std::unique_ptr<TagMatcher> clone() const override;
             bool matches(const Taggable& taggable) const override;
+            bool matchesFaceTexture(const std::string& textureName, const Assets::Texture* texture) const override;
         private:
-            bool matchesTexture(Assets::Texture* texture) const override;
+            bool matchesTexture(const Assets::Texture* texture) const override;
             bool matchesTextureName(std::string_view textureName) const;
         };
 
@@ -99,8 +101,9 @@ namespace TrenchBroom {
             explicit SurfaceParmTagMatcher(const kdl::vector_set<std::string>& parameters);
             std::unique_ptr<TagMatcher> clone() const override;
             bool matches(const Taggable& taggable) const override;
+            bool matchesFaceTexture(const std::string& textureName, const Assets::Texture* texture) const override;
         private:
-            bool matchesTexture(Assets::Texture* texture) const override;
+            bool matchesTexture(const Assets::Texture* texture) const override;
         };
 
         class FlagsTagMatcher : public TagMatcher {
@@ -187,6 +187,14 @@ namespace TrenchBroom {
             m_nodeTree->clearAndBuild(collect.nodes(), [](const auto* node){ return node->physicalBounds(); });
         }
 
+        std::vector<Node*> WorldNode::findNodesIntersecting(const std::vector<vm::plane3>& planes) const {
+            return m_nodeTree->findIntersectors(planes);
+        }
+
+        std::vector<Node*> WorldNode::findNodesIntersecting(const vm::bbox3& bounds) const {
+            return m_nodeTree->findIntersectors(bounds);
+        }
+
         class WorldNode::InvalidateAllIssuesVisitor : public NodeVisitor {
         private:
             void doVisit(WorldNode* world) override   { invalidateIssues(world);  }
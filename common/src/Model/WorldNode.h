@@ -90,6 +90,25 @@ namespace TrenchBroom {
             void disableNodeTreeUpdates();
             void enableNodeTreeUpdates();
             void rebuildNodeTree();
+
+            /**
+             * Returns the brushes and entities of this world whose bounds intersect with the convex volume bounded by the
+             * given planes, such as the frustum of a camera. The node tree is used to skip every part of the world which
+             * is in front of one of the planes. Some nodes near the corners of the volume may be returned even though
+             * they are outside of it.
+             *
+             * @param planes the planes bounding the volume, their normals must point out of the volume
+             * @return the nodes which may intersect with the volume, in no particular order
+             */
+            std::vector<Node*> findNodesIntersecting(const std::vector<vm::plane3>& planes) const;
+
+            /**
+             * Returns the brushes and entities of this world whose physical bounds intersect with the given bounds.
+             *
+             * @param bounds the bounds to test
+             * @return the nodes whose bounds intersect with the given bounds, in no particular order
+             */
+            std::vector<Node*> findNodesIntersecting(const vm::bbox3& bounds) const;
         private:
             class InvalidateAllIssuesVisitor;
             void invalidateAllIssues();
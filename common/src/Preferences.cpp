@@ -130,10 +130,14 @@ namespace TrenchBroom {
 
         Preference<int> TextureMinFilter(IO::Path("Renderer/Texture mode min filter"), 0x2700);
         Preference<int> TextureMagFilter(IO::Path("Renderer/Texture mode mag filter"), 0x2600);
+        Preference<bool> LazyTextureLoading(IO::Path("Renderer/Lazy texture loading"), false);
+        Preference<int> TextureMemoryBudget(IO::Path("Renderer/Texture memory budget"), 1024); // in MiB, 0 means no limit
 
         Preference<bool> TextureLock(IO::Path("Editor/Texture lock"), true);
         Preference<bool> UVLock(IO::Path("Editor/UV lock"), false);
 
+        Preference<bool> MapCache(IO::Path("Editor/Map cache"), false);
+
         Preference<IO::Path>& RendererFontPath() {
             static Preference<IO::Path> fontPath(IO::Path("Renderer/Font name"), IO::Path("fonts/SourceSansPro-Regular.otf"));
             return fontPath;
@@ -259,8 +263,11 @@ namespace TrenchBroom {
                 &GridColor2D,
                 &TextureMinFilter,
                 &TextureMagFilter,
+                &LazyTextureLoading,
+                &TextureMemoryBudget,
                 &TextureLock,
                 &UVLock,
+                &MapCache,
                 &RendererFontPath(),
                 &RendererFontSize,
                 &BrowserFontSize,
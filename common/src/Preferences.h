@@ -124,10 +124,14 @@ namespace TrenchBroom {
 
         extern Preference<int> TextureMinFilter;
         extern Preference<int> TextureMagFilter;
+        extern Preference<bool> LazyTextureLoading;
+        extern Preference<int> TextureMemoryBudget;
 
         extern Preference<bool> TextureLock;
         extern Preference<bool> UVLock;
 
+        extern Preference<bool> MapCache;
+
         Preference<IO::Path>& RendererFontPath();
         extern Preference<int> RendererFontSize;
 
@@ -170,6 +170,8 @@ namespace TrenchBroom {
             block->nextOfSameSize = nullptr;
             block->prevOfSameSize = nullptr;
 
+            m_usedSize += needed;
+
             if (block->size == needed) {
                 // lucky case: exact size. we're done
                 block->free = false;
@@ -218,6 +220,8 @@ namespace TrenchBroom {
             assert(block->prevOfSameSize == nullptr);
             assert(block->nextOfSameSize == nullptr);
 
+            m_usedSize -= block->size;
+
             Block* left = block->left;
             Block* right = block->right;
 
@@ -315,6 +319,7 @@ namespace TrenchBroom {
 
         AllocationTracker::AllocationTracker(const Index initial_capacity)
                 : m_capacity(0),
+                  m_usedSize(0),
                   m_leftmostBlock(nullptr),
                   m_rightmostBlock(nullptr),
                   m_recycledBlockList(nullptr) {
@@ -326,6 +331,7 @@ namespace TrenchBroom {
 
         AllocationTracker::AllocationTracker()
                 : m_capacity(0),
+                  m_usedSize(0),
                   m_leftmostBlock(nullptr),
                   m_rightmostBlock(nullptr),
                   m_recycledBlockList(nullptr) {}
@@ -412,6 +418,95 @@ namespace TrenchBroom {
             checkInvariants();
         }
 
+        bool AllocationTracker::compact(const Index maxMoveSize, const MoveFunc& move) {
+            checkInvariants();
+
+            // find the leftmost free block
+            Block* freeBlock = m_leftmostBlock;
+            while (freeBlock != nullptr && !freeBlock->free) {
+                freeBlock = freeBlock->right;
+            }
+
+            // Swap the free block with the used block to its right until it reaches the end. Adjacent free blocks
+            // are always merged, so the block to the right of a free block is always used.
+            Index movedSize = 0;
+            while (freeBlock != nullptr && freeBlock->right != nullptr && movedSize < maxMoveSize) {
+                Block* usedBlock = freeBlock->right;
+                assert(!usedBlock->free);
+
+                Block* left = freeBlock->left;
+                Block* right = usedBlock->right;
+
+                // relink as left, usedBlock, freeBlock, right
+                usedBlock->left = left;
+                if (left == nullptr) {
+                    assert(m_leftmostBlock == freeBlock);
+                    m_leftmostBlock = usedBlock;
+                } else {
+                    left->right = usedBlock;
+                }
+                usedBlock->right = freeBlock;
+                freeBlock->left = usedBlock;
+                freeBlock->right = right;
+                if (right == nullptr) {
+                    assert(m_rightmostBlock == usedBlock);
+                    m_rightmostBlock = freeBlock;
+                } else {
+                    right->left = freeBlock;
+                }
+
+                const Index oldPos = usedBlock->pos;
+                usedBlock->pos = freeBlock->pos;
+                freeBlock->pos = usedBlock->pos + usedBlock->size;
+
+                // merge with the next hole, if any
+                if (right != nullptr && right->free) {
+                    unlinkFromBinList(freeBlock);
+                    unlinkFromBinList(right);
+
+                    freeBlock->size += right->size;
+                    freeBlock->right = right->right;
+                    if (right->right == nullptr) {
+                        m_rightmostBlock = freeBlock;
+                    } else {
+                        right->right->left = freeBlock;
+                    }
+
+                    recycle(right);
+                    linkToBinList(freeBlock);
+                }
+
+                move(usedBlock, oldPos);
+                movedSize += usedBlock->size;
+            }
+
+            checkInvariants();
+            return freeBlock == nullptr || freeBlock->right == nullptr;
+        }
+
+        AllocationTracker::Index AllocationTracker::usedSize() const {
+            return m_usedSize;
+        }
+
+        AllocationTracker::Index AllocationTracker::freeSize() const {
+            return m_capacity - m_usedSize;
+        }
+
+        AllocationTracker::Index AllocationTracker::fragmentedSize() const {
+            if (m_rightmostBlock != nullptr && m_rightmostBlock->free) {
+                return freeSize() - m_rightmostBlock->size;
+            } else {
+                return freeSize();
+            }
+        }
+
+        double AllocationTracker::fragmentation() const {
+            if (m_capacity == 0) {
+                return 0.0;
+            }
+            return static_cast<double>(fragmentedSize()) / static_cast<double>(m_capacity);
+        }
+
         bool AllocationTracker::hasAllocations() const {
             // NOTE: this loop should execute at most 2 iterations, because adjacent free blocks are always merged
             for (Block* block = m_leftmostBlock; block != nullptr; block = block->right) {
@@ -470,9 +565,13 @@ namespace TrenchBroom {
 
             // check the left/right pointers, size, pos
             size_t totalSize = 0;
+            size_t totalUsedSize = 0;
             for (Block* block = m_leftmostBlock; block != nullptr; block = block->right) {
                 assert(block->size != 0);
                 totalSize += block->size;
+                if (!block->free) {
+                    totalUsedSize += block->size;
+                }
 
                 if (block->right != nullptr) {
                     assert(block->right->left == block);
@@ -489,6 +588,7 @@ namespace TrenchBroom {
                 }
             }
             assert(m_capacity == totalSize);
+            assert(m_usedSize == totalUsedSize);
 
             // check the size map
             for (const auto& headBlock : m_freeBlockSizeBins) {
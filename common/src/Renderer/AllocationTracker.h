@@ -20,6 +20,7 @@
 #ifndef TrenchBroom_AllocationTracker
 #define TrenchBroom_AllocationTracker
 
+#include <functional>
 #include <vector>
 
 namespace TrenchBroom {
@@ -70,6 +71,11 @@ namespace TrenchBroom {
              */
             Index m_capacity;
 
+            /**
+             * The sum of `size` of all used Blocks.
+             */
+            Index m_usedSize;
+
             /**
              * Points to the Block with pos 0. Used to free all of the blocks in the destructor
              */
@@ -120,6 +126,47 @@ namespace TrenchBroom {
             void free(Block* block);
             size_t capacity() const;
             void expand(Index newCapacity);
+
+            /**
+             * Called for every block moved by compact(). The block's pos has already been updated, and the given
+             * position is the one it was moved away from.
+             */
+            using MoveFunc = std::function<void(Block* block, Index oldPos)>;
+
+            /**
+             * Incrementally compacts the allocations by moving used blocks towards the start, so that the free space
+             * collects in one block at the end. Each used block keeps its identity, so Block pointers returned by
+             * allocate() remain valid, but their pos changes. The caller must move the contents of every moved block
+             * in the given function. Since blocks only ever move towards the start, the old and new ranges of a block
+             * may overlap.
+             *
+             * @param maxMoveSize once the total size of the moved blocks reaches this, compaction stops
+             * @param move the function to call for every moved block
+             * @return true if the allocations are fully compacted, and false if compaction must be continued
+             */
+            bool compact(Index maxMoveSize, const MoveFunc& move);
+
+            /**
+             * Returns the total size of the used blocks. Constant time.
+             */
+            Index usedSize() const;
+
+            /**
+             * Returns the total size of the free blocks. Constant time.
+             */
+            Index freeSize() const;
+
+            /**
+             * Returns the total size of the free blocks that are followed by a used block, i.e. the holes that
+             * compact() removes. Constant time.
+             */
+            Index fragmentedSize() const;
+
+            /**
+             * Returns the fragmented size relative to the capacity, which is between 0 and 1. Returns 0 if
+             * `capacity() == 0`. Constant time.
+             */
+            double fragmentation() const;
             /**
              * @return whether there are any allocations. i.e. returns false iff the whole range managed by the allocation
              * tracker is free. Returns false if `capacity() == 0`. Constant time.
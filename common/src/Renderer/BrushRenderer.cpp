@@ -31,6 +31,9 @@
 #include "Renderer/BrushRendererBrushCache.h"
 #include "Renderer/RenderContext.h"
 
+#include <kdl/parallel.h>
+
+#include <algorithm>
 #include <cassert>
 #include <cstring>
 #include <vector>
@@ -133,7 +136,8 @@ namespace TrenchBroom {
         m_showOccludedEdges(false),
         m_forceTransparent(false),
         m_transparencyAlpha(1.0f),
-        m_showHiddenBrushes(false) {
+        m_showHiddenBrushes(false),
+        m_frustumCulling(false) {
             clear();
         }
 
@@ -204,6 +208,9 @@ namespace TrenchBroom {
             m_edgeIndices = std::make_shared<BrushIndexArray>();
             m_transparentFaces = std::make_shared<TextureToBrushIndicesMap>();
             m_opaqueFaces = std::make_shared<TextureToBrushIndicesMap>();
+            m_opaqueFaceRanges = std::make_shared<TextureToIndexRangesMap>();
+            m_transparentFaceRanges = std::make_shared<TextureToIndexRangesMap>();
+            m_edgeRanges = std::make_shared<IndexRangeList>();
 
             m_opaqueFaceRenderer = FaceRenderer(m_vertexArray, m_opaqueFaces, m_faceColor);
             m_transparentFaceRenderer = FaceRenderer(m_vertexArray, m_transparentFaces, m_faceColor);
@@ -263,6 +270,10 @@ namespace TrenchBroom {
             }
         }
 
+        void BrushRenderer::setFrustumCulling(const bool frustumCulling) {
+            m_frustumCulling = frustumCulling;
+        }
+
         void BrushRenderer::render(RenderContext& renderContext, RenderBatch& renderBatch) {
             renderOpaque(renderContext, renderBatch);
             renderTransparent(renderContext, renderBatch);
@@ -273,6 +284,8 @@ namespace TrenchBroom {
                 if (!valid()) {
                     validate();
                 }
+                compact();
+                cull(renderContext, true);
                 if (renderContext.showFaces()) {
                     renderOpaqueFaces(renderBatch);
                 }
@@ -287,12 +300,136 @@ namespace TrenchBroom {
                 if (!valid()) {
                     validate();
                 }
+                cull(renderContext, false);
                 if (renderContext.showFaces()) {
                     renderTransparentFaces(renderBatch);
                 }
             }
         }
 
+        void BrushRenderer::cull(RenderContext& renderContext, const bool opaquePass) {
+            auto& faceRenderer = opaquePass ? m_opaqueFaceRenderer : m_transparentFaceRenderer;
+            auto& faceRanges = opaquePass ? m_opaqueFaceRanges : m_transparentFaceRanges;
+
+            faceRenderer.setIndexRanges(nullptr);
+            if (opaquePass) {
+                m_edgeRenderer.setIndexRanges(nullptr);
+            }
+
+            if (!m_frustumCulling || !renderContext.frustumCulling()) {
+                return;
+            }
+
+            faceRanges->clear();
+            if (opaquePass) {
+                m_edgeRanges->clear();
+            }
+
+            size_t visibleBrushCount = 0u;
+            const auto addBrush = [&](const BrushInfo& info) {
+                ++visibleBrushCount;
+                for (const auto& [texture, key] : opaquePass ? info.opaqueFaceIndicesKeys : info.transparentFaceIndicesKeys) {
+                    (*faceRanges)[texture].add(key->pos, key->size);
+                }
+                if (opaquePass && info.edgeIndicesKey != nullptr) {
+                    m_edgeRanges->add(info.edgeIndicesKey->pos, info.edgeIndicesKey->size);
+                }
+            };
+
+            // iterate over whichever is smaller, the brushes in the VBO or the visible brushes
+            const auto& visibleBrushes = renderContext.visibleBrushes();
+            if (m_brushInfo.size() < visibleBrushes.size()) {
+                const auto& visibleNodes = renderContext.visibleNodes();
+                for (const auto& [brush, info] : m_brushInfo) {
+                    if (visibleNodes.count(brush) > 0u) {
+                        addBrush(info);
+                    }
+                }
+            } else {
+                for (const auto* brush : visibleBrushes) {
+                    const auto it = m_brushInfo.find(brush);
+                    if (it != std::end(m_brushInfo)) {
+                        addBrush(it->second);
+                    }
+                }
+            }
+
+            const auto culledBrushCount = m_brushInfo.size() - visibleBrushCount;
+            if (opaquePass) {
+                renderContext.addCulledBrushes(culledBrushCount);
+            }
+
+            if (culledBrushCount > 0u) {
+                for (auto& entry : *faceRanges) {
+                    entry.second.merge();
+                }
+                faceRenderer.setIndexRanges(faceRanges);
+
+                if (opaquePass) {
+                    m_edgeRanges->merge();
+                    m_edgeRenderer.setIndexRanges(m_edgeRanges);
+                }
+            }
+        }
+
+        /**
+         * The arrays are compacted once the holes left by removed brushes take up more than this fraction of them.
+         */
+        static constexpr double CompactionThreshold = 0.25;
+
+        /**
+         * The maximum number of elements moved per array and frame while compacting.
+         */
+        static constexpr size_t MaxCompactionMoveSize = 64u * 1024u;
+
+        static void compactIndices(std::unordered_map<const Assets::Texture*, std::shared_ptr<BrushIndexArray>>& indicesMap) {
+            for (auto& [texture, indices] : indicesMap) {
+                if (indices->shouldCompact(CompactionThreshold)) {
+                    indices->compact(MaxCompactionMoveSize);
+                }
+            }
+        }
+
+        static void rebaseIndices(BrushIndexArray& indices, AllocationTracker::Block* key, const GLuint vertexOffset) {
+            GLuint* dest = indices.getPointerToWriteElements(key);
+            for (size_t i = 0; i < key->size; ++i) {
+                dest[i] -= vertexOffset;
+            }
+        }
+
+        void BrushRenderer::compact() {
+            compactIndices(*m_opaqueFaces);
+            compactIndices(*m_transparentFaces);
+            if (m_edgeIndices->shouldCompact(CompactionThreshold)) {
+                m_edgeIndices->compact(MaxCompactionMoveSize);
+            }
+
+            if (m_vertexArray->shouldCompact(CompactionThreshold)) {
+                // the indices of a brush refer to its vertices by their absolute positions, so they must be rebased
+                // when the vertices move
+                std::unordered_map<const AllocationTracker::Block*, const BrushInfo*> vertexKeyToInfo;
+                vertexKeyToInfo.reserve(m_brushInfo.size());
+                for (const auto& [brush, info] : m_brushInfo) {
+                    vertexKeyToInfo.emplace(info.vertexHolderKey, &info);
+                }
+
+                m_vertexArray->compact(MaxCompactionMoveSize, [&](AllocationTracker::Block* key, const size_t oldPos) {
+                    const BrushInfo& info = *vertexKeyToInfo.at(key);
+                    const auto vertexOffset = static_cast<GLuint>(oldPos - key->pos);
+
+                    if (info.edgeIndicesKey != nullptr) {
+                        rebaseIndices(*m_edgeIndices, info.edgeIndicesKey, vertexOffset);
+                    }
+                    for (const auto& [texture, opaqueKey] : info.opaqueFaceIndicesKeys) {
+                        rebaseIndices(*m_opaqueFaces->at(texture), opaqueKey, vertexOffset);
+                    }
+                    for (const auto& [texture, transparentKey] : info.transparentFaceIndicesKeys) {
+                        rebaseIndices(*m_transparentFaces->at(texture), transparentKey, vertexOffset);
+                    }
+                });
+            }
+        }
+
         void BrushRenderer::renderOpaqueFaces(RenderBatch& renderBatch) {
             m_opaqueFaceRenderer.setGrayscale(m_grayscale);
             m_opaqueFaceRenderer.setTint(m_tint);
@@ -339,17 +476,7 @@ namespace TrenchBroom {
         };
 
         void BrushRenderer::validate() {
-            assert(!valid());
-
-            for (auto brush : m_invalidBrushes) {
-                validateBrush(brush);
-            }
-            m_invalidBrushes.clear();
-            assert(valid());
-
-            m_opaqueFaceRenderer = FaceRenderer(m_vertexArray, m_opaqueFaces, m_faceColor);
-            m_transparentFaceRenderer = FaceRenderer(m_vertexArray, m_transparentFaces, m_faceColor);
-            m_edgeRenderer = IndexedEdgeRenderer(m_vertexArray, m_edgeIndices);
+            validate(kdl::parallel_default_thread_count());
         }
 
         static size_t triIndicesCountForPolygon(const size_t vertexCount) {
@@ -438,56 +565,118 @@ namespace TrenchBroom {
             return false;
         }
 
-        void BrushRenderer::validateBrush(const Model::BrushNode* brush) {
-            assert(m_allBrushes.find(brush) != std::end(m_allBrushes));
-            assert(m_invalidBrushes.find(brush) != std::end(m_invalidBrushes));
-            assert(m_brushInfo.find(brush) == std::end(m_brushInfo));
+        struct BrushRenderer::BrushUpload {
+            /**
+             * The consecutive faces of a brush which share a texture, see
+             * BrushRendererBrushCache::cachedFacesSortedByTexture().
+             */
+            struct TextureGroup {
+                const Assets::Texture* texture;
+                size_t firstFace;
+                size_t lastFace;
+
+                size_t opaqueIndexCount;
+                BrushIndexArray* opaqueIndices;
+                AllocationTracker::Block* opaqueIndicesKey;
+                GLuint* opaqueIndicesDest;
+
+                size_t transparentIndexCount;
+                BrushIndexArray* transparentIndices;
+                AllocationTracker::Block* transparentIndicesKey;
+                GLuint* transparentIndicesDest;
+            };
+
+            const Model::BrushNode* brush;
+            Filter::EdgeRenderPolicy edgePolicy;
+            BrushInfo* info;
+
+            size_t edgeIndexCount;
+            std::vector<TextureGroup> textureGroups;
+
+            BrushVertexArray::Vertex* vertexDest;
+            GLuint* edgeIndicesDest;
+
+            BrushUpload(const Model::BrushNode* i_brush, const Filter::EdgeRenderPolicy i_edgePolicy, BrushInfo* i_info) :
+            brush(i_brush),
+            edgePolicy(i_edgePolicy),
+            info(i_info),
+            edgeIndexCount(0),
+            vertexDest(nullptr),
+            edgeIndicesDest(nullptr) {}
+        };
+
+        /**
+         * Threads are only worth starting if each of them has at least this many brushes to process.
+         */
+        static constexpr size_t MinBrushesPerThread = 256u;
+
+        void BrushRenderer::validate(const size_t threadCount) {
+            assert(!valid());
 
             const FilterWrapper wrapper(*m_filter, m_showHiddenBrushes);
 
             // evaluate filter. only evaluate the filter once per brush.
-            const auto settings = wrapper.markFaces(brush);
-            const auto [facePolicy, edgePolicy] = settings;
+            std::vector<BrushUpload> uploads;
+            uploads.reserve(m_invalidBrushes.size());
+            for (auto brush : m_invalidBrushes) {
+                assert(m_allBrushes.find(brush) != std::end(m_allBrushes));
+                assert(m_brushInfo.find(brush) == std::end(m_brushInfo));
 
-            if (facePolicy == Filter::FaceRenderPolicy::RenderNone &&
-                edgePolicy == Filter::EdgeRenderPolicy::RenderNone) {
-                // NOTE: this skips inserting the brush into m_brushInfo
-                return;
+                const auto [facePolicy, edgePolicy] = wrapper.markFaces(brush);
+                if (facePolicy == Filter::FaceRenderPolicy::RenderNone &&
+                    edgePolicy == Filter::EdgeRenderPolicy::RenderNone) {
+                    // NOTE: this skips inserting the brush into m_brushInfo
+                    continue;
+                }
+
+                uploads.emplace_back(brush, edgePolicy, &m_brushInfo[brush]);
             }
+            m_invalidBrushes.clear();
+            assert(valid());
 
-            BrushInfo& info = m_brushInfo[brush];
+            const auto actualThreadCount = std::min(threadCount, std::max(uploads.size() / MinBrushesPerThread, size_t(1)));
 
-            // collect vertices
-            auto& brushCache = brush->brushRendererBrushCache();
-            brushCache.validateVertexCache(brush);
-            const auto& cachedVertices = brushCache.cachedVertices();
-            ensure(!cachedVertices.empty(), "Brush must have cached vertices");
+            kdl::parallel_for(uploads.size(), [&](const size_t i) {
+                prepareUpload(uploads[i]);
+            }, actualThreadCount);
 
-            assert(m_vertexArray != nullptr);
-            auto [vertBlock, dest] = m_vertexArray->getPointerToInsertVerticesAt(cachedVertices.size());
-            std::memcpy(dest, cachedVertices.data(), cachedVertices.size() * sizeof(*dest));
-            info.vertexHolderKey = vertBlock;
-
-            const auto brushVerticesStartIndex = static_cast<GLuint>(vertBlock->pos);
-
-            // insert edge indices into VBO
-            {
-                const size_t edgeIndexCount = countMarkedEdgeIndices(brush, edgePolicy);
-                if (edgeIndexCount > 0) {
-                    auto [key, insertDest] = m_edgeIndices->getPointerToInsertElementsAt(edgeIndexCount);
-                    info.edgeIndicesKey = key;
-                    getMarkedEdgeIndices(brush, edgePolicy, brushVerticesStartIndex, insertDest);
-                } else {
-                    // it's possible to have no edges to render
-                    // e.g. select all faces of a brush, and the unselected brush renderer
-                    // will hit this branch.
-                    ensure(info.edgeIndicesKey == nullptr, "BrushInfo not initialized");
+            // the arrays may grow while allocating, so the pointers to write to can only be obtained afterwards
+            for (auto& upload : uploads) {
+                allocateUpload(upload);
+            }
+            for (auto& upload : uploads) {
+                upload.vertexDest = m_vertexArray->getPointerToWriteVertices(upload.info->vertexHolderKey);
+                if (upload.info->edgeIndicesKey != nullptr) {
+                    upload.edgeIndicesDest = m_edgeIndices->getPointerToWriteElements(upload.info->edgeIndicesKey);
+                }
+                for (auto& group : upload.textureGroups) {
+                    if (group.opaqueIndexCount > 0) {
+                        group.opaqueIndicesDest = group.opaqueIndices->getPointerToWriteElements(group.opaqueIndicesKey);
+                    }
+                    if (group.transparentIndexCount > 0) {
+                        group.transparentIndicesDest = group.transparentIndices->getPointerToWriteElements(group.transparentIndicesKey);
+                    }
                 }
             }
 
-            // insert face indices
+            kdl::parallel_for(uploads.size(), [&](const size_t i) {
+                writeUpload(uploads[i]);
+            }, actualThreadCount);
+
+            m_opaqueFaceRenderer = FaceRenderer(m_vertexArray, m_opaqueFaces, m_faceColor);
+            m_transparentFaceRenderer = FaceRenderer(m_vertexArray, m_transparentFaces, m_faceColor);
+            m_edgeRenderer = IndexedEdgeRenderer(m_vertexArray, m_edgeIndices);
+        }
+
+        void BrushRenderer::prepareUpload(BrushUpload& upload) const {
+            const auto* brush = upload.brush;
+
+            auto& brushCache = brush->brushRendererBrushCache();
+            brushCache.validateVertexCache(brush);
+
+            upload.edgeIndexCount = countMarkedEdgeIndices(brush, upload.edgePolicy);
 
-            auto& facesSortedByTex = brushCache.cachedFacesSortedByTexture();
+            const auto& facesSortedByTex = brushCache.cachedFacesSortedByTexture();
             const size_t facesSortedByTexSize = facesSortedByTex.size();
 
             size_t nextI;
@@ -513,59 +702,97 @@ namespace TrenchBroom {
                     }
                 }
 
-                if (transparentIndexCount > 0) {
-                    TextureToBrushIndicesMap& faceVboMap = *m_transparentFaces;
-                    auto& holderPtr = faceVboMap[texture];
+                if (opaqueIndexCount > 0 || transparentIndexCount > 0) {
+                    upload.textureGroups.push_back({
+                        texture, i, nextI,
+                        opaqueIndexCount, nullptr, nullptr, nullptr,
+                        transparentIndexCount, nullptr, nullptr, nullptr
+                    });
+                }
+            }
+        }
+
+        void BrushRenderer::allocateUpload(BrushUpload& upload) {
+            BrushInfo& info = *upload.info;
+
+            const auto& cachedVertices = upload.brush->brushRendererBrushCache().cachedVertices();
+            ensure(!cachedVertices.empty(), "Brush must have cached vertices");
+
+            assert(m_vertexArray != nullptr);
+            info.vertexHolderKey = m_vertexArray->allocateVertices(cachedVertices.size());
+
+            if (upload.edgeIndexCount > 0) {
+                info.edgeIndicesKey = m_edgeIndices->allocateElements(upload.edgeIndexCount);
+            } else {
+                // it's possible to have no edges to render
+                // e.g. select all faces of a brush, and the unselected brush renderer
+                // will hit this branch.
+                ensure(info.edgeIndicesKey == nullptr, "BrushInfo not initialized");
+            }
+
+            for (auto& group : upload.textureGroups) {
+                if (group.transparentIndexCount > 0) {
+                    auto& holderPtr = (*m_transparentFaces)[group.texture];
                     if (holderPtr == nullptr) {
                         // inserts into map!
                         holderPtr = std::make_shared<BrushIndexArray>();
                     }
 
-                    auto [key, insertDest] = holderPtr->getPointerToInsertElementsAt(transparentIndexCount);
-                    info.transparentFaceIndicesKeys.push_back({texture, key});
-
-                    // process all faces with this texture (they'll be consecutive)
-                    GLuint *currentDest = insertDest;
-                    for (size_t j = i; j < nextI; ++j) {
-                        const BrushRendererBrushCache::CachedFace& cache = facesSortedByTex[j];
-                        if (cache.face->isMarked() && shouldDrawFaceInTransparentPass(brush, *cache.face)) {
-                            addTriIndicesForPolygon(currentDest,
-                                                    static_cast<GLuint>(brushVerticesStartIndex +
-                                                                        cache.indexOfFirstVertexRelativeToBrush),
-                                                    cache.vertexCount);
-
-                            currentDest += triIndicesCountForPolygon(cache.vertexCount);
-                        }
-                    }
-                    assert(currentDest == (insertDest + transparentIndexCount));
+                    group.transparentIndices = holderPtr.get();
+                    group.transparentIndicesKey = holderPtr->allocateElements(group.transparentIndexCount);
+                    info.transparentFaceIndicesKeys.push_back({group.texture, group.transparentIndicesKey});
                 }
 
-                if (opaqueIndexCount > 0) {
-                    TextureToBrushIndicesMap& faceVboMap = *m_opaqueFaces;
-                    auto& holderPtr = faceVboMap[texture];
+                if (group.opaqueIndexCount > 0) {
+                    auto& holderPtr = (*m_opaqueFaces)[group.texture];
                     if (holderPtr == nullptr) {
                         // inserts into map!
                         holderPtr = std::make_shared<BrushIndexArray>();
                     }
 
-                    auto [key, insertDest] = holderPtr->getPointerToInsertElementsAt(opaqueIndexCount);
-                    info.opaqueFaceIndicesKeys.push_back({texture, key});
+                    group.opaqueIndices = holderPtr.get();
+                    group.opaqueIndicesKey = holderPtr->allocateElements(group.opaqueIndexCount);
+                    info.opaqueFaceIndicesKeys.push_back({group.texture, group.opaqueIndicesKey});
+                }
+            }
+        }
 
-                    // process all faces with this texture (they'll be consecutive)
-                    GLuint *currentDest = insertDest;
-                    for (size_t j = i; j < nextI; ++j) {
-                        const BrushRendererBrushCache::CachedFace& cache = facesSortedByTex[j];
-                        if (cache.face->isMarked() && !shouldDrawFaceInTransparentPass(brush, *cache.face)) {
-                            addTriIndicesForPolygon(currentDest,
-                                                    static_cast<GLuint>(brushVerticesStartIndex +
-                                                                        cache.indexOfFirstVertexRelativeToBrush),
-                                                    cache.vertexCount);
+        void BrushRenderer::writeUpload(const BrushUpload& upload) const {
+            const auto* brush = upload.brush;
+            const auto& brushCache = brush->brushRendererBrushCache();
 
-                            currentDest += triIndicesCountForPolygon(cache.vertexCount);
-                        }
+            // copy vertices
+            const auto& cachedVertices = brushCache.cachedVertices();
+            std::memcpy(upload.vertexDest, cachedVertices.data(), cachedVertices.size() * sizeof(*upload.vertexDest));
+
+            const auto brushVerticesStartIndex = static_cast<GLuint>(upload.info->vertexHolderKey->pos);
+
+            // write edge indices
+            if (upload.edgeIndexCount > 0) {
+                getMarkedEdgeIndices(brush, upload.edgePolicy, brushVerticesStartIndex, upload.edgeIndicesDest);
+            }
+
+            // write face indices
+            const auto& facesSortedByTex = brushCache.cachedFacesSortedByTexture();
+            for (const auto& group : upload.textureGroups) {
+                GLuint* opaqueDest = group.opaqueIndicesDest;
+                GLuint* transparentDest = group.transparentIndicesDest;
+
+                // process all faces with this texture (they'll be consecutive)
+                for (size_t j = group.firstFace; j < group.lastFace; ++j) {
+                    const BrushRendererBrushCache::CachedFace& cache = facesSortedByTex[j];
+                    if (cache.face->isMarked()) {
+                        GLuint*& currentDest = shouldDrawFaceInTransparentPass(brush, *cache.face) ? transparentDest : opaqueDest;
+                        addTriIndicesForPolygon(currentDest,
+                                                static_cast<GLuint>(brushVerticesStartIndex +
+                                                                    cache.indexOfFirstVertexRelativeToBrush),
+                                                cache.vertexCount);
+
+                        currentDest += triIndicesCountForPolygon(cache.vertexCount);
                     }
-                    assert(currentDest == (insertDest + opaqueIndexCount));
                 }
+                assert(opaqueDest == (group.opaqueIndicesDest + group.opaqueIndexCount));
+                assert(transparentDest == (group.transparentIndicesDest + group.transparentIndexCount));
             }
         }
 
@@ -146,6 +146,11 @@ namespace TrenchBroom {
             std::shared_ptr<TextureToBrushIndicesMap> m_transparentFaces;
             std::shared_ptr<TextureToBrushIndicesMap> m_opaqueFaces;
 
+            using TextureToIndexRangesMap = std::unordered_map<const Assets::Texture*, IndexRangeList>;
+            std::shared_ptr<TextureToIndexRangesMap> m_opaqueFaceRanges;
+            std::shared_ptr<TextureToIndexRangesMap> m_transparentFaceRanges;
+            std::shared_ptr<IndexRangeList> m_edgeRanges;
+
             FaceRenderer m_opaqueFaceRenderer;
             FaceRenderer m_transparentFaceRenderer;
             IndexedEdgeRenderer m_edgeRenderer;
@@ -162,6 +167,7 @@ namespace TrenchBroom {
             float m_transparencyAlpha;
 
             bool m_showHiddenBrushes;
+            bool m_frustumCulling;
         public:
             template <typename FilterT>
             explicit BrushRenderer(const FilterT& filter) :
@@ -172,7 +178,8 @@ namespace TrenchBroom {
             m_showOccludedEdges(false),
             m_forceTransparent(false),
             m_transparencyAlpha(1.0f),
-            m_showHiddenBrushes(false) {
+            m_showHiddenBrushes(false),
+            m_frustumCulling(false) {
                 clear();
             }
 
@@ -266,11 +273,33 @@ namespace TrenchBroom {
              * Specifies whether or not brushes which are currently hidden should be rendered regardless.
              */
             void setShowHiddenBrushes(bool showHiddenBrushes);
+
+            /**
+             * Specifies whether or not this renderer skips brushes which the render context reports as outside of
+             * the view frustum. Only enable this for renderers whose brushes are part of the node tree that the
+             * render context was culled against, otherwise they would never be considered visible.
+             */
+            void setFrustumCulling(bool frustumCulling);
         public: // rendering
             void render(RenderContext& renderContext, RenderBatch& renderBatch);
             void renderOpaque(RenderContext& renderContext, RenderBatch& renderBatch);
             void renderTransparent(RenderContext& renderContext, RenderBatch& renderBatch);
         private:
+            /**
+             * Collects the index ranges of the brushes which are visible according to the frustum culling information
+             * of the given render context, and passes them to the face and edge renderers of the given pass. Brushes
+             * that are culled in the opaque pass are counted in the given render context.
+             *
+             * If frustum culling is disabled for this renderer or the render context, or if no brush is culled, the
+             * index arrays are rendered completely.
+             */
+            void cull(RenderContext& renderContext, bool opaquePass);
+
+            /**
+             * Incrementally compacts the vertex and index arrays once they become too fragmented by removed brushes.
+             * Each call moves a bounded amount of data, so that the arrays are compacted over several frames.
+             */
+            void compact();
             void renderOpaqueFaces(RenderBatch& renderBatch);
             void renderTransparentFaces(RenderBatch& renderBatch);
             void renderEdges(RenderBatch& renderBatch);
@@ -280,9 +309,37 @@ namespace TrenchBroom {
              * Only exposed for benchmarking.
              */
             void validate();
+
+            /**
+             * Validates the invalid brushes, using up to the given number of threads to build their vertices and
+             * indices. Only the allocation of space in the vertex and index arrays happens on the calling thread, and
+             * uploading the arrays is deferred until they are rendered.
+             *
+             * Only exposed for benchmarking.
+             */
+            void validate(size_t threadCount);
         private:
+            struct BrushUpload;
+
             bool shouldDrawFaceInTransparentPass(const Model::BrushNode* brush, const Model::BrushFace& face) const;
-            void validateBrush(const Model::BrushNode* brush);
+
+            /**
+             * Builds the vertex cache of the brush to upload and counts its indices. May be called on any thread, as
+             * long as no two threads prepare the same brush.
+             */
+            void prepareUpload(BrushUpload& upload) const;
+
+            /**
+             * Allocates space for the vertices and indices of the given brush in the arrays and records the
+             * allocations in the brush's info. Must be called on the main thread.
+             */
+            void allocateUpload(BrushUpload& upload);
+
+            /**
+             * Writes the vertices and indices of the given brush to the space allocated for them. May be called on any
+             * thread.
+             */
+            void writeUpload(const BrushUpload& upload) const;
             void addBrush(const Model::BrushNode* brush);
             void removeBrush(const Model::BrushNode* brush);
 
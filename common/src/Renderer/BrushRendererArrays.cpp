@@ -68,6 +68,44 @@ namespace TrenchBroom {
             return m_dirtySize == 0;
         }
 
+        // IndexRangeList
+
+        void IndexRangeList::add(const size_t offset, const size_t count) {
+            m_ranges.emplace_back(offset, count);
+        }
+
+        void IndexRangeList::merge() {
+            if (m_ranges.size() < 2u) {
+                return;
+            }
+
+            std::sort(std::begin(m_ranges), std::end(m_ranges));
+
+            size_t last = 0u;
+            for (size_t i = 1u; i < m_ranges.size(); ++i) {
+                auto& [lastOffset, lastCount] = m_ranges[last];
+                const auto& [offset, count] = m_ranges[i];
+                if (lastOffset + lastCount == offset) {
+                    lastCount += count;
+                } else {
+                    m_ranges[++last] = m_ranges[i];
+                }
+            }
+            m_ranges.resize(last + 1u);
+        }
+
+        void IndexRangeList::clear() {
+            m_ranges.clear();
+        }
+
+        bool IndexRangeList::empty() const {
+            return m_ranges.empty();
+        }
+
+        const std::vector<std::pair<size_t, size_t>>& IndexRangeList::ranges() const {
+            return m_ranges;
+        }
+
         // IndexHolder
 
         IndexHolder::IndexHolder() : VboHolder<Index>(VboType::ElementArrayBuffer) {}
@@ -87,6 +125,26 @@ namespace TrenchBroom {
             glAssert(glDrawElements(toGL(primType), renderCount, glType<Index>(), renderOffset));
         }
 
+        void IndexHolder::render(const PrimType primType, const IndexRangeList& ranges) const {
+            const auto& list = ranges.ranges();
+            if (list.size() == 1u) {
+                render(primType, list.front().first, list.front().second);
+                return;
+            }
+
+            std::vector<const GLvoid*> renderOffsets;
+            GLCounts renderCounts;
+            renderOffsets.reserve(list.size());
+            renderCounts.reserve(list.size());
+
+            for (const auto& [offset, count] : list) {
+                renderOffsets.push_back(reinterpret_cast<const GLvoid*>(m_vbo->offset() + sizeof(Index) * offset));
+                renderCounts.push_back(static_cast<GLsizei>(count));
+            }
+
+            glAssert(glMultiDrawElements(toGL(primType), renderCounts.data(), glType<Index>(), renderOffsets.data(), static_cast<GLsizei>(list.size())));
+        }
+
         std::shared_ptr<IndexHolder> IndexHolder::swap(std::vector<IndexHolder::Index> &elements) {
             return std::make_shared<IndexHolder>(elements);
         }
@@ -96,17 +154,17 @@ namespace TrenchBroom {
         // BrushIndexArray
 
         BrushIndexArray::BrushIndexArray() : m_indexHolder(),
-                                             m_allocationTracker(0) {}
+                                             m_allocationTracker(0),
+                                             m_compacting(false) {}
 
         bool BrushIndexArray::hasValidIndices() const {
             return m_allocationTracker.hasAllocations();
         }
 
-        std::pair<AllocationTracker::Block*, GLuint*> BrushIndexArray::getPointerToInsertElementsAt(const size_t elementCount) {
+        AllocationTracker::Block* BrushIndexArray::allocateElements(const size_t elementCount) {
             auto block = m_allocationTracker.allocate(elementCount);
             if (block != nullptr) {
-                GLuint* dest = m_indexHolder.getPointerToWriteElementsTo(block->pos, elementCount);
-                return {block, dest};
+                return block;
             }
 
             // retry
@@ -118,9 +176,11 @@ namespace TrenchBroom {
             // insert again
             block = m_allocationTracker.allocate(elementCount);
             assert(block != nullptr);
+            return block;
+        }
 
-            GLuint* dest = m_indexHolder.getPointerToWriteElementsTo(block->pos, elementCount);
-            return {block, dest};
+        GLuint* BrushIndexArray::getPointerToWriteElements(AllocationTracker::Block* key) {
+            return m_indexHolder.getPointerToWriteElementsTo(key->pos, key->size);
         }
 
         void BrushIndexArray::zeroElementsWithKey(AllocationTracker::Block* key) {
@@ -131,11 +191,39 @@ namespace TrenchBroom {
             m_indexHolder.zeroRange(pos, size);
         }
 
+        double BrushIndexArray::fragmentation() const {
+            return m_allocationTracker.fragmentation();
+        }
+
+        bool BrushIndexArray::shouldCompact(const double fragmentationThreshold) const {
+            return m_compacting || fragmentation() > fragmentationThreshold;
+        }
+
+        void BrushIndexArray::compact(const size_t maxMoveSize) {
+            m_compacting = !m_allocationTracker.compact(maxMoveSize, [&](AllocationTracker::Block* key, const size_t oldPos) {
+                m_indexHolder.moveElementsTo(oldPos, key->pos, key->size);
+
+                // the part of the old range that was not overwritten becomes free and must not be rendered
+                const auto vacatedPos = std::max(oldPos, key->pos + key->size);
+                const auto vacatedSize = oldPos + key->size - vacatedPos;
+                if (vacatedSize > 0) {
+                    m_indexHolder.zeroRange(vacatedPos, vacatedSize);
+                }
+            });
+        }
+
         void BrushIndexArray::render(const PrimType primType) const {
             assert(m_indexHolder.prepared());
             m_indexHolder.render(primType, 0, m_indexHolder.size());
         }
 
+        void BrushIndexArray::render(const PrimType primType, const IndexRangeList& ranges) const {
+            assert(m_indexHolder.prepared());
+            if (!ranges.empty()) {
+                m_indexHolder.render(primType, ranges);
+            }
+        }
+
         bool BrushIndexArray::prepared() const {
             return m_indexHolder.prepared();
         }
@@ -156,13 +244,13 @@ namespace TrenchBroom {
         // BrushVertexArray
 
         BrushVertexArray::BrushVertexArray() : m_vertexHolder(),
-                                               m_allocationTracker(0) {}
+                                               m_allocationTracker(0),
+                                               m_compacting(false) {}
 
-        std::pair<AllocationTracker::Block*, BrushVertexArray::Vertex*> BrushVertexArray::getPointerToInsertVerticesAt(const size_t vertexCount) {
+        AllocationTracker::Block* BrushVertexArray::allocateVertices(const size_t vertexCount) {
             auto block = m_allocationTracker.allocate(vertexCount);
             if (block != nullptr) {
-                Vertex* dest = m_vertexHolder.getPointerToWriteElementsTo(block->pos, vertexCount);
-                return {block, dest};
+                return block;
             }
 
             // retry
@@ -174,9 +262,11 @@ namespace TrenchBroom {
             // insert again
             block = m_allocationTracker.allocate(vertexCount);
             assert(block != nullptr);
+            return block;
+        }
 
-            Vertex* dest = m_vertexHolder.getPointerToWriteElementsTo(block->pos, vertexCount);
-            return {block, dest};
+        BrushVertexArray::Vertex* BrushVertexArray::getPointerToWriteVertices(AllocationTracker::Block* key) {
+            return m_vertexHolder.getPointerToWriteElementsTo(key->pos, key->size);
         }
 
         void BrushVertexArray::deleteVerticesWithKey(AllocationTracker::Block* key) {
@@ -188,6 +278,21 @@ namespace TrenchBroom {
             // us to re-use the space later
         }
 
+        double BrushVertexArray::fragmentation() const {
+            return m_allocationTracker.fragmentation();
+        }
+
+        bool BrushVertexArray::shouldCompact(const double fragmentationThreshold) const {
+            return m_compacting || fragmentation() > fragmentationThreshold;
+        }
+
+        void BrushVertexArray::compact(const size_t maxMoveSize, const AllocationTracker::MoveFunc& moved) {
+            m_compacting = !m_allocationTracker.compact(maxMoveSize, [&](AllocationTracker::Block* key, const size_t oldPos) {
+                m_vertexHolder.moveElementsTo(oldPos, key->pos, key->size);
+                moved(key, oldPos);
+            });
+        }
+
         bool BrushVertexArray::setupVertices() {
             return m_vertexHolder.setupVertices();
         }
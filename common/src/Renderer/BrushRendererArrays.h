@@ -31,9 +31,12 @@
 
 #include <vecmath/vec.h>
 
+#include <algorithm>
 #include <cassert>
+#include <iterator>
 #include <memory>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace TrenchBroom {
@@ -152,6 +155,21 @@ namespace TrenchBroom {
                 return m_snapshot.data() + offsetWithinBlock;
             }
 
+            /**
+             * Moves the given number of elements towards the start and marks the destination range for upload. The
+             * source and destination ranges may overlap.
+             */
+            void moveElementsTo(const size_t fromOffset, const size_t toOffset, const size_t elementCount) {
+                assert(toOffset < fromOffset);
+                assert(fromOffset + elementCount <= m_snapshot.size());
+
+                m_dirtyRange.markDirty(toOffset, elementCount);
+
+                const auto first = std::next(std::begin(m_snapshot), static_cast<std::ptrdiff_t>(fromOffset));
+                std::copy(first, std::next(first, static_cast<std::ptrdiff_t>(elementCount)),
+                          std::next(std::begin(m_snapshot), static_cast<std::ptrdiff_t>(toOffset)));
+            }
+
             bool prepared() const {
                 // NOTE: this returns true if the capacity is 0
                 return m_dirtyRange.clean();
@@ -214,6 +232,31 @@ namespace TrenchBroom {
             }
         };
 
+        /**
+         * A list of ranges of indices to render from an index array. Used to render only the parts of an index array
+         * that belong to visible objects.
+         */
+        class IndexRangeList {
+        private:
+            std::vector<std::pair<size_t, size_t>> m_ranges;
+        public:
+            /**
+             * Adds the range of the given number of indices starting at the given offset.
+             */
+            void add(size_t offset, size_t count);
+
+            /**
+             * Sorts the ranges by their offsets and merges adjacent ranges so that as few ranges as possible need to be
+             * rendered.
+             */
+            void merge();
+
+            void clear();
+            bool empty() const;
+
+            const std::vector<std::pair<size_t, size_t>>& ranges() const;
+        };
+
         class IndexHolder : public VboHolder<GLuint> {
         public:
             using Index = GLuint;
@@ -225,6 +268,7 @@ namespace TrenchBroom {
             explicit IndexHolder(std::vector<Index>& elements);
             void zeroRange(size_t offsetWithinBlock, size_t count);
             void render(PrimType primType, size_t offset, size_t count) const;
+            void render(PrimType primType, const IndexRangeList& ranges) const;
 
             static std::shared_ptr<IndexHolder> swap(std::vector<Index>& elements);
         };
@@ -237,6 +281,7 @@ namespace TrenchBroom {
         private:
             IndexHolder m_indexHolder;
             AllocationTracker m_allocationTracker;
+            bool m_compacting;
         public:
             BrushIndexArray();
 
@@ -251,16 +296,47 @@ namespace TrenchBroom {
              * The VboBlock will be expanded if needed to accommodate the allocation.
              *
              * Returns a AllocationTracker::Block pointer which can be used later in a call to zeroElementsWithKey(),
-             * and also a GLuint pointer where the caller should write `elementCount` GLuint's.
+             * and to obtain the pointer where the caller should write `elementCount` GLuint's by calling
+             * getPointerToWriteElements().
+             */
+            AllocationTracker::Block* allocateElements(size_t elementCount);
+
+            /**
+             * Returns a pointer where the caller should write the indices of the given allocation, and marks them for
+             * upload. The pointer is invalidated by the next call to allocateElements(), but it is safe to write
+             * different allocations on different threads.
              */
-            std::pair<AllocationTracker::Block*, GLuint*> getPointerToInsertElementsAt(size_t elementCount);
+            GLuint* getPointerToWriteElements(AllocationTracker::Block* key);
 
             /**
              * Deletes indices for the given brush and marks the allocation as free.
              */
             void zeroElementsWithKey(AllocationTracker::Block* key);
 
+            /**
+             * Returns the fraction of this array that is taken up by holes left by freed allocations.
+             */
+            double fragmentation() const;
+
+            /**
+             * Returns true if compaction was started and is not yet finished, or if the fragmentation of this array
+             * exceeds the given threshold.
+             */
+            bool shouldCompact(double fragmentationThreshold) const;
+
+            /**
+             * Moves allocations towards the start of this array, moving at most about the given number of indices.
+             * Keys returned by allocateElements() remain valid, but their positions change. Indices that are moved
+             * away from are zeroed.
+             */
+            void compact(size_t maxMoveSize);
+
             void render(const PrimType primType) const;
+            /**
+             * Renders only the given ranges of this array. The ranges must be allocations obtained from
+             * allocateElements() which have not been zeroed.
+             */
+            void render(const PrimType primType, const IndexRangeList& ranges) const;
             bool prepared() const;
             void prepare(VboManager& vboManager);
 
@@ -314,11 +390,13 @@ namespace TrenchBroom {
          * the deleted memory in the VBO, while BrushIndexArray's does.
          */
         class BrushVertexArray {
-        private:
+        public:
             using Vertex = Renderer::GLVertexTypes::P3NT2::Vertex;
+        private:
 
             VertexHolder<Vertex> m_vertexHolder;
             AllocationTracker m_allocationTracker;
+            bool m_compacting;
         public:
             BrushVertexArray();
 
@@ -328,12 +406,38 @@ namespace TrenchBroom {
              * The VboBlock will be expanded if needed to accommodate the allocation.
              *
              * Returns a AllocationTracker::Block pointer which can be used later in a call to deleteVerticesWithKey(),
-             * and also a Vertex pointer where the caller should write `elementCount` Vertex objects.
+             * and to obtain the pointer where the caller should write `vertexCount` Vertex objects by calling
+             * getPointerToWriteVertices().
              */
-            std::pair<AllocationTracker::Block*, Vertex*> getPointerToInsertVerticesAt(size_t vertexCount);
+            AllocationTracker::Block* allocateVertices(size_t vertexCount);
+
+            /**
+             * Returns a pointer where the caller should write the vertices of the given allocation, and marks them for
+             * upload. The pointer is invalidated by the next call to allocateVertices(), but it is safe to write
+             * different allocations on different threads.
+             */
+            Vertex* getPointerToWriteVertices(AllocationTracker::Block* key);
 
             void deleteVerticesWithKey(AllocationTracker::Block* key);
 
+            /**
+             * Returns the fraction of this array that is taken up by holes left by freed allocations.
+             */
+            double fragmentation() const;
+
+            /**
+             * Returns true if compaction was started and is not yet finished, or if the fragmentation of this array
+             * exceeds the given threshold.
+             */
+            bool shouldCompact(double fragmentationThreshold) const;
+
+            /**
+             * Moves allocations towards the start of this array, moving at most about the given number of vertices.
+             * Keys returned by allocateVertices() remain valid, but their positions change, so the caller must
+             * update any indices referring to the moved vertices in the given function.
+             */
+            void compact(size_t maxMoveSize, const AllocationTracker::MoveFunc& moved);
+
             // setting up GL attributes
             bool setupVertices();
             void cleanupVertices();
@@ -25,6 +25,7 @@
 #include "Model/Polyhedron.h"
 
 #include <algorithm>
+#include <utility>
 
 namespace TrenchBroom {
     namespace Renderer {
@@ -68,21 +69,29 @@ namespace TrenchBroom {
             m_cachedFacesSortedByTexture.clear();
             m_cachedFacesSortedByTexture.reserve(brush.faceCount());
 
+            // The brush geometry may be shared with other brushes whose caches are validated concurrently, so the
+            // vertex indices must not be stored in the geometry's vertex payloads. Instead, they are collected in a
+            // flat buffer which is sorted by vertex afterwards. The buffer is reused to avoid allocating it per brush.
+            using VertexIndex = std::pair<const Model::BrushVertex*, GLuint>;
+            thread_local std::vector<VertexIndex> vertexIndices;
+            vertexIndices.clear();
+            vertexIndices.reserve(brush.vertexCount() * 3u);
+
             for (const Model::BrushFace& face : brush.faces()) {
                 const auto indexOfFirstVertexRelativeToBrush = m_cachedVertices.size();
 
                 // The boundary is in CCW order, but the renderer expects CW order:
                 auto& boundary = face.geometry()->boundary();
                 for (auto it = std::rbegin(boundary), end = std::rend(boundary); it != end; ++it) {
-                    Model::BrushHalfEdge* current = *it;
-                    Model::BrushVertex* vertex = current->origin();
+                    const Model::BrushHalfEdge* current = *it;
+                    const Model::BrushVertex* vertex = current->origin();
 
-                    // Set the vertex payload to the index, relative to the brush's first vertex being 0.
+                    // Remember the index of the vertex, relative to the brush's first vertex being 0.
                     // This is used below when building the edge cache.
-                    // NOTE: we'll overwrite the payload as we visit the same vertex several times while visiting
-                    // different faces, this is fine.
+                    // NOTE: we'll record several indices as we visit the same vertex several times while visiting
+                    // different faces, any of them will do.
                     const auto currentIndex = m_cachedVertices.size();
-                    vertex->setPayload(static_cast<GLuint>(currentIndex));
+                    vertexIndices.emplace_back(vertex, static_cast<GLuint>(currentIndex));
 
                     const auto& position = vertex->position();
                     m_cachedVertices.emplace_back(vm::vec3f(position), vm::vec3f(face.boundary().normal), face.textureCoords(position));
@@ -103,6 +112,15 @@ namespace TrenchBroom {
 
             // Build edge index cache
 
+            std::sort(std::begin(vertexIndices), std::end(vertexIndices),
+                      [](const VertexIndex& a, const VertexIndex& b){ return a.first < b.first; });
+            const auto findVertexIndex = [&](const Model::BrushVertex* vertex) {
+                const auto it = std::lower_bound(std::begin(vertexIndices), std::end(vertexIndices), vertex,
+                                                 [](const VertexIndex& a, const Model::BrushVertex* v){ return a.first < v; });
+                assert(it != std::end(vertexIndices) && it->first == vertex);
+                return it->second;
+            };
+
             m_cachedEdges.clear();
             m_cachedEdges.reserve(brush.edgeCount());
 
@@ -114,8 +132,8 @@ namespace TrenchBroom {
                 const auto& face1 = brush.face(*faceIndex1);
                 const auto& face2 = brush.face(*faceIndex2);
                 
-                const auto vertexIndex1RelativeToBrush = currentEdge->firstVertex()->payload();
-                const auto vertexIndex2RelativeToBrush = currentEdge->secondVertex()->payload();
+                const auto vertexIndex1RelativeToBrush = findVertexIndex(currentEdge->firstVertex());
+                const auto vertexIndex2RelativeToBrush = findVertexIndex(currentEdge->secondVertex());
 
                 m_cachedEdges.emplace_back(&face1, &face2, vertexIndex1RelativeToBrush, vertexIndex2RelativeToBrush);
             }
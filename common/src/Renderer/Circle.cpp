@@ -72,6 +72,10 @@ namespace TrenchBroom {
             m_array.prepare(vboManager);
         }
 
+        void Circle::stream(VboManager& vboManager) {
+            m_array.stream(vboManager);
+        }
+
         void Circle::render() {
             m_array.render(m_filled ? PrimType::TriangleFan : PrimType::LineLoop);
         }
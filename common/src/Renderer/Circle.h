@@ -39,6 +39,11 @@ namespace TrenchBroom {
 
             bool prepared() const;
             void prepare(VboManager& vboManager);
+
+            /**
+             * Streams the vertices into a stream buffer of the given VBO manager, see VertexArray::stream.
+             */
+            void stream(VboManager& vboManager);
             void render();
         private:
             void init3D(float radius, size_t segments, vm::axis::type axis, float startAngle, float angleLength);
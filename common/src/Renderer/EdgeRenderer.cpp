@@ -172,10 +172,11 @@ namespace TrenchBroom {
 
         // IndexedEdgeRenderer::Render
 
-        IndexedEdgeRenderer::Render::Render(const EdgeRenderer::Params& params, std::shared_ptr<BrushVertexArray> vertexArray, std::shared_ptr<BrushIndexArray> indexArray) :
+        IndexedEdgeRenderer::Render::Render(const EdgeRenderer::Params& params, std::shared_ptr<BrushVertexArray> vertexArray, std::shared_ptr<BrushIndexArray> indexArray, std::shared_ptr<const IndexRangeList> indexRanges) :
         RenderBase(params),
         m_vertexArray(std::move(vertexArray)),
-        m_indexArray(std::move(indexArray)) {}
+        m_indexArray(std::move(indexArray)),
+        m_indexRanges(std::move(indexRanges)) {}
 
         void IndexedEdgeRenderer::Render::prepareVerticesAndIndices(VboManager& vboManager) {
             m_vertexArray->prepare(vboManager);
@@ -192,7 +193,11 @@ namespace TrenchBroom {
         void IndexedEdgeRenderer::Render::doRenderVertices(RenderContext&) {
             m_vertexArray->setupVertices();
             m_indexArray->setupIndices();
-            m_indexArray->render(PrimType::Lines);
+            if (m_indexRanges != nullptr) {
+                m_indexArray->render(PrimType::Lines, *m_indexRanges);
+            } else {
+                m_indexArray->render(PrimType::Lines);
+            }
             m_vertexArray->cleanupVertices();
             m_indexArray->cleanupIndices();
         }
@@ -207,7 +212,8 @@ namespace TrenchBroom {
 
         IndexedEdgeRenderer::IndexedEdgeRenderer(const IndexedEdgeRenderer& other) :
         m_vertexArray(other.m_vertexArray),
-        m_indexArray(other.m_indexArray) {}
+        m_indexArray(other.m_indexArray),
+        m_indexRanges(other.m_indexRanges) {}
 
         IndexedEdgeRenderer& IndexedEdgeRenderer::operator=(IndexedEdgeRenderer other) {
             using std::swap;
@@ -219,10 +225,15 @@ namespace TrenchBroom {
             using std::swap;
             swap(left.m_vertexArray, right.m_vertexArray);
             swap(left.m_indexArray, right.m_indexArray);
+            swap(left.m_indexRanges, right.m_indexRanges);
+        }
+
+        void IndexedEdgeRenderer::setIndexRanges(std::shared_ptr<const IndexRangeList> indexRanges) {
+            m_indexRanges = std::move(indexRanges);
         }
 
         void IndexedEdgeRenderer::doRender(RenderBatch& renderBatch, const EdgeRenderer::Params& params) {
-            renderBatch.addOneShot(new Render(params, m_vertexArray, m_indexArray));
+            renderBatch.addOneShot(new Render(params, m_vertexArray, m_indexArray, m_indexRanges));
         }
     }
 }
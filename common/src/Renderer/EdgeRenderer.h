@@ -31,6 +31,7 @@ namespace TrenchBroom {
     namespace Renderer {
         class BrushIndexArray;
         class BrushVertexArray;
+        class IndexRangeList;
         class RenderBatch;
 
         class EdgeRenderer {
@@ -106,8 +107,9 @@ namespace TrenchBroom {
             private:
                 std::shared_ptr<BrushVertexArray> m_vertexArray;
                 std::shared_ptr<BrushIndexArray> m_indexArray;
+                std::shared_ptr<const IndexRangeList> m_indexRanges;
             public:
-                Render(const Params& params, std::shared_ptr<BrushVertexArray> vertexArray, std::shared_ptr<BrushIndexArray> indexArray);
+                Render(const Params& params, std::shared_ptr<BrushVertexArray> vertexArray, std::shared_ptr<BrushIndexArray> indexArray, std::shared_ptr<const IndexRangeList> indexRanges);
             private:
                 void prepareVerticesAndIndices(VboManager& vboManager) override;
                 void doRender(RenderContext& renderContext) override;
@@ -116,6 +118,7 @@ namespace TrenchBroom {
         private:
             std::shared_ptr<BrushVertexArray> m_vertexArray;
             std::shared_ptr<BrushIndexArray> m_indexArray;
+            std::shared_ptr<const IndexRangeList> m_indexRanges;
         public:
             IndexedEdgeRenderer();
             IndexedEdgeRenderer(std::shared_ptr<BrushVertexArray> vertexArray, std::shared_ptr<BrushIndexArray> indexArray);
@@ -123,6 +126,11 @@ namespace TrenchBroom {
             IndexedEdgeRenderer(const IndexedEdgeRenderer& other);
             IndexedEdgeRenderer& operator=(IndexedEdgeRenderer other);
 
+            /**
+             * Restricts rendering to the given ranges of the index array. Pass null to render the index array completely.
+             */
+            void setIndexRanges(std::shared_ptr<const IndexRangeList> indexRanges);
+
             friend void swap(IndexedEdgeRenderer& left, IndexedEdgeRenderer& right);
         private:
             void doRender(RenderBatch& renderBatch, const EdgeRenderer::Params& params) override;
@@ -0,0 +1,60 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "EntityModelBatches.h"
+
+#include <cassert>
+
+namespace TrenchBroom {
+    namespace Renderer {
+        EntityModelBatches::EntityModelBatches() :
+        m_instanceCount(0) {}
+
+        void EntityModelBatches::add(TexturedRenderer* renderer, const vm::mat4x4f& transformation) {
+            assert(renderer != nullptr);
+
+            const auto [it, inserted] = m_batchIndices.try_emplace(renderer, m_batches.size());
+            if (inserted) {
+                m_batches.push_back(Batch{renderer, {}});
+            }
+
+            m_batches[it->second].transformations.push_back(transformation);
+            ++m_instanceCount;
+        }
+
+        void EntityModelBatches::clear() {
+            m_batches.clear();
+            m_batchIndices.clear();
+            m_instanceCount = 0;
+        }
+
+        bool EntityModelBatches::empty() const {
+            return m_batches.empty();
+        }
+
+        size_t EntityModelBatches::instanceCount() const {
+            return m_instanceCount;
+        }
+
+        const std::vector<EntityModelBatches::Batch>& EntityModelBatches::batches() const {
+            return m_batches;
+        }
+    }
+}
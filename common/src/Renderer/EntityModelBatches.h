@@ -0,0 +1,77 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef TrenchBroom_EntityModelBatches
+#define TrenchBroom_EntityModelBatches
+
+#include <vecmath/forward.h>
+#include <vecmath/mat.h>
+
+#include <unordered_map>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Renderer {
+        class TexturedRenderer;
+
+        /**
+         * Groups the entity model instances to render in a frame by the renderers of their models. The entity model
+         * manager creates one renderer per model specification, so every batch contains the instances that show the
+         * same model with the same skin and frame. Each batch can then be rendered with its vertices and textures set
+         * up only once.
+         *
+         * The batches are built anew in every frame from the visible entities. Building them does not require an
+         * OpenGL context, and the renderers are never accessed.
+         */
+        class EntityModelBatches {
+        public:
+            struct Batch {
+                TexturedRenderer* renderer;
+                std::vector<vm::mat4x4f> transformations;
+            };
+        private:
+            std::vector<Batch> m_batches;
+            std::unordered_map<TexturedRenderer*, size_t> m_batchIndices;
+            size_t m_instanceCount;
+        public:
+            EntityModelBatches();
+
+            /**
+             * Adds an instance of the model rendered by the given renderer. Instances are kept in the order in which
+             * they were added, and so are the batches.
+             *
+             * @param renderer the renderer of the model to render
+             * @param transformation the model transformation of the instance
+             */
+            void add(TexturedRenderer* renderer, const vm::mat4x4f& transformation);
+
+            /**
+             * Removes all batches.
+             */
+            void clear();
+
+            bool empty() const;
+            size_t instanceCount() const;
+            const std::vector<Batch>& batches() const;
+        };
+    }
+}
+
+#endif /* defined(TrenchBroom_EntityModelBatches) */
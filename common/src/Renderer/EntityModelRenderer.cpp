@@ -32,6 +32,7 @@
 #include "Renderer/ActiveShader.h"
 #include "Renderer/RenderBatch.h"
 #include "Renderer/RenderContext.h"
+#include "Renderer/RenderUtils.h"
 #include "Renderer/Shaders.h"
 #include "Renderer/ShaderManager.h"
 #include "Renderer/TexturedIndexRangeRenderer.h"
@@ -41,6 +42,28 @@
 
 namespace TrenchBroom {
     namespace Renderer {
+        class RenderEntityModelInstance : public InstanceRenderFunc {
+        private:
+            Transformation& m_transformation;
+            ActiveShader& m_shader;
+            const std::vector<vm::mat4x4f>& m_transformations;
+        public:
+            RenderEntityModelInstance(Transformation& transformation, ActiveShader& shader, const std::vector<vm::mat4x4f>& transformations) :
+            m_transformation(transformation),
+            m_shader(shader),
+            m_transformations(transformations) {}
+
+            void before(const size_t index) override {
+                const auto& transformation = m_transformations[index];
+                m_transformation.pushModelMatrix(transformation);
+                m_shader.set("ModelMatrix", transformation);
+            }
+
+            void after(const size_t /* index */) override {
+                m_transformation.popModelMatrix();
+            }
+        };
+
         EntityModelRenderer::EntityModelRenderer(Logger& logger, Assets::EntityModelManager& entityModelManager, const Model::EditorContext& editorContext) :
         m_logger(logger),
         m_entityModelManager(entityModelManager),
@@ -142,20 +165,22 @@ namespace TrenchBroom {
             glAssert(glEnable(GL_TEXTURE_2D));
             glAssert(glActiveTexture(GL_TEXTURE0));
 
+            m_batches.clear();
             for (const auto& entry : m_entities) {
                 auto* entity = entry.first;
                 if (!m_showHiddenEntities && !m_editorContext.visible(entity)) {
                     continue;
                 }
+                if (renderContext.culled(entity)) {
+                    continue;
+                }
 
-                auto* renderer = entry.second;
-
-                const auto transformation = entity->modelTransformation();
-                MultiplyModelMatrix multMatrix(renderContext.transformation(), vm::mat4x4f(transformation));
-
-                shader.set("ModelMatrix", vm::mat4x4f(transformation));
+                m_batches.add(entry.second, vm::mat4x4f(entity->modelTransformation()));
+            }
 
-                renderer->render();
+            for (const auto& batch : m_batches.batches()) {
+                RenderEntityModelInstance func(renderContext.transformation(), shader, batch.transformations);
+                batch.renderer->renderInstances(batch.transformations.size(), func);
             }
         }
     }
@@ -21,6 +21,7 @@
 #define TrenchBroom_EntityModelRenderer
 
 #include "Color.h"
+#include "Renderer/EntityModelBatches.h"
 #include "Renderer/Renderable.h"
 
 #include <map>
@@ -51,6 +52,7 @@ namespace TrenchBroom {
             const Model::EditorContext& m_editorContext;
 
             EntityMap m_entities;
+            EntityModelBatches m_batches;
 
             bool m_applyTinting;
             Color m_tintColor;
@@ -213,13 +213,20 @@ namespace TrenchBroom {
                 renderService.setBackgroundColor(m_overlayBackgroundColor);
 
                 for (const Model::EntityNode* entity : m_entities) {
+                    if (renderContext.culled(entity)) {
+                        continue;
+                    }
                     if (m_showHiddenEntities || m_editorContext.visible(entity)) {
                         if (entity->group() == nullptr || entity->group() == m_editorContext.currentGroup()) {
                             if (m_showOccludedOverlays)
                                 renderService.setShowOccludedObjects();
                             else
                                 renderService.setHideOccludedObjects();
-                            renderService.renderString(entityString(entity), EntityClassnameAnchor(entity));
+
+                            const EntityClassnameAnchor anchor(entity);
+                            if (renderService.isStringVisible(anchor)) {
+                                renderService.renderString(entityString(entity), anchor);
+                            }
                         }
                     }
                 }
@@ -243,6 +250,9 @@ namespace TrenchBroom {
                 if (!m_showHiddenEntities && !m_editorContext.visible(entity)) {
                     continue;
                 }
+                if (renderContext.culled(entity)) {
+                    continue;
+                }
 
                 const auto rotation = vm::mat4x4f(entity->rotation());
                 const auto direction = rotation * vm::vec3f::pos_x();
@@ -37,6 +37,7 @@ namespace TrenchBroom {
     namespace Renderer {
         class BrushIndexArray;
         class BrushVertexArray;
+        class IndexRangeList;
         class RenderBatch;
 
         class FaceRenderer : public IndexedRenderable {
@@ -44,9 +45,11 @@ namespace TrenchBroom {
             struct RenderFunc;
 
             using TextureToBrushIndicesMap = const std::unordered_map<const Assets::Texture*, std::shared_ptr<BrushIndexArray>>;
+            using TextureToIndexRangesMap = const std::unordered_map<const Assets::Texture*, IndexRangeList>;
 
             std::shared_ptr<BrushVertexArray> m_vertexArray;
             std::shared_ptr<TextureToBrushIndicesMap> m_indexArrayMap;
+            std::shared_ptr<TextureToIndexRangesMap> m_indexRangesMap;
             Color m_faceColor;
             bool m_grayscale;
             bool m_tint;
@@ -65,6 +68,12 @@ namespace TrenchBroom {
             void setTintColor(const Color& color);
             void setAlpha(float alpha);
 
+            /**
+             * Restricts rendering to the given ranges of the index arrays. Textures without an entry in the given map are
+             * not rendered at all. Pass null to render the index arrays completely.
+             */
+            void setIndexRanges(std::shared_ptr<TextureToIndexRangesMap> indexRangesMap);
+
             void render(RenderBatch& renderBatch);
             static vm::vec3f gridColorForTexture(const Assets::Texture* texture);
         private:
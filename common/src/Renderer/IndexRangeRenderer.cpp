@@ -31,6 +31,10 @@ namespace TrenchBroom {
             m_vertexArray.prepare(vboManager);
         }
 
+        void IndexRangeRenderer::stream(VboManager& vboManager) {
+            m_vertexArray.stream(vboManager);
+        }
+
         void IndexRangeRenderer::render() {
             if (m_vertexArray.setup()) {
                 m_indexArray.render(m_vertexArray);
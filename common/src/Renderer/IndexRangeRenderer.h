@@ -42,6 +42,11 @@ namespace TrenchBroom {
             IndexRangeRenderer(const VertexArray& vertexArray, const IndexRangeMap& indexArray);
 
             void prepare(VboManager& vboManager);
+
+            /**
+             * Streams the vertices into a stream buffer of the given VBO manager, see VertexArray::stream.
+             */
+            void stream(VboManager& vboManager);
             void render();
         };
     }
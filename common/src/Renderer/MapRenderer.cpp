@@ -33,6 +33,7 @@
 #include "Model/NodeVisitor.h"
 #include "Model/WorldNode.h"
 #include "Renderer/BrushRenderer.h"
+#include "Renderer/Camera.h"
 #include "Renderer/EntityLinkRenderer.h"
 #include "Renderer/ObjectRenderer.h"
 #include "Renderer/RenderBatch.h"
@@ -44,7 +45,10 @@
 #include <kdl/memory_utils.h>
 #include <kdl/vector_set.h>
 
+#include <vecmath/plane.h>
+
 #include <set>
+#include <unordered_set>
 #include <vector>
 
 namespace TrenchBroom {
@@ -188,6 +192,7 @@ namespace TrenchBroom {
 
         void MapRenderer::render(RenderContext& renderContext, RenderBatch& renderBatch) {
             commitPendingChanges();
+            cullNodes(renderContext);
             setupGL(renderBatch);
             renderDefaultOpaque(renderContext, renderBatch);
             renderLockedOpaque(renderContext, renderBatch);
@@ -205,6 +210,53 @@ namespace TrenchBroom {
             document->commitPendingAssets();
         }
 
+        class MapRenderer::CollectVisibleNodes : public Model::ConstNodeVisitor {
+        private:
+            std::unordered_set<const Model::Node*> m_nodes;
+            std::vector<const Model::BrushNode*> m_brushes;
+        public:
+            std::unordered_set<const Model::Node*>& nodes() { return m_nodes; }
+            std::vector<const Model::BrushNode*>& brushes() { return m_brushes; }
+        private:
+            void doVisit(const Model::WorldNode*) override   {}
+            void doVisit(const Model::LayerNode*) override   {}
+            void doVisit(const Model::GroupNode*) override   {}
+
+            void doVisit(const Model::EntityNode* entity) override {
+                m_nodes.insert(entity);
+            }
+
+            void doVisit(const Model::BrushNode* brush) override {
+                m_nodes.insert(brush);
+                m_brushes.push_back(brush);
+            }
+        };
+
+        void MapRenderer::cullNodes(RenderContext& renderContext) {
+            auto document = kdl::mem_lock(m_document);
+            const Model::WorldNode* world = document->world();
+            if (world == nullptr) {
+                return;
+            }
+
+            vm::plane3f topPlane, rightPlane, bottomPlane, leftPlane;
+            renderContext.camera().frustumPlanes(topPlane, rightPlane, bottomPlane, leftPlane);
+
+            const auto frustumPlanes = std::vector<vm::plane3>({
+                vm::plane3(topPlane),
+                vm::plane3(rightPlane),
+                vm::plane3(bottomPlane),
+                vm::plane3(leftPlane)
+            });
+
+            CollectVisibleNodes collect;
+            for (const auto* node : world->findNodesIntersecting(frustumPlanes)) {
+                node->accept(collect);
+            }
+
+            renderContext.setVisibleNodes(std::move(collect.nodes()), std::move(collect.brushes()));
+        }
+
         class SetupGL : public Renderable {
         private:
             void doRender(RenderContext&) override {
@@ -275,6 +327,7 @@ namespace TrenchBroom {
 
             renderer.setBrushFaceColor(pref(Preferences::FaceColor));
             renderer.setBrushEdgeColor(pref(Preferences::EdgeColor));
+            renderer.setFrustumCulling(true);
         }
 
         void MapRenderer::setupSelectionRenderer(ObjectRenderer& renderer) {
@@ -297,6 +350,7 @@ namespace TrenchBroom {
 
             renderer.setBrushFaceColor(pref(Preferences::FaceColor));
             renderer.setBrushEdgeColor(pref(Preferences::SelectedEdgeColor));
+            renderer.setFrustumCulling(true);
         }
 
         void MapRenderer::setupLockedRenderer(ObjectRenderer& renderer) {
@@ -317,6 +371,7 @@ namespace TrenchBroom {
 
             renderer.setBrushFaceColor(pref(Preferences::FaceColor));
             renderer.setBrushEdgeColor(pref(Preferences::LockedEdgeColor));
+            renderer.setFrustumCulling(true);
         }
 
         void MapRenderer::setupEntityLinkRenderer() {
@@ -451,6 +506,7 @@ namespace TrenchBroom {
             document->selectionDidChangeNotifier.addObserver(this, &MapRenderer::selectionDidChange);
             document->textureCollectionsWillChangeNotifier.addObserver(this, &MapRenderer::textureCollectionsWillChange);
             document->entityDefinitionsDidChangeNotifier.addObserver(this, &MapRenderer::entityDefinitionsDidChange);
+            document->entityModelsDidLoadNotifier.addObserver(this, &MapRenderer::entityModelsDidLoad);
             document->modsDidChangeNotifier.addObserver(this, &MapRenderer::modsDidChange);
             document->editorContextDidChangeNotifier.addObserver(this, &MapRenderer::editorContextDidChange);
             document->mapViewConfigDidChangeNotifier.addObserver(this, &MapRenderer::mapViewConfigDidChange);
@@ -476,6 +532,7 @@ namespace TrenchBroom {
                 document->selectionDidChangeNotifier.removeObserver(this, &MapRenderer::selectionDidChange);
                 document->textureCollectionsWillChangeNotifier.removeObserver(this, &MapRenderer::textureCollectionsWillChange);
                 document->entityDefinitionsDidChangeNotifier.removeObserver(this, &MapRenderer::entityDefinitionsDidChange);
+                document->entityModelsDidLoadNotifier.removeObserver(this, &MapRenderer::entityModelsDidLoad);
                 document->modsDidChangeNotifier.removeObserver(this, &MapRenderer::modsDidChange);
                 document->editorContextDidChangeNotifier.removeObserver(this, &MapRenderer::editorContextDidChange);
                 document->mapViewConfigDidChangeNotifier.removeObserver(this, &MapRenderer::mapViewConfigDidChange);
@@ -552,6 +609,14 @@ namespace TrenchBroom {
             invalidateEntityLinkRenderer();
         }
 
+        void MapRenderer::entityModelsDidLoad() {
+            // only the entities' models and bounds have changed, so the brushes need not be uploaded again
+            m_defaultRenderer->invalidateEntities();
+            m_selectionRenderer->invalidateEntities();
+            m_lockedRenderer->invalidateEntities();
+            invalidateEntityLinkRenderer();
+        }
+
         void MapRenderer::modsDidChange() {
             reloadEntityModels();
             invalidateRenderers(Renderer_All);
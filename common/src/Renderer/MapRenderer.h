@@ -83,7 +83,14 @@ namespace TrenchBroom {
         public: // rendering
             void render(RenderContext& renderContext, RenderBatch& renderBatch);
         private:
+            class CollectVisibleNodes;
+
             void commitPendingChanges();
+            /**
+             * Finds the brushes and entities which intersect with the view frustum of the given context's camera using
+             * the world's node tree, and enables frustum culling for the given context.
+             */
+            void cullNodes(RenderContext& renderContext);
             void setupGL(RenderBatch& renderBatch);
             void renderDefaultOpaque(RenderContext& renderContext, RenderBatch& renderBatch);
             void renderDefaultTransparent(RenderContext& renderContext, RenderBatch& renderBatch);
@@ -144,6 +151,7 @@ namespace TrenchBroom {
 
             void textureCollectionsWillChange();
             void entityDefinitionsDidChange();
+            void entityModelsDidLoad();
             void modsDidChange();
 
             void editorContextDidChange();
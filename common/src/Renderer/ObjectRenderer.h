@@ -60,6 +60,10 @@ namespace TrenchBroom {
             void setObjects(const std::vector<Model::GroupNode*>& groups, const std::vector<Model::EntityNode*>& entities, const std::vector<Model::BrushNode*>& brushes);
             void invalidate();
             void invalidateBrushes(const std::vector<Model::BrushNode*>& brushes);
+            /**
+             * Invalidates the entities and groups, but not the brushes, e.g. because the bounds of entities changed.
+             */
+            void invalidateEntities();
             void clear();
             void reloadModels();
         public: // configuration
@@ -90,6 +94,8 @@ namespace TrenchBroom {
             void setBrushEdgeColor(const Color& brushEdgeColor);
 
             void setShowHiddenObjects(bool showHiddenObjects);
+
+            void setFrustumCulling(bool frustumCulling);
         public: // rendering
             void renderOpaque(RenderContext& renderContext, RenderBatch& renderBatch);
             void renderTransparent(RenderContext& renderContext, RenderBatch& renderBatch);
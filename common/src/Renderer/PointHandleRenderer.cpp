@@ -47,8 +47,9 @@ namespace TrenchBroom {
         }
 
         void PointHandleRenderer::doPrepareVertices(VboManager& vboManager) {
-            m_handle.prepare(vboManager);
-            m_highlight.prepare(vboManager);
+            // the point handle renderer is discarded after every frame, so its vertices are streamed
+            m_handle.stream(vboManager);
+            m_highlight.stream(vboManager);
         }
 
         void PointHandleRenderer::doRender(RenderContext& renderContext) {
@@ -159,6 +159,9 @@ namespace TrenchBroom {
             }
         }
 
+        PrimitiveRenderer::PrimitiveRenderer(const bool streamVertices) :
+        m_streamVertices(streamVertices) {}
+
         void PrimitiveRenderer::renderLine(const Color& color, const float lineWidth, const PrimitiveRendererOcclusionPolicy occlusionPolicy, const vm::vec3f& start, const vm::vec3f& end) {
             m_lineMeshes[LineRenderAttributes(color, lineWidth, occlusionPolicy)].addLine(Vertex(start), Vertex(end));
         }
@@ -250,7 +253,11 @@ namespace TrenchBroom {
                 const LineRenderAttributes& attributes = entry.first;
                 IndexRangeMapBuilder<Vertex::Type>& mesh = entry.second;
                 IndexRangeRenderer& renderer = m_lineMeshRenderers.insert(std::make_pair(attributes, IndexRangeRenderer(mesh))).first->second;
-                renderer.prepare(vboManager);
+                if (m_streamVertices) {
+                    renderer.stream(vboManager);
+                } else {
+                    renderer.prepare(vboManager);
+                }
             }
         }
 
@@ -259,7 +266,11 @@ namespace TrenchBroom {
                 const TriangleRenderAttributes& attributes = entry.first;
                 IndexRangeMapBuilder<Vertex::Type>& mesh = entry.second;
                 IndexRangeRenderer& renderer = m_triangleMeshRenderers.insert(std::make_pair(attributes, IndexRangeRenderer(mesh))).first->second;
-                renderer.prepare(vboManager);
+                if (m_streamVertices) {
+                    renderer.stream(vboManager);
+                } else {
+                    renderer.prepare(vboManager);
+                }
             }
         }
 
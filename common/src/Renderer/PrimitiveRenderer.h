@@ -84,7 +84,17 @@ namespace TrenchBroom {
 
             using TriangleMeshRendererMap = std::map<TriangleRenderAttributes, IndexRangeRenderer>;
             TriangleMeshRendererMap m_triangleMeshRenderers;
+
+            bool m_streamVertices;
         public:
+            /**
+             * Creates a new primitive renderer. If the renderer is only rendered in a single frame, its vertices should
+             * be streamed, so that no vertex buffer objects are created for them.
+             *
+             * @param streamVertices whether to stream the vertices
+             */
+            explicit PrimitiveRenderer(bool streamVertices = false);
+
             void renderLine(const Color& color, float lineWidth, PrimitiveRendererOcclusionPolicy occlusionPolicy, const vm::vec3f& start, const vm::vec3f& end);
             void renderLines(const Color& color, float lineWidth, PrimitiveRendererOcclusionPolicy occlusionPolicy, const std::vector<vm::vec3f>& positions);
             void renderLineStrip(const Color& color, float lineWidth, PrimitiveRendererOcclusionPolicy occlusionPolicy, const std::vector<vm::vec3f>& positions);
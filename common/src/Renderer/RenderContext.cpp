@@ -43,7 +43,9 @@ namespace TrenchBroom {
         m_gridSize(4),
         m_hideSelection(false),
         m_tintSelection(true),
-        m_showSelectionGuide(ShowSelectionGuide::Hide) {}
+        m_showSelectionGuide(ShowSelectionGuide::Hide),
+        m_frustumCulling(false),
+        m_culledBrushCount(0) {}
 
         bool RenderContext::render2D() const {
             return m_renderMode == RenderMode::Render2D;
@@ -217,6 +219,36 @@ namespace TrenchBroom {
             setShowSelectionGuide(ShowSelectionGuide::ForceHide);
         }
 
+        void RenderContext::setVisibleNodes(std::unordered_set<const Model::Node*> visibleNodes, std::vector<const Model::BrushNode*> visibleBrushes) {
+            m_frustumCulling = true;
+            m_visibleNodes = std::move(visibleNodes);
+            m_visibleBrushes = std::move(visibleBrushes);
+        }
+
+        bool RenderContext::frustumCulling() const {
+            return m_frustumCulling;
+        }
+
+        const std::unordered_set<const Model::Node*>& RenderContext::visibleNodes() const {
+            return m_visibleNodes;
+        }
+
+        const std::vector<const Model::BrushNode*>& RenderContext::visibleBrushes() const {
+            return m_visibleBrushes;
+        }
+
+        bool RenderContext::culled(const Model::Node* node) const {
+            return m_frustumCulling && m_visibleNodes.count(node) == 0u;
+        }
+
+        size_t RenderContext::culledBrushCount() const {
+            return m_culledBrushCount;
+        }
+
+        void RenderContext::addCulledBrushes(const size_t count) {
+            m_culledBrushCount += count;
+        }
+
         void RenderContext::setShowSelectionGuide(const ShowSelectionGuide showSelectionGuide) {
             switch (showSelectionGuide) {
                 case ShowSelectionGuide::Show:
@@ -25,7 +25,15 @@
 
 #include <vecmath/bbox.h>
 
+#include <unordered_set>
+#include <vector>
+
 namespace TrenchBroom {
+    namespace Model {
+        class BrushNode;
+        class Node;
+    }
+
     namespace Renderer {
         class Camera;
         class FontManager;
@@ -77,6 +85,12 @@ namespace TrenchBroom {
 
             ShowSelectionGuide m_showSelectionGuide;
             vm::bbox3f m_sofMapBounds;
+
+            // frustum culling
+            bool m_frustumCulling;
+            std::unordered_set<const Model::Node*> m_visibleNodes;
+            std::vector<const Model::BrushNode*> m_visibleBrushes;
+            size_t m_culledBrushCount;
         public:
             RenderContext(RenderMode renderMode, const Camera& camera, FontManager& fontManager, ShaderManager& shaderManager);
 
@@ -141,6 +155,28 @@ namespace TrenchBroom {
             void setHideSelectionGuide();
             void setForceShowSelectionGuide();
             void setForceHideSelectionGuide();
+
+            /**
+             * Enables frustum culling and sets the nodes which intersect with the camera's view frustum. Renderers skip
+             * every node which is not contained in the given set. The given brushes must be exactly the brushes
+             * contained in the given set.
+             */
+            void setVisibleNodes(std::unordered_set<const Model::Node*> visibleNodes, std::vector<const Model::BrushNode*> visibleBrushes);
+            bool frustumCulling() const;
+            const std::unordered_set<const Model::Node*>& visibleNodes() const;
+            const std::vector<const Model::BrushNode*>& visibleBrushes() const;
+
+            /**
+             * Indicates whether the given node is outside of the camera's view frustum and need not be rendered. Always
+             * returns false if frustum culling is disabled.
+             */
+            bool culled(const Model::Node* node) const;
+
+            /**
+             * Returns the number of brushes which were skipped because they are outside of the camera's view frustum.
+             */
+            size_t culledBrushCount() const;
+            void addCulledBrushes(size_t count);
         private:
             void setShowSelectionGuide(ShowSelectionGuide showSelectionGuide);
         private:
@@ -70,7 +70,7 @@ namespace TrenchBroom {
         m_renderBatch(renderBatch),
         m_textRenderer(std::make_unique<TextRenderer>(makeRenderServiceFont())),
         m_pointHandleRenderer(std::make_unique<PointHandleRenderer>()),
-        m_primitiveRenderer(std::make_unique<PrimitiveRenderer>()),
+        m_primitiveRenderer(std::make_unique<PrimitiveRenderer>(true)),
         m_foregroundColor(1.0f, 1.0f, 1.0f, 1.0f),
         m_backgroundColor(0.0f, 0.0f, 0.0f, 1.0f),
         m_lineWidth(1.0f),
@@ -117,6 +117,10 @@ namespace TrenchBroom {
             renderString(string, SimpleTextAnchor(position, TextAlignment::Bottom, vm::vec2f(0.0f, 16.0f)));
         }
 
+        bool RenderService::isStringVisible(const TextAnchor& position) const {
+            return m_textRenderer->isVisible(m_renderContext, position, m_occlusionPolicy != PrimitiveRendererOcclusionPolicy::Hide);
+        }
+
         void RenderService::renderString(const AttrString& string, const TextAnchor& position) {
             if (m_occlusionPolicy != PrimitiveRendererOcclusionPolicy::Hide) {
                 m_textRenderer->renderStringOnTop(m_renderContext, m_foregroundColor, m_backgroundColor, string, position);
@@ -76,6 +76,12 @@ namespace TrenchBroom {
             void setShowBackfaces();
             void setCullBackfaces();
 
+            /**
+             * Indicates whether a string at the given position might be rendered with the current occlusion policy.
+             * Call this before building a string that is rendered for many objects, e.g. an entity classname.
+             */
+            bool isStringVisible(const TextAnchor& position) const;
+
             void renderString(const AttrString& string, const vm::vec3f& position);
             void renderString(const AttrString& string, const TextAnchor& position);
             void renderHeadsUp(const AttrString& string);
@@ -52,6 +52,17 @@ namespace TrenchBroom {
             void after(const Assets::Texture* texture) override;
         };
 
+        /**
+         * Callbacks for rendering the same primitives several times, e.g. once for every entity that shows a model.
+         * One callback is called before the primitives are rendered for an instance, and one is called afterwards.
+         */
+        class InstanceRenderFunc {
+        public:
+            virtual ~InstanceRenderFunc();
+            virtual void before(size_t index) = 0;
+            virtual void after(size_t index) = 0;
+        };
+
         std::vector<vm::vec2f> circle2D(float radius, size_t segments);
         std::vector<vm::vec2f> circle2D(float radius, float startAngle, float angleLength, size_t segments);
         std::vector<vm::vec3f> circle2D(float radius, vm::axis::type axis, float startAngle, float angleLength, size_t segments);
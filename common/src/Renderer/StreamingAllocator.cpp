@@ -0,0 +1,120 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "StreamingAllocator.h"
+
+#include <algorithm> // for std::max
+#include <cassert>
+#include <iterator> // for std::next
+
+namespace TrenchBroom {
+    namespace Renderer {
+        const size_t StreamingAllocator::FramesInFlight = 2u;
+
+        StreamingAllocator::StreamingAllocator(const size_t bufferCapacity) :
+        m_bufferCapacity(bufferCapacity),
+        m_current(0u),
+        m_frame(0u),
+        m_bytesThisFrame(0u),
+        m_bytesLastFrame(0u),
+        m_peakBytesPerFrame(0u) {
+            assert(m_bufferCapacity > 0u);
+        }
+
+        void StreamingAllocator::beginFrame() {
+            m_bytesLastFrame = m_bytesThisFrame;
+            m_bytesThisFrame = 0u;
+            ++m_frame;
+        }
+
+        StreamingAllocator::Block StreamingAllocator::allocate(const size_t size, const size_t alignment) {
+            assert(size > 0u);
+            assert(alignment > 0u);
+
+            if (!m_buffers.empty()) {
+                auto& current = m_buffers[m_current];
+                if (current.frame == m_frame) {
+                    const auto offset = (current.used + alignment - 1u) / alignment * alignment;
+                    if (offset + size <= current.capacity) {
+                        m_bytesThisFrame += offset + size - current.used;
+                        m_peakBytesPerFrame = std::max(m_peakBytesPerFrame, m_bytesThisFrame);
+                        current.used = offset + size;
+                        return Block{m_current, offset, false, false};
+                    }
+                }
+            }
+
+            auto newBuffer = false;
+            auto next = m_buffers.empty() ? 0u : (m_current + 1u) % m_buffers.size();
+            if (m_buffers.empty() || !canReuse(m_buffers[next], size)) {
+                next = m_buffers.empty() ? 0u : m_current + 1u;
+                m_buffers.insert(std::next(std::begin(m_buffers), static_cast<std::ptrdiff_t>(next)), Buffer{std::max(m_bufferCapacity, size), 0u, m_frame});
+                newBuffer = true;
+            }
+
+            m_current = next;
+            auto& buffer = m_buffers[m_current];
+            buffer.used = size;
+            buffer.frame = m_frame;
+
+            m_bytesThisFrame += size;
+            m_peakBytesPerFrame = std::max(m_peakBytesPerFrame, m_bytesThisFrame);
+
+            return Block{m_current, 0u, true, newBuffer};
+        }
+
+        size_t StreamingAllocator::bufferCount() const {
+            return m_buffers.size();
+        }
+
+        size_t StreamingAllocator::bufferCapacity(const size_t index) const {
+            assert(index < m_buffers.size());
+            return m_buffers[index].capacity;
+        }
+
+        size_t StreamingAllocator::totalCapacity() const {
+            auto result = size_t(0);
+            for (const auto& buffer : m_buffers) {
+                result += buffer.capacity;
+            }
+            return result;
+        }
+
+        size_t StreamingAllocator::currentFrame() const {
+            return m_frame;
+        }
+
+        size_t StreamingAllocator::bytesThisFrame() const {
+            return m_bytesThisFrame;
+        }
+
+        size_t StreamingAllocator::bytesLastFrame() const {
+            return m_bytesLastFrame;
+        }
+
+        size_t StreamingAllocator::peakBytesPerFrame() const {
+            return m_peakBytesPerFrame;
+        }
+
+        bool StreamingAllocator::canReuse(const Buffer& buffer, const size_t size) const {
+            return buffer.frame + FramesInFlight <= m_frame && buffer.capacity >= size;
+        }
+    }
+}
@@ -0,0 +1,128 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef TrenchBroom_StreamingAllocator
+#define TrenchBroom_StreamingAllocator
+
+#include <cstddef> // for size_t
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Renderer {
+        /**
+         * Sub-allocates the data that is streamed to the GPU in every frame, such as text, handles and guides, from a
+         * ring of large buffers.
+         *
+         * Each frame starts allocating from the next buffer in the ring, and allocates sequentially until the buffer
+         * is full. A buffer is only reused if it was last used at least FramesInFlight frames ago, so that the GPU has
+         * most likely finished reading it. Otherwise, a new buffer is inserted into the ring. The ring therefore grows
+         * until it holds the data of a few frames, and then stops growing.
+         *
+         * This class only does the bookkeeping and is independent of OpenGL. The VBO manager creates the buffers and
+         * protects reused buffers with fences.
+         */
+        class StreamingAllocator {
+        public:
+            static const size_t FramesInFlight;
+
+            struct Block {
+                /**
+                 * The index of the buffer in the ring.
+                 */
+                size_t buffer;
+                /**
+                 * The offset of the block in the buffer, in bytes.
+                 */
+                size_t offset;
+                /**
+                 * Whether this is the first block allocated from its buffer in the current frame.
+                 */
+                bool firstInFrame;
+                /**
+                 * Whether a new buffer was inserted into the ring at the buffer index for this block. All buffers at
+                 * this index and after it have moved back by one.
+                 */
+                bool newBuffer;
+            };
+        private:
+            struct Buffer {
+                size_t capacity;
+                size_t used;
+                size_t frame;
+            };
+
+            size_t m_bufferCapacity;
+            std::vector<Buffer> m_buffers;
+            size_t m_current;
+            size_t m_frame;
+
+            size_t m_bytesThisFrame;
+            size_t m_bytesLastFrame;
+            size_t m_peakBytesPerFrame;
+        public:
+            /**
+             * Creates a new allocator. Blocks larger than the given buffer capacity get a buffer of their own.
+             *
+             * @param bufferCapacity the capacity of the buffers in bytes
+             */
+            explicit StreamingAllocator(size_t bufferCapacity);
+
+            /**
+             * Begins a new frame. All blocks allocated in previous frames must no longer be used.
+             */
+            void beginFrame();
+
+            /**
+             * Allocates a block of the given size. If the returned block indicates that a new buffer is needed, the
+             * caller must insert it at the block's buffer index, using the capacity returned by bufferCapacity.
+             *
+             * @param size the size of the block in bytes, must not be 0
+             * @param alignment the alignment of the block's offset in bytes, must not be 0
+             * @return the allocated block
+             */
+            Block allocate(size_t size, size_t alignment);
+
+            size_t bufferCount() const;
+            size_t bufferCapacity(size_t index) const;
+            size_t totalCapacity() const;
+
+            size_t currentFrame() const;
+
+            /**
+             * Returns the number of bytes allocated in the current frame, including alignment padding.
+             */
+            size_t bytesThisFrame() const;
+
+            /**
+             * Returns the number of bytes allocated in the previous frame, including alignment padding.
+             */
+            size_t bytesLastFrame() const;
+
+            /**
+             * Returns the largest number of bytes allocated in any frame.
+             */
+            size_t peakBytesPerFrame() const;
+        private:
+            bool canReuse(const Buffer& buffer, size_t size) const;
+        };
+    }
+}
+
+#endif /* defined(TrenchBroom_StreamingAllocator) */
@@ -70,6 +70,12 @@ namespace TrenchBroom {
             renderString(renderContext, textColor, backgroundColor, string, position, true);
         }
 
+        bool TextRenderer::isVisible(const RenderContext& renderContext, const TextAnchor& position, const bool onTop) const {
+            const Camera& camera = renderContext.camera();
+            const float distance = camera.perpendicularDistanceTo(position.position(camera));
+            return distance > 0.0f && isInRange(renderContext, distance, onTop);
+        }
+
         void TextRenderer::renderString(RenderContext& renderContext, const Color& textColor, const Color& backgroundColor, const AttrString& string, const TextAnchor& position, const bool onTop) {
 
             const Camera& camera = renderContext.camera();
@@ -77,15 +83,19 @@ namespace TrenchBroom {
             if (distance <= 0.0f)
                 return;
 
-            if (!isVisible(renderContext, string, position, distance, onTop))
+            if (!isInRange(renderContext, distance, onTop))
                 return;
 
             FontManager& fontManager = renderContext.fontManager();
             TextureFont& font = fontManager.font(m_fontDescriptor);
 
-            std::vector<vm::vec2f> vertices = font.quads(string, true);
+            const TextureFont::Layout& layout = font.layout(string);
+            const vm::vec2f& size = layout.size;
+            if (!isOnScreen(camera, position, round(size)))
+                return;
+
+            std::vector<vm::vec2f> vertices = layout.vertices;
             const float alphaFactor = computeAlphaFactor(renderContext, distance, onTop);
-            const vm::vec2f size = font.measure(string);
             const vm::vec3f offset = position.offset(camera, size);
 
             if (onTop)
@@ -98,18 +108,18 @@ namespace TrenchBroom {
                                           Color(backgroundColor, alphaFactor * backgroundColor.a())));
         }
 
-        bool TextRenderer::isVisible(RenderContext& renderContext, const AttrString& string, const TextAnchor& position, const float distance, const bool onTop) const {
+        bool TextRenderer::isInRange(const RenderContext& renderContext, const float distance, const bool onTop) const {
             if (!onTop) {
                 if (renderContext.render3D() && distance > m_maxViewDistance)
                     return false;
                 if (renderContext.render2D() && renderContext.camera().zoom() < m_minZoomFactor)
                     return false;
             }
+            return true;
+        }
 
-            const Camera& camera = renderContext.camera();
+        bool TextRenderer::isOnScreen(const Camera& camera, const TextAnchor& position, const vm::vec2f& size) const {
             const Camera::Viewport& viewport = camera.viewport();
-
-            const vm::vec2f size = stringSize(renderContext, string);
             const vm::vec2f offset = vm::vec2f(position.offset(camera, size)) - m_inset;
             const vm::vec2f actualSize = size + 2.0f * m_inset;
 
@@ -140,12 +150,6 @@ namespace TrenchBroom {
             collection.rectVertexCount += roundedRect2DVertexCount(RectCornerSegments);
         }
 
-        vm::vec2f TextRenderer::stringSize(RenderContext& renderContext, const AttrString& string) const {
-            FontManager& fontManager = renderContext.fontManager();
-            TextureFont& font = fontManager.font(m_fontDescriptor);
-            return round(font.measure(string));
-        }
-
         void TextRenderer::doPrepareVertices(VboManager& vboManager) {
             prepare(m_entries, false, vboManager);
             prepare(m_entriesOnTop, true, vboManager);
@@ -165,8 +169,9 @@ namespace TrenchBroom {
             collection.textArray = VertexArray::move(std::move(textVertices));
             collection.rectArray = VertexArray::move(std::move(rectVertices));
 
-            collection.textArray.prepare(vboManager);
-            collection.rectArray.prepare(vboManager);
+            // the text renderer is discarded after every frame, so its vertices are streamed
+            collection.textArray.stream(vboManager);
+            collection.rectArray.stream(vboManager);
         }
 
         void TextRenderer::addEntry(const Entry& entry, const bool /* onTop */, std::vector<TextVertex>& textVertices, std::vector<RectVertex>& rectVertices) {
@@ -34,6 +34,7 @@
 namespace TrenchBroom {
     namespace Renderer {
         class AttrString;
+        class Camera;
         class RenderContext;
         class TextAnchor;
 
@@ -83,14 +84,25 @@ namespace TrenchBroom {
 
             void renderString(RenderContext& renderContext, const Color& textColor, const Color& backgroundColor, const AttrString& string, const TextAnchor& position);
             void renderStringOnTop(RenderContext& renderContext, const Color& textColor, const Color& backgroundColor, const AttrString& string, const TextAnchor& position);
+
+            /**
+             * Indicates whether a string at the given position might be rendered. Strings that are behind the camera,
+             * too far away or too small to read are culled. This only checks the position, so it is cheap enough to
+             * call before building the string.
+             *
+             * @param renderContext the render context
+             * @param position the position of the string
+             * @param onTop whether the string would be rendered on top of all other objects
+             * @return true if a string at the given position might be rendered and false otherwise
+             */
+            bool isVisible(const RenderContext& renderContext, const TextAnchor& position, bool onTop) const;
         private:
             void renderString(RenderContext& renderContext, const Color& textColor, const Color& backgroundColor, const AttrString& string, const TextAnchor& position, bool onTop);
 
-            bool isVisible(RenderContext& renderContext, const AttrString& string, const TextAnchor& position, float distance, bool onTop) const;
+            bool isInRange(const RenderContext& renderContext, float distance, bool onTop) const;
+            bool isOnScreen(const Camera& camera, const TextAnchor& position, const vm::vec2f& size) const;
             float computeAlphaFactor(const RenderContext& renderContext, float distance, bool onTop) const;
             void addEntry(EntryCollection& collection, const Entry& entry);
-
-            vm::vec2f stringSize(RenderContext& renderContext, const AttrString& string) const;
         private:
             void doPrepareVertices(VboManager& vboManager) override;
             void prepare(EntryCollection& collection, bool onTop, VboManager& vboManager);
@@ -32,6 +32,8 @@
 
 namespace TrenchBroom {
     namespace Renderer {
+        const size_t TextureFont::MaxCachedLayouts = 4096u;
+
         TextureFont::TextureFont(std::unique_ptr<FontTexture> texture, const std::vector<FontGlyph>& glyphs, const int lineHeight, const unsigned char firstChar, const unsigned char charCount) :
         m_texture(std::move(texture)),
         m_glyphs(glyphs),
@@ -227,6 +229,17 @@ namespace TrenchBroom {
             return result;
         }
 
+        const TextureFont::Layout& TextureFont::layout(const AttrString& string) {
+            auto it = m_layouts.find(string);
+            if (it == std::end(m_layouts)) {
+                if (m_layouts.size() >= MaxCachedLayouts) {
+                    m_layouts.clear();
+                }
+                it = m_layouts.emplace(string, Layout{quads(string, true), measure(string)}).first;
+            }
+            return it->second;
+        }
+
         void TextureFont::activate() {
             m_texture->activate();
         }
@@ -20,29 +20,42 @@
 #ifndef TrenchBroom_Font
 #define TrenchBroom_Font
 
+#include "AttrString.h"
 #include "Macros.h"
 
 #include <vecmath/forward.h>
 #include <vecmath/vec.h>
 
+#include <map>
 #include <memory>
 #include <string>
 #include <vector>
 
 namespace TrenchBroom {
     namespace Renderer {
-        class AttrString;
         class FontGlyph;
         class FontTexture;
 
         class TextureFont {
+        public:
+            /**
+             * The clockwise quads and the size of a string rendered with this font.
+             */
+            struct Layout {
+                std::vector<vm::vec2f> vertices;
+                vm::vec2f size;
+            };
         private:
+            static const size_t MaxCachedLayouts;
+
             std::unique_ptr<FontTexture> m_texture;
             std::vector<FontGlyph> m_glyphs;
             int m_lineHeight;
 
             unsigned char m_firstChar;
             unsigned char m_charCount;
+
+            std::map<AttrString, Layout> m_layouts;
         public:
             TextureFont(std::unique_ptr<FontTexture> texture, const std::vector<FontGlyph>& glyphs, int lineHeight, unsigned char firstChar, unsigned char charCount);
             ~TextureFont();
@@ -55,6 +68,16 @@ namespace TrenchBroom {
             std::vector<vm::vec2f> quads(const std::string& string, bool clockwise, const vm::vec2f& offset = vm::vec2f::zero()) const;
             vm::vec2f measure(const std::string& string) const;
 
+            /**
+             * Returns the layout of the given string. Layouts are cached per string, so strings that are rendered in
+             * every frame, such as entity classnames, are only laid out once. The cache is cleared when it grows too
+             * large, so the returned reference is only valid until this function is called again.
+             *
+             * @param string the string to lay out
+             * @return the layout of the given string
+             */
+            const Layout& layout(const AttrString& string);
+
             void activate();
             void deactivate();
         };
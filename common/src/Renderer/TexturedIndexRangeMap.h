@@ -30,6 +30,7 @@ namespace TrenchBroom {
     }
 
     namespace Renderer {
+        class InstanceRenderFunc;
         class TextureRenderFunc;
         class VertexArray;
 
@@ -169,6 +170,18 @@ namespace TrenchBroom {
              */
             void render(VertexArray& vertexArray, TextureRenderFunc& func);
 
+            /**
+             * Renders the primitives stored in this index range map several times using the vertices in the given
+             * vertex array. The primitives are batched by their associated textures, and each texture is activated
+             * only once for all instances. The given render function type provides two callbacks. One is called
+             * before the primitives are rendered for an instance, and one is called afterwards.
+             *
+             * @param vertexArray the vertex array to render with
+             * @param instanceCount the number of times to render the primitives
+             * @param func the instance callbacks
+             */
+            void renderInstances(VertexArray& vertexArray, size_t instanceCount, InstanceRenderFunc& func);
+
             /**
              * Invokes the given function for each primitive stored in this map.
              *
@@ -42,6 +42,12 @@ namespace TrenchBroom {
             m_bufferId = 0;
         }
 
+        void Vbo::orphan(const GLenum usage) {
+            assert(m_bufferId != 0);
+            glAssert(glBindBuffer(m_type, m_bufferId));
+            glAssert(glBufferData(m_type, static_cast<GLsizeiptr>(m_capacity), nullptr, usage));
+        }
+
         Vbo::~Vbo() {
             assert(m_bufferId == 0);
         }
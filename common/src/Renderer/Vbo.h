@@ -56,6 +56,12 @@ namespace TrenchBroom {
              */
             void free();
 
+            /**
+             * Replaces the storage of this buffer with new storage of the same capacity. The contents are initially
+             * unspecified. The buffer can then be written without waiting for the GPU to finish reading the old
+             * contents.
+             */
+            void orphan(GLenum usage);
         public:
             /**
              * Deprecated, always returns 0.
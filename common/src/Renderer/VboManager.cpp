@@ -24,6 +24,8 @@
 #include "Macros.h"
 
 #include <algorithm> // for std::max
+#include <cassert>
+#include <iterator> // for std::next
 
 namespace TrenchBroom {
     namespace Renderer {
@@ -46,17 +48,28 @@ namespace TrenchBroom {
                     return GL_STATIC_DRAW;
                 case VboUsage::DynamicDraw:
                     return GL_DYNAMIC_DRAW;
+                case VboUsage::StreamDraw:
+                    return GL_STREAM_DRAW;
                 switchDefault()
             }
         }
 
         // VboManager
 
+        const size_t VboManager::StreamBufferCapacity = 1024u * 1024u;
+        const size_t VboManager::StreamBlockAlignment = 16u;
+
         VboManager::VboManager(ShaderManager* shaderManager) :
         m_peakVboCount(0u),
         m_currentVboCount(0u),
         m_currentVboSize(0u),
-        m_shaderManager(shaderManager) {}
+        m_shaderManager(shaderManager),
+        m_streamingAllocator(StreamBufferCapacity) {}
+
+        VboManager::~VboManager() {
+            // the stream buffers cannot be released here because the OpenGL context might not be current anymore
+            assert(m_streamVbos.empty());
+        }
 
         Vbo* VboManager::allocateVbo(VboType type, const size_t capacity, const VboUsage usage) {
             auto* result = new Vbo(typeToOpenGL(type), capacity, usageToOpenGL(usage));
@@ -76,6 +89,61 @@ namespace TrenchBroom {
             delete vbo;
         }
 
+        void VboManager::beginFrame() {
+            m_streamingAllocator.beginFrame();
+        }
+
+        void VboManager::endFrame() {
+            for (auto& streamVbo : m_streamVbos) {
+                if (streamVbo.usedInFrame) {
+                    if (GLEW_ARB_sync) {
+                        if (streamVbo.fence != nullptr) {
+                            glAssert(glDeleteSync(streamVbo.fence));
+                        }
+                        streamVbo.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+                    }
+                    streamVbo.usedInFrame = false;
+                }
+            }
+        }
+
+        VboBlock VboManager::allocateStreamBlock(const size_t size) {
+            const auto block = m_streamingAllocator.allocate(size, StreamBlockAlignment);
+            if (block.newBuffer) {
+                auto* vbo = allocateVbo(VboType::ArrayBuffer, m_streamingAllocator.bufferCapacity(block.buffer), VboUsage::StreamDraw);
+                m_streamVbos.insert(std::next(std::begin(m_streamVbos), static_cast<std::ptrdiff_t>(block.buffer)), StreamVbo{vbo, nullptr, false});
+            }
+
+            auto& streamVbo = m_streamVbos[block.buffer];
+            if (block.firstInFrame && !block.newBuffer) {
+                // the GPU may still be reading this buffer if it was used a few frames ago
+                if (streamVbo.fence != nullptr) {
+                    GLenum result;
+                    do {
+                        result = glClientWaitSync(streamVbo.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000u);
+                    } while (result == GL_TIMEOUT_EXPIRED);
+                    glAssert(glDeleteSync(streamVbo.fence));
+                    streamVbo.fence = nullptr;
+                } else {
+                    streamVbo.vbo->orphan(GL_STREAM_DRAW);
+                }
+            }
+            streamVbo.usedInFrame = true;
+
+            return VboBlock{streamVbo.vbo, block.offset};
+        }
+
+        void VboManager::releaseStreamBuffers() {
+            for (auto& streamVbo : m_streamVbos) {
+                if (streamVbo.fence != nullptr) {
+                    glAssert(glDeleteSync(streamVbo.fence));
+                }
+                destroyVbo(streamVbo.vbo);
+            }
+            m_streamVbos.clear();
+            m_streamingAllocator = StreamingAllocator(StreamBufferCapacity);
+        }
+
         size_t VboManager::peakVboCount() const {
             return m_peakVboCount;
         }
@@ -88,6 +156,22 @@ namespace TrenchBroom {
             return m_currentVboSize;
         }
 
+        size_t VboManager::streamBufferCount() const {
+            return m_streamingAllocator.bufferCount();
+        }
+
+        size_t VboManager::streamBufferSize() const {
+            return m_streamingAllocator.totalCapacity();
+        }
+
+        size_t VboManager::streamedBytesLastFrame() const {
+            return m_streamingAllocator.bytesLastFrame();
+        }
+
+        size_t VboManager::peakStreamedBytesPerFrame() const {
+            return m_streamingAllocator.peakBytesPerFrame();
+        }
+
         ShaderManager& VboManager::shaderManager() {
             return *m_shaderManager;
         }
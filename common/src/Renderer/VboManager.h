@@ -21,8 +21,10 @@
 #define TrenchBroom_VboManager
 
 #include "Renderer/GL.h"
+#include "Renderer/StreamingAllocator.h"
 
 #include <cstddef> // for size_t
+#include <vector>
 
 namespace TrenchBroom {
     namespace Renderer {
@@ -36,17 +38,40 @@ namespace TrenchBroom {
 
         enum class VboUsage {
             StaticDraw,
-            DynamicDraw
+            DynamicDraw,
+            StreamDraw
+        };
+
+        /**
+         * A block of a stream buffer, see VboManager::allocateStreamBlock.
+         */
+        struct VboBlock {
+            Vbo* vbo;
+            size_t offset;
         };
 
         class VboManager {
         private:
+            static const size_t StreamBufferCapacity;
+            static const size_t StreamBlockAlignment;
+
+            struct StreamVbo {
+                Vbo* vbo;
+                GLsync fence;
+                bool usedInFrame;
+            };
+
             size_t m_peakVboCount;
             size_t m_currentVboCount;
             size_t m_currentVboSize;
             ShaderManager* m_shaderManager;
+
+            StreamingAllocator m_streamingAllocator;
+            std::vector<StreamVbo> m_streamVbos;
         public:
             explicit VboManager(ShaderManager* shaderManager);
+            ~VboManager();
+
             /**
             * Immediately creates and binds to an OpenGL buffer of the given type and capacity.
             * The contents are initially unspecified. See Vbo class.
@@ -54,10 +79,41 @@ namespace TrenchBroom {
             Vbo* allocateVbo(VboType type, size_t capacity, VboUsage usage = VboUsage::StaticDraw);
             void destroyVbo(Vbo* vbo);
 
+            /**
+             * Begins a new frame. Blocks allocated from the stream buffers in previous frames must no longer be used.
+             */
+            void beginFrame();
+
+            /**
+             * Ends the current frame. If fences are supported, a fence is placed for every stream buffer used in this
+             * frame, so that the buffer is only overwritten once the GPU has finished reading it.
+             */
+            void endFrame();
+
+            /**
+             * Allocates a block of an array buffer for vertices that are only rendered in the current frame. The block
+             * is a part of a large stream buffer, so no buffer is created or deleted for it. The block must not be
+             * used after the current frame has ended, and it is never freed explicitly.
+             *
+             * @param size the size of the block in bytes
+             * @return the allocated block
+             */
+            VboBlock allocateStreamBlock(size_t size);
+
+            /**
+             * Deletes the stream buffers. Must be called while the OpenGL context is current, before it is destroyed.
+             */
+            void releaseStreamBuffers();
+
             size_t peakVboCount() const;
             size_t currentVboCount() const;
             size_t currentVboSize() const;
 
+            size_t streamBufferCount() const;
+            size_t streamBufferSize() const;
+            size_t streamedBytesLastFrame() const;
+            size_t peakStreamedBytesPerFrame() const;
+
             ShaderManager& shaderManager();
         };
     }
@@ -54,6 +54,13 @@ namespace TrenchBroom {
             m_prepared = true;
         }
 
+        void VertexArray::stream(VboManager& vboManager) {
+            if (!prepared() && !empty()) {
+                m_holder->stream(vboManager);
+            }
+            m_prepared = true;
+        }
+
         bool VertexArray::setup() {
             if (empty())
                 return false;
@@ -54,6 +54,7 @@ namespace TrenchBroom {
                 virtual size_t sizeInBytes() const = 0;
 
                 virtual void prepare(VboManager& vboManager) = 0;
+                virtual void stream(VboManager& vboManager) = 0;
                 virtual void setup() = 0;
                 virtual void cleanup() = 0;
             };
@@ -63,6 +64,8 @@ namespace TrenchBroom {
             private:
                 VboManager* m_vboManager;
                 Vbo* m_vbo;
+                size_t m_offset;
+                bool m_streamed;
                 size_t m_vertexCount;
             public:
                 size_t vertexCount() const override {
@@ -81,10 +84,21 @@ namespace TrenchBroom {
                     }
                 }
 
+                void stream(VboManager& vboManager) override {
+                    if (m_vertexCount > 0 && m_vbo == nullptr) {
+                        const auto block = vboManager.allocateStreamBlock(sizeInBytes());
+                        m_vboManager = &vboManager;
+                        m_vbo = block.vbo;
+                        m_offset = block.offset;
+                        m_streamed = true;
+                        m_vbo->writeBuffer(m_offset, doGetVertices());
+                    }
+                }
+
                 void setup() override {
                     ensure(m_vbo != nullptr, "block is null");
                     m_vbo->bind();
-                    VertexSpec::setup(m_vboManager->shaderManager().currentProgram(), m_vbo->offset());
+                    VertexSpec::setup(m_vboManager->shaderManager().currentProgram(), m_offset);
                 }
 
                 void cleanup() override {
@@ -95,12 +109,15 @@ namespace TrenchBroom {
                 Holder(const size_t vertexCount) :
                 m_vboManager(nullptr),
                 m_vbo(nullptr),
+                m_offset(0),
+                m_streamed(false),
                 m_vertexCount(vertexCount) {}
 
                 ~Holder() override {
                     // TODO: Revisit this revisiting OpenGL resource management. We should not store the VboManager,
                     // since it represents a safe time to delete the OpenGL buffer object.
-                    if (m_vbo != nullptr) {
+                    // stream buffers are owned by the VBO manager
+                    if (m_vbo != nullptr && !m_streamed) {
                         m_vboManager->destroyVbo(m_vbo);
                         m_vbo = nullptr;
                     }
@@ -129,6 +146,11 @@ namespace TrenchBroom {
                     Holder<VertexSpec>::prepare(vboManager);
                     kdl::vec_clear_to_zero(m_vertices);
                 }
+
+                void stream(VboManager& vboManager) override {
+                    Holder<VertexSpec>::stream(vboManager);
+                    kdl::vec_clear_to_zero(m_vertices);
+                }
             private:
                 const VertexList& doGetVertices() const override {
                     return m_vertices;
@@ -237,6 +259,15 @@ namespace TrenchBroom {
              */
             void prepare(VboManager& vboManager);
 
+            /**
+             * Prepares this vertex array by uploading its contents into a block of a stream buffer of the given
+             * VBO manager. This avoids creating a vertex buffer object for vertices that are only rendered once. The
+             * vertex array can only be rendered until the VBO manager's current frame ends.
+             *
+             * @param vboManager the VBO manager to allocate the stream block from
+             */
+            void stream(VboManager& vboManager);
+
             /**
              * Sets this vertex array up for rendering. If this vertex array is only rendered once, then there is no
              * need to call this method (or the corresponding cleanup method), since the render methods will perform
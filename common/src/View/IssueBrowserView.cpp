@@ -20,16 +20,23 @@
 #include "IssueBrowserView.h"
 
 #include "Ensure.h"
+#include "Model/BrushNode.h"
 #include "Model/CollectMatchingIssuesVisitor.h"
+#include "Model/EntityNode.h"
+#include "Model/GroupNode.h"
 #include "Model/Issue.h"
 #include "Model/IssueQuickFix.h"
+#include "Model/LayerNode.h"
+#include "Model/NodeVisitor.h"
 #include "Model/WorldNode.h"
 #include "View/MapDocument.h"
 
 #include <kdl/memory_utils.h>
+#include <kdl/parallel.h>
 #include <kdl/vector_utils.h>
 #include <kdl/vector_set.h>
 
+#include <algorithm>
 #include <vector>
 
 #include <QHBoxLayout>
@@ -45,7 +52,8 @@ namespace TrenchBroom {
         m_document(document),
         m_hiddenGenerators(0),
         m_showHiddenIssues(false),
-        m_valid(false) {
+        m_valid(false),
+        m_validationQueued(false) {
             createGui();
             bindEvents();
         }
@@ -115,6 +123,10 @@ namespace TrenchBroom {
          * Updates the MapDocument selection to match the table view
          */
         void IssueBrowserView::updateSelection() {
+            if (!m_valid) {
+                return;
+            }
+
             auto document = kdl::mem_lock(m_document);
 
             std::vector<Model::Node*> nodes;
@@ -129,6 +141,62 @@ namespace TrenchBroom {
             document->select(nodes);
         }
 
+        /**
+         * Collects the nodes whose issues have been invalidated. Invalidating the issues of a node also invalidates
+         * the issues of its ancestors and sometimes of its descendants, so the nodes reported as changed by the document
+         * are not enough.
+         */
+        class IssueBrowserView::CollectNodesWithInvalidIssues : public Model::NodeVisitor {
+        private:
+            std::vector<Model::Node*> m_nodes;
+        public:
+            const std::vector<Model::Node*>& nodes() const {
+                return m_nodes;
+            }
+        private:
+            void doVisit(Model::WorldNode* world) override   { collect(world);  }
+            void doVisit(Model::LayerNode* layer) override   { collect(layer);  }
+            void doVisit(Model::GroupNode* group) override   { collect(group);  }
+            void doVisit(Model::EntityNode* entity) override { collect(entity); }
+            void doVisit(Model::BrushNode* brush) override   { collect(brush);  }
+
+            void collect(Model::Node* node) {
+                if (!node->issuesValid()) {
+                    m_nodes.push_back(node);
+                }
+            }
+        };
+
+        /**
+         * Generates the issues of a limited number of nodes whose issues are invalid. The nodes are validated on worker
+         * threads, but the UI thread waits for them, so no node can change while its issues are being generated. Since
+         * the number of nodes per step is limited, the UI remains responsive while the issues of a large map are being
+         * validated.
+         *
+         * @return true if the issues of all nodes are valid, and false if this function must be called again
+         */
+        bool IssueBrowserView::validateIssues() {
+            static const size_t MaxNodesPerStep = 4096u;
+
+            auto document = kdl::mem_lock(m_document);
+            Model::WorldNode* world = document->world();
+            if (world == nullptr) {
+                return true;
+            }
+
+            CollectNodesWithInvalidIssues visitor;
+            world->acceptAndRecurse(visitor);
+
+            const std::vector<Model::Node*>& nodes = visitor.nodes();
+            const size_t count = std::min(nodes.size(), MaxNodesPerStep);
+            const std::vector<Model::IssueGenerator*>& issueGenerators = world->registeredIssueGenerators();
+            kdl::parallel_for(count, [&](const size_t i) {
+                nodes[i]->validateIssues(issueGenerators);
+            });
+
+            return count == nodes.size();
+        }
+
         void IssueBrowserView::updateIssues() {
             auto document = kdl::mem_lock(m_document);
             Model::WorldNode* world = document->world();
@@ -148,6 +216,9 @@ namespace TrenchBroom {
 
             auto document = kdl::mem_lock(m_document);
             const std::vector<Model::Issue*> issues = collectIssues(getSelection());
+            if (issues.empty()) {
+                return;
+            }
 
             const Transaction transaction(document, "Apply Quick Fix (" + quickFix->description() + ")");
             updateSelection();
@@ -155,6 +226,11 @@ namespace TrenchBroom {
         }
 
         std::vector<Model::Issue*> IssueBrowserView::collectIssues(const QList<QModelIndex>& indices) const {
+            if (!m_valid) {
+                // some of the displayed issues may have been deleted already
+                return {};
+            }
+
             // Use a vector_set to filter out duplicates.
             // The QModelIndex list returned by getSelection() contains duplicates
             // (not sure why, current row and selected row?)
@@ -170,7 +246,7 @@ namespace TrenchBroom {
         }
 
         std::vector<Model::IssueQuickFix*> IssueBrowserView::collectQuickFixes(const QList<QModelIndex>& indices) const {
-            if (indices.empty()) {
+            if (indices.empty() || !m_valid) {
                 return {};
             }
 
@@ -260,15 +336,30 @@ namespace TrenchBroom {
 
         void IssueBrowserView::invalidate() {
             m_valid = false;
+            queueValidation();
+        }
 
-            QMetaObject::invokeMethod(this, "validate", Qt::QueuedConnection);
+        void IssueBrowserView::queueValidation() {
+            if (!m_validationQueued) {
+                m_validationQueued = true;
+                QMetaObject::invokeMethod(this, "validate", Qt::QueuedConnection);
+            }
         }
 
+        /**
+         * Validates the next batch of nodes. Once all nodes are valid, the table is updated with all of their issues
+         * at once. Otherwise, another validation step is queued so that the event loop can process user input in
+         * between.
+         */
         void IssueBrowserView::validate() {
+            m_validationQueued = false;
             if (!m_valid) {
-                m_valid = true;
-
-                updateIssues();
+                if (validateIssues()) {
+                    m_valid = true;
+                    updateIssues();
+                } else {
+                    queueValidation();
+                }
             }
         }
 
@@ -281,6 +372,9 @@ namespace TrenchBroom {
         void IssueBrowserModel::setIssues(std::vector<Model::Issue*> issues) {
             beginResetModel();
             m_issues = std::move(issues);
+            m_rows = kdl::vec_transform(m_issues, [](const Model::Issue* issue) {
+                return IssueRow{ issue->lineNumber(), QString::fromStdString(issue->description()), issue->hidden() };
+            });
             endResetModel();
         }
 
@@ -292,7 +386,7 @@ namespace TrenchBroom {
             if (parent.isValid()) {
                 return 0;
             }
-            return static_cast<int>(m_issues.size());
+            return static_cast<int>(m_rows.size());
         }
 
         int IssueBrowserModel::columnCount(const QModelIndex& parent) const {
@@ -305,24 +399,24 @@ namespace TrenchBroom {
         QVariant IssueBrowserModel::data(const QModelIndex& index, int role) const {
             if (!index.isValid()
                 || index.row() < 0
-                || index.row() >= static_cast<int>(m_issues.size())
+                || index.row() >= static_cast<int>(m_rows.size())
                 || index.column() < 0
                 || index.column() >= 2) {
                 return QVariant();
             }
 
-            const Model::Issue* issue = m_issues.at(static_cast<size_t>(index.row()));
+            const IssueRow& row = m_rows.at(static_cast<size_t>(index.row()));
 
             if (role == Qt::DisplayRole) {
                 if (index.column() == 0) {
-                    if (issue->lineNumber() > 0) {
-                        return QVariant::fromValue<size_t>(issue->lineNumber());
+                    if (row.lineNumber > 0) {
+                        return QVariant::fromValue<size_t>(row.lineNumber);
                     }
                 } else {
-                    return QVariant(QString::fromStdString(issue->description()));
+                    return QVariant(row.description);
                 }
             } else if (role == Qt::FontRole) {
-                if (issue->hidden()) {
+                if (row.hidden) {
                     // hidden issues are italic
                     QFont italicFont;
                     italicFont.setItalic(true);
@@ -50,6 +50,7 @@ namespace TrenchBroom {
             bool m_showHiddenIssues;
 
             bool m_valid;
+            bool m_validationQueued;
 
             QTableView* m_tableView;
             IssueBrowserModel* m_tableModel;
@@ -66,7 +67,9 @@ namespace TrenchBroom {
         private:
             class IssueVisible;
             class IssueCmp;
+            class CollectNodesWithInvalidIssues;
 
+            bool validateIssues();
             void updateIssues();
 
             std::vector<Model::Issue*> collectIssues(const QList<QModelIndex>& indices) const;
@@ -86,6 +89,7 @@ namespace TrenchBroom {
             void applyQuickFix(const Model::IssueQuickFix* quickFix);
         private:
             void invalidate();
+            void queueValidation();
         public slots:
             void validate();
         };
@@ -93,11 +97,21 @@ namespace TrenchBroom {
         /**
          * Trivial QAbstractTableModel subclass, when the issues list changes,
          * it just refreshes the entire list with beginResetModel()/endResetModel().
+         *
+         * The displayed values are copied from the issues when they are set, because the issues may be deleted while
+         * the issue browser is waiting for the next set of issues to be validated.
          */
         class IssueBrowserModel : public QAbstractTableModel {
             Q_OBJECT
         private:
+            struct IssueRow {
+                size_t lineNumber;
+                QString description;
+                bool hidden;
+            };
+
             std::vector<Model::Issue*> m_issues;
+            std::vector<IssueRow> m_rows;
         public:
             explicit IssueBrowserModel(QObject* parent);
 
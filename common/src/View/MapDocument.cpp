@@ -128,6 +128,7 @@
 #include <kdl/collection_utils.h>
 #include <kdl/map_utils.h>
 #include <kdl/memory_utils.h>
+#include <kdl/parallel.h>
 #include <kdl/vector_utils.h>
 
 #include <vecmath/polygon.h>
@@ -135,9 +136,11 @@
 #include <vecmath/vec.h>
 #include <vecmath/vec_io.h>
 
+#include <algorithm>
 #include <cassert>
 #include <cstdlib> // for std::abs
 #include <map>
+#include <optional>
 #include <sstream>
 #include <string>
 #include <type_traits>
@@ -148,6 +151,11 @@ namespace TrenchBroom {
         const vm::bbox3 MapDocument::DefaultWorldBounds(-16384.0, 16384.0);
         const std::string MapDocument::DefaultDocumentName("unnamed.map");
 
+        static size_t textureMemoryBudget() {
+            const auto budgetInMiB = static_cast<size_t>(std::max(pref(Preferences::TextureMemoryBudget), 0));
+            return budgetInMiB * 1024u * 1024u;
+        }
+
         MapDocument::MapDocument() :
         m_worldBounds(DefaultWorldBounds),
         m_world(nullptr),
@@ -173,6 +181,7 @@ namespace TrenchBroom {
         m_lastSelectionBounds(0.0, 32.0),
         m_selectionBoundsValid(true),
         m_viewEffectsService(nullptr) {
+                m_textureManager->setMemoryBudget(textureMemoryBudget());
                 bindObservers();
         }
 
@@ -629,7 +638,7 @@ namespace TrenchBroom {
         void MapDocument::selectTouching(const bool del) {
             const std::vector<Model::BrushNode*>& brushes = m_selectedNodes.brushes();
 
-            Model::CollectTouchingNodesVisitor<std::vector<Model::BrushNode*>::const_iterator> visitor(std::begin(brushes), std::end(brushes), editorContext());
+            Model::CollectTouchingNodesInWorldVisitor visitor(*m_world, brushes, editorContext());
             m_world->acceptAndRecurse(visitor);
 
             const std::vector<Model::Node*> nodes = visitor.nodes();
@@ -645,7 +654,7 @@ namespace TrenchBroom {
         void MapDocument::selectInside(const bool del) {
             const std::vector<Model::BrushNode*>& brushes = m_selectedNodes.brushes();
 
-            Model::CollectContainedNodesVisitor<std::vector<Model::BrushNode*>::const_iterator> visitor(std::begin(brushes), std::end(brushes), editorContext());
+            Model::CollectContainedNodesInWorldVisitor visitor(*m_world, brushes, editorContext());
             m_world->acceptAndRecurse(visitor);
 
             const std::vector<Model::Node*> nodes = visitor.nodes();
@@ -1561,10 +1570,20 @@ namespace TrenchBroom {
             std::map<Model::Node*, std::vector<Model::Node*>> toAdd;
             std::vector<Model::Node*> toRemove(std::begin(subtrahendNodes), std::end(subtrahendNodes));
             const std::vector<const Model::Brush*> subtrahends = kdl::vec_transform(subtrahendNodes, [](const auto* subtrahendNode) { return &subtrahendNode->brush(); });
-            
-            for (Model::BrushNode* minuendNode : minuendNodes) {
+            const std::string textureName = currentTextureName();
+
+            // The minuends are independent of each other, so they are processed on worker threads. Every minuend is
+            // cut by all subtrahends, since a subtrahend may split a minuend along its planes even if they don't
+            // intersect. The results are kept in the order of the minuends so that the added nodes do not depend on
+            // the order in which the threads finish.
+            std::vector<std::vector<Model::Brush>> results = kdl::vec_parallel_transform(minuendNodes, [&](const Model::BrushNode* minuendNode) {
                 const Model::Brush& minuend = minuendNode->brush();
-                std::vector<Model::Brush> resultBrushes = minuend.subtract(*m_world, m_worldBounds, currentTextureName(), subtrahends);
+                return minuend.subtract(*m_world, m_worldBounds, textureName, subtrahends);
+            });
+
+            for (size_t i = 0u; i < minuendNodes.size(); ++i) {
+                Model::BrushNode* minuendNode = minuendNodes[i];
+                std::vector<Model::Brush>& resultBrushes = results[i];
                 if (!resultBrushes.empty()) {
                     const std::vector<Model::BrushNode*> resultNodes = kdl::vec_transform(std::move(resultBrushes), [&](auto brush) { return m_world->createBrush(std::move(brush)); });
                     kdl::vec_append(toAdd[minuendNode->parent()], resultNodes);
@@ -1626,14 +1645,26 @@ namespace TrenchBroom {
             std::map<Model::Node*, std::vector<Model::Node*>> toAdd;
             std::vector<Model::Node*> toRemove;
 
-            for (Model::BrushNode* brushNode : brushNodes) {
+            const std::string textureName = currentTextureName();
+            const FloatType wallThickness = static_cast<FloatType>(m_grid->actualSize());
+
+            // hollow the brushes on worker threads, a brush that is too small to be hollowed yields no fragments
+            std::vector<std::optional<std::vector<Model::Brush>>> results = kdl::vec_parallel_transform(brushNodes, [&](const Model::BrushNode* brushNode) -> std::optional<std::vector<Model::Brush>> {
                 const Model::Brush& brush = brushNode->brush();
 
                 // make an shrunken copy of brush
                 Model::Brush shrunken = brush;
-                if (shrunken.expand(m_worldBounds, -1.0 * static_cast<FloatType>(m_grid->actualSize()), true)) {
-                    std::vector<Model::Brush> fragments = brush.subtract(*m_world, m_worldBounds, currentTextureName(), shrunken);
-                    std::vector<Model::BrushNode*> fragmentNodes = kdl::vec_transform(std::move(fragments), [](auto&& b) {
+                if (shrunken.expand(m_worldBounds, -1.0 * wallThickness, true)) {
+                    return brush.subtract(*m_world, m_worldBounds, textureName, shrunken);
+                } else {
+                    return std::nullopt;
+                }
+            });
+
+            for (size_t i = 0u; i < brushNodes.size(); ++i) {
+                Model::BrushNode* brushNode = brushNodes[i];
+                if (results[i]) {
+                    std::vector<Model::BrushNode*> fragmentNodes = kdl::vec_transform(std::move(*results[i]), [](auto&& b) {
                         return new Model::BrushNode(std::move(b));
                     });
 
@@ -2048,6 +2079,9 @@ namespace TrenchBroom {
         }
 
         void MapDocument::reloadTextures() {
+            // entity models are loaded from the game file system in the background
+            m_entityModelManager->waitForPendingModels();
+
             unloadTextures();
             m_game->reloadShaders();
             loadTextures();
@@ -2207,8 +2241,10 @@ namespace TrenchBroom {
                 const auto modelSpec = Assets::safeGetModelSpecification(m_logger, entity->classname(), [&]() {
                     return entity->modelSpecification();
                 });
-                const auto* frame = m_manager.frame(modelSpec);
-                entity->setModelFrame(frame);
+                const auto* frame = m_manager.requestFrame(modelSpec);
+                if (entity->modelFrame() != frame) {
+                    entity->setModelFrame(frame);
+                }
             }
             void doVisit(Model::BrushNode*) override         {}
         };
@@ -2242,6 +2278,15 @@ namespace TrenchBroom {
             Model::Node::acceptAndRecurse(std::begin(nodes), std::end(nodes), visitor);
         }
 
+        void MapDocument::processLoadedEntityModels() {
+            if (m_world == nullptr || m_entityModelManager->collectLoadedModels().empty()) {
+                return;
+            }
+
+            setEntityModels();
+            entityModelsDidLoadNotifier();
+        }
+
         std::vector<IO::Path> MapDocument::externalSearchPaths() const {
             std::vector<IO::Path> searchPaths;
             if (!m_path.isEmpty() && m_path.isAbsolute()) {
@@ -2258,6 +2303,9 @@ namespace TrenchBroom {
         }
 
         void MapDocument::updateGameSearchPaths() {
+            // entity models are loaded from the game file system in the background
+            m_entityModelManager->waitForPendingModels();
+
             const std::vector<IO::Path> additionalSearchPaths = IO::Path::asPaths(mods());
             m_game->setAdditionalSearchPaths(additionalSearchPaths, logger());
         }
@@ -2436,6 +2484,8 @@ namespace TrenchBroom {
         };
 
         void MapDocument::updateAllFaceTags() {
+            m_tagManager->invalidateTextureTags();
+
             InitializeFaceTagsVisitor visitor(*m_tagManager);
             m_world->acceptAndRecurse(visitor);
         }
@@ -2519,6 +2569,7 @@ namespace TrenchBroom {
             if (isGamePathPreference(path)) {
                 const Model::GameFactory& gameFactory = Model::GameFactory::instance();
                 const IO::Path newGamePath = gameFactory.gamePath(m_game->gameName());
+                m_entityModelManager->waitForPendingModels();
                 m_game->setGamePath(newGamePath, logger());
 
                 clearEntityModels();
@@ -2530,6 +2581,13 @@ namespace TrenchBroom {
                        path == Preferences::TextureMagFilter.path()) {
                 m_entityModelManager->setTextureMode(pref(Preferences::TextureMinFilter), pref(Preferences::TextureMagFilter));
                 m_textureManager->setTextureMode(pref(Preferences::TextureMinFilter), pref(Preferences::TextureMagFilter));
+            } else if (path == Preferences::LazyTextureLoading.path()) {
+                if (m_world != nullptr) {
+                    reloadTextures();
+                    setTextures();
+                }
+            } else if (path == Preferences::TextureMemoryBudget.path()) {
+                m_textureManager->setMemoryBudget(textureMemoryBudget());
             }
         }
 
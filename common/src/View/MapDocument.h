@@ -166,6 +166,7 @@ namespace TrenchBroom {
             Notifier<> textureCollectionsDidChangeNotifier;
 
             Notifier<> entityDefinitionsDidChangeNotifier;
+            Notifier<> entityModelsDidLoadNotifier;
             Notifier<> modsDidChangeNotifier;
 
             Notifier<> pointFileWasLoadedNotifier;
@@ -526,6 +527,12 @@ namespace TrenchBroom {
             void setEntityModels(const std::vector<Model::Node*>& nodes);
             void unsetEntityModels();
             void unsetEntityModels(const std::vector<Model::Node*>& nodes);
+        public:
+            /**
+             * Assigns the entity models which have finished loading in the background to the entities using them.
+             * Until then, these entities use the bounds of their definitions.
+             */
+            void processLoadedEntityModels();
         protected: // search paths and mods
             std::vector<IO::Path> externalSearchPaths() const;
             void updateGameSearchPaths();
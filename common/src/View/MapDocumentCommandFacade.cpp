@@ -19,6 +19,7 @@
 
 #include "MapDocumentCommandFacade.h"
 
+#include "Exceptions.h"
 #include "Preferences.h"
 #include "PreferenceManager.h"
 #include "Assets/EntityDefinitionFileSpec.h"
@@ -37,7 +38,6 @@
 #include "Model/Issue.h"
 #include "Model/ModelUtils.h"
 #include "Model/Snapshot.h"
-#include "Model/TransformObjectVisitor.h"
 #include "Model/WorldNode.h"
 #include "Model/NodeVisitor.h"
 #include "View/CommandProcessor.h"
@@ -45,6 +45,7 @@
 #include "View/Selection.h"
 
 #include <kdl/map_utils.h>
+#include <kdl/parallel.h>
 #include <kdl/string_format.h>
 #include <kdl/string_utils.h>
 #include <kdl/vector_set.h>
@@ -53,9 +54,12 @@
 #include <vecmath/segment.h>
 #include <vecmath/polygon.h>
 
+#include <algorithm>
 #include <map>
 #include <memory>
+#include <optional>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace TrenchBroom {
@@ -424,53 +428,104 @@ namespace TrenchBroom {
             groupWasClosedNotifier(previousGroup);
         }
 
-        class CanTransformVisitor : public Model::ConstNodeVisitor, public Model::NodeQuery<bool> {
+        /**
+         * Collects the nodes that change when the visited nodes are transformed. Groups and brush entities are
+         * transformed by transforming their brushes, so only brushes and point entities are collected. For every
+         * brush, the brush entity that is transformed as a whole and contains it is recorded, or null if there is none.
+         */
+        class CollectTransformedNodesVisitor : public Model::NodeVisitor {
         private:
-            vm::mat4x4 m_transform;
-            vm::bbox3 m_worldBounds;
+            std::vector<Model::BrushNode*> m_brushes;
+            std::vector<Model::EntityNode*> m_brushEntities;
+            std::vector<Model::EntityNode*> m_pointEntities;
+            Model::EntityNode* m_currentBrushEntity;
         public:
-            CanTransformVisitor(const vm::mat4x4& transform, const vm::bbox3& worldBounds) :
-                m_transform(transform),
-                m_worldBounds(worldBounds) {}
+            CollectTransformedNodesVisitor() :
+            m_currentBrushEntity(nullptr) {}
+
+            const std::vector<Model::BrushNode*>& brushes() const {
+                return m_brushes;
+            }
+
+            const std::vector<Model::EntityNode*>& brushEntities() const {
+                return m_brushEntities;
+            }
+
+            const std::vector<Model::EntityNode*>& pointEntities() const {
+                return m_pointEntities;
+            }
         private:
-            void doVisit(const Model::WorldNode*) override  { setResult(true); }
-            void doVisit(const Model::LayerNode*) override  { setResult(true); }
-            void doVisit(const Model::GroupNode*) override  { setResult(true); }
-            void doVisit(const Model::EntityNode*) override { setResult(true); }
-            void doVisit(const Model::BrushNode* brushNode) override {
-                const Model::Brush& brush = brushNode->brush();
-                setResult(brush.canTransform(m_transform, m_worldBounds));
+            void doVisit(Model::WorldNode*) override  {}
+            void doVisit(Model::LayerNode*) override  {}
+            void doVisit(Model::GroupNode*) override  {}
+            void doVisit(Model::EntityNode* entity) override {
+                if (!entity->hasChildren()) {
+                    m_pointEntities.push_back(entity);
+                } else {
+                    m_currentBrushEntity = entity;
+                }
             }
-            bool doCombineResults(const bool oldResult, const bool newResult) const override {
-                return newResult && oldResult;
+            void doVisit(Model::BrushNode* brush) override {
+                m_brushes.push_back(brush);
+                m_brushEntities.push_back(brush->parent() == m_currentBrushEntity ? m_currentBrushEntity : nullptr);
             }
         };
 
         bool MapDocumentCommandFacade::performTransform(const vm::mat4x4 &transform, const bool lockTextures) {
-          // Test whether all brushes can be transformed; abort if any fail.
-          CanTransformVisitor canTransform(transform, m_worldBounds);
-          for (const auto* node : m_selectedNodes.nodes()) {
-              node->acceptAndRecurse(canTransform);
-          }
-          if (canTransform.hasResult() && !canTransform.result()) {
-              return false;
-          }
-
-          const std::vector<Model::Node*> &nodes = m_selectedNodes.nodes();
-          const std::vector<Model::Node*> parents = collectParents(nodes);
-
-          Notifier<const std::vector<Model::Node*> &>::NotifyBeforeAndAfter
-              notifyParents(nodesWillChangeNotifier, nodesDidChangeNotifier,
-                            parents);
-          Notifier<const std::vector<Model::Node*> &>::NotifyBeforeAndAfter notifyNodes(
-              nodesWillChangeNotifier, nodesDidChangeNotifier, nodes);
-
-          Model::TransformObjectVisitor visitor(transform, lockTextures,
-                                                m_worldBounds);
-          Model::Node::accept(std::begin(nodes), std::end(nodes), visitor);
-
-          invalidateSelectionBounds();
-          return true;
+            const std::vector<Model::Node*> &nodes = m_selectedNodes.nodes();
+
+            CollectTransformedNodesVisitor collect;
+            for (auto* node : nodes) {
+                node->acceptAndRecurse(collect);
+            }
+
+            // Transform copies of all brushes first and abort if any of them fail. The brushes are independent of
+            // each other, so this is done on worker threads. The results are only applied once all brushes have been
+            // transformed successfully.
+            const auto& brushNodes = collect.brushes();
+            std::vector<std::optional<Model::Brush>> transformedBrushes(brushNodes.size());
+
+            try {
+                const auto threadCount = std::min(kdl::parallel_default_thread_count(), std::max(brushNodes.size() / 64u, size_t(1)));
+                kdl::parallel_for(brushNodes.size(), [&](const size_t i) {
+                    auto brush = brushNodes[i]->brush();
+                    brush.transform(transform, lockTextures, m_worldBounds);
+                    transformedBrushes[i] = std::move(brush);
+                }, threadCount);
+            } catch (const GeometryException&) {
+                return false;
+            }
+
+            const std::vector<Model::Node*> parents = collectParents(nodes);
+
+            Notifier<const std::vector<Model::Node*> &>::NotifyBeforeAndAfter
+                notifyParents(nodesWillChangeNotifier, nodesDidChangeNotifier,
+                              parents);
+            Notifier<const std::vector<Model::Node*> &>::NotifyBeforeAndAfter notifyNodes(
+                nodesWillChangeNotifier, nodesDidChangeNotifier, nodes);
+
+            // Brush entities that are transformed as a whole must be notified of the change themselves, just like
+            // EntityNode::transform does.
+            const auto& brushEntities = collect.brushEntities();
+            std::map<Model::EntityNode*, std::vector<std::pair<Model::BrushNode*, Model::Brush>>> brushesByEntity;
+            for (size_t i = 0u; i < brushNodes.size(); ++i) {
+                if (auto* entityNode = brushEntities[i]) {
+                    brushesByEntity[entityNode].emplace_back(brushNodes[i], std::move(*transformedBrushes[i]));
+                } else {
+                    brushNodes[i]->setBrush(std::move(*transformedBrushes[i]));
+                }
+            }
+
+            for (auto& [entityNode, brushes] : brushesByEntity) {
+                entityNode->setBrushes(std::move(brushes));
+            }
+
+            for (auto* entityNode : collect.pointEntities()) {
+                entityNode->transform(transform, lockTextures, m_worldBounds);
+            }
+
+            invalidateSelectionBounds();
+            return true;
         }
 
         MapDocumentCommandFacade::EntityAttributeSnapshotMap MapDocumentCommandFacade::performSetAttribute(const std::string& name, const std::string& value) {
@@ -37,6 +37,7 @@
 #include "Model/GroupNode.h"
 #include "Model/LayerNode.h"
 #include "Model/Node.h"
+#include "Renderer/VboManager.h"
 #include "View/Actions.h"
 #include "View/Autosaver.h"
 #if !defined __APPLE__
@@ -105,6 +106,7 @@ namespace TrenchBroom {
         m_lastInputTime(std::chrono::system_clock::now()),
         m_autosaver(std::make_unique<Autosaver>(m_document)),
         m_autosaveTimer(nullptr),
+        m_entityModelTimer(nullptr),
         m_toolBar(nullptr),
         m_hSplitter(nullptr),
         m_vSplitter(nullptr),
@@ -144,6 +146,10 @@ namespace TrenchBroom {
             m_autosaveTimer = new QTimer(this);
             m_autosaveTimer->start(1000);
 
+            // entity models are loaded in the background and picked up periodically
+            m_entityModelTimer = new QTimer(this);
+            m_entityModelTimer->start(100);
+
             bindObservers();
             bindEvents();
 
@@ -157,6 +163,7 @@ namespace TrenchBroom {
             auto* renderView = findChild<RenderView*>();
             if (renderView != nullptr) {
                 renderView->makeCurrent();
+                m_contextManager->vboManager().releaseStreamBuffers();
             }
 
             // The MapDocument's CachingLogger has a pointer to m_console, which
@@ -678,6 +685,7 @@ namespace TrenchBroom {
 
         void MapFrame::bindEvents() {
             connect(m_autosaveTimer, &QTimer::timeout, this, &MapFrame::triggerAutosave);
+            connect(m_entityModelTimer, &QTimer::timeout, this, &MapFrame::processLoadedEntityModels);
             connect(qApp, &QApplication::focusChanged, this, &MapFrame::focusChange);
             connect(m_gridChoice, QOverload<int>::of(&QComboBox::activated), this, [this](const int index) { setGridSize(index + Grid::MinSize); });
             connect(QApplication::clipboard(), &QClipboard::dataChanged, this, [this]() {
@@ -1727,6 +1735,10 @@ namespace TrenchBroom {
             }
         }
 
+        void MapFrame::processLoadedEntityModels() {
+            m_document->processLoadedEntityModels();
+        }
+
         // DebugPaletteWindow
 
         DebugPaletteWindow::DebugPaletteWindow(QWidget *parent)
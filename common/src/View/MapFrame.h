@@ -80,6 +80,7 @@ namespace TrenchBroom {
             std::chrono::time_point<std::chrono::system_clock> m_lastInputTime;
             std::unique_ptr<Autosaver> m_autosaver;
             QTimer* m_autosaveTimer;
+            QTimer* m_entityModelTimer;
 
             QToolBar* m_toolBar;
 
@@ -366,6 +367,7 @@ namespace TrenchBroom {
             bool eventFilter(QObject* target, QEvent* event) override;
         private:
             void triggerAutosave();
+            void processLoadedEntityModels();
         };
 
         class DebugPaletteWindow : public QDialog {
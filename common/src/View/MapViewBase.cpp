@@ -73,6 +73,7 @@
 #include <vecmath/util.h>
 
 #include <sstream>
+#include <string>
 #include <vector>
 
 #include <QtGlobal>
@@ -134,6 +135,7 @@ namespace TrenchBroom {
             document->selectionDidChangeNotifier.addObserver(this, &MapViewBase::selectionDidChange);
             document->textureCollectionsDidChangeNotifier.addObserver(this, &MapViewBase::textureCollectionsDidChange);
             document->entityDefinitionsDidChangeNotifier.addObserver(this, &MapViewBase::entityDefinitionsDidChange);
+            document->entityModelsDidLoadNotifier.addObserver(this, &MapViewBase::entityModelsDidLoad);
             document->modsDidChangeNotifier.addObserver(this, &MapViewBase::modsDidChange);
             document->editorContextDidChangeNotifier.addObserver(this, &MapViewBase::editorContextDidChange);
             document->mapViewConfigDidChangeNotifier.addObserver(this, &MapViewBase::mapViewConfigDidChange);
@@ -168,6 +170,7 @@ namespace TrenchBroom {
                 document->selectionDidChangeNotifier.removeObserver(this, &MapViewBase::selectionDidChange);
                 document->textureCollectionsDidChangeNotifier.removeObserver(this, &MapViewBase::textureCollectionsDidChange);
                 document->entityDefinitionsDidChangeNotifier.removeObserver(this, &MapViewBase::entityDefinitionsDidChange);
+                document->entityModelsDidLoadNotifier.removeObserver(this, &MapViewBase::entityModelsDidLoad);
                 document->modsDidChangeNotifier.removeObserver(this, &MapViewBase::modsDidChange);
                 document->editorContextDidChangeNotifier.removeObserver(this, &MapViewBase::editorContextDidChange);
                 document->mapViewConfigDidChangeNotifier.removeObserver(this, &MapViewBase::mapViewConfigDidChange);
@@ -236,6 +239,10 @@ namespace TrenchBroom {
             update();
         }
 
+        void MapViewBase::entityModelsDidLoad() {
+            update();
+        }
+
         void MapViewBase::modsDidChange() {
             update();
         }
@@ -978,7 +985,11 @@ namespace TrenchBroom {
             if (pref(Preferences::ShowFPS)) {
                 Renderer::RenderService renderService(renderContext, renderBatch);
 
-                renderService.renderHeadsUp(m_currentFPS);
+                auto text = m_currentFPS;
+                if (renderContext.frustumCulling()) {
+                    text += " " + std::to_string(renderContext.culledBrushCount()) + " brushes culled";
+                }
+                renderService.renderHeadsUp(text);
             }
         }
 
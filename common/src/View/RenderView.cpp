@@ -107,7 +107,10 @@ namespace TrenchBroom {
                     std::to_string(maxFrameTime) + "ms. " +
                     std::to_string(m_glContext->vboManager().currentVboCount()) + " current VBOs (" +
                     std::to_string(m_glContext->vboManager().peakVboCount()) + " peak) totalling " +
-                    std::to_string(m_glContext->vboManager().currentVboSize() / 1024u) + " KiB";
+                    std::to_string(m_glContext->vboManager().currentVboSize() / 1024u) + " KiB, streamed " +
+                    std::to_string(m_glContext->vboManager().streamedBytesLastFrame() / 1024u) + " KiB last frame (" +
+                    std::to_string(m_glContext->vboManager().peakStreamedBytesPerFrame() / 1024u) + " KiB peak) into " +
+                    std::to_string(m_glContext->vboManager().streamBufferCount()) + " stream buffers";
 
 
             });
@@ -158,7 +161,9 @@ namespace TrenchBroom {
         void RenderView::paintGL() {
             if (TrenchBroom::View::isReportingCrash()) return;
 
+            m_glContext->vboManager().beginFrame();
             render();
+            m_glContext->vboManager().endFrame();
 
             // Update stats
             m_framesRendered++;
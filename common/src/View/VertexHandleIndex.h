@@ -0,0 +1,287 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef VertexHandleIndex_h
+#define VertexHandleIndex_h
+
+#include "FloatType.h"
+
+#include <vecmath/bbox.h>
+#include <vecmath/polygon.h>
+#include <vecmath/segment.h>
+#include <vecmath/vec.h>
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace View {
+        /**
+         * Returns the position at which the given handle is stored in a vertex handle index.
+         */
+        inline vm::vec3 handleCenter(const vm::vec3& handle) {
+            return handle;
+        }
+
+        inline vm::vec3 handleCenter(const vm::segment3& handle) {
+            return handle.center();
+        }
+
+        inline vm::vec3 handleCenter(const vm::polygon3& handle) {
+            return handle.center();
+        }
+
+        /**
+         * Returns the bounds of all points that belong to the given handle.
+         */
+        inline vm::bbox3 handleBounds(const vm::vec3& handle) {
+            return vm::bbox3(handle, handle);
+        }
+
+        inline vm::bbox3 handleBounds(const vm::segment3& handle) {
+            return vm::bbox3(vm::min(handle.start(), handle.end()), vm::max(handle.start(), handle.end()));
+        }
+
+        inline vm::bbox3 handleBounds(const vm::polygon3& handle) {
+            vm::bbox3::builder builder;
+            for (const auto& vertex : handle) {
+                builder.add(vertex);
+            }
+            return builder.bounds();
+        }
+
+        /**
+         * A spatial hash of the handle entries of a vertex handle manager. The entries are sorted into the cells of a
+         * uniform grid by the centers of their handles. Every cell also stores the bounds of all handles that were
+         * added to it, which may extend beyond the cell if a handle is an edge or a face.
+         *
+         * Queries by position only need to look at the cells around that position. Ray picks only look at the cells
+         * around the part of the ray that passes through the bounds of all handles, and they test the bounds of each
+         * of these cells before testing the handles in it.
+         *
+         * The index does not own the entries. They must remain at the same address while they are in the index,
+         * which is the case for the values of a std::map.
+         *
+         * @tparam H the handle type
+         * @tparam V the type of the information stored with each handle
+         */
+        template <typename H, typename V>
+        class VertexHandleIndex {
+        public:
+            using Entry = std::pair<const H, V>;
+
+            static constexpr FloatType CellSize = static_cast<FloatType>(64.0);
+        private:
+            using CellKey = std::uint64_t;
+
+            struct Cell {
+                vm::bbox3 bounds;
+                std::vector<Entry*> entries;
+            };
+
+            std::unordered_map<CellKey, Cell> m_cells;
+
+            /**
+             * The bounds of all handles in this index and the maximum distance by which the bounds of a handle extend
+             * beyond its center. Neither is shrunk when entries are removed, so they remain conservative until the
+             * index becomes empty.
+             */
+            vm::bbox3 m_bounds;
+            FloatType m_maxExtent;
+        public:
+            VertexHandleIndex() :
+            m_maxExtent(static_cast<FloatType>(0.0)) {}
+
+            /**
+             * Indicates whether this index contains no entries.
+             */
+            bool empty() const {
+                return m_cells.empty();
+            }
+
+            /**
+             * Returns the bounds of all handles in this index. Only valid if this index is not empty.
+             */
+            const vm::bbox3& bounds() const {
+                return m_bounds;
+            }
+
+            /**
+             * Adds the given entry to this index.
+             */
+            void insert(Entry& entry) {
+                const auto center = handleCenter(entry.first);
+                const auto bounds = handleBounds(entry.first);
+                m_bounds = m_cells.empty() ? bounds : vm::merge(m_bounds, bounds);
+                for (size_t i = 0; i < 3; ++i) {
+                    m_maxExtent = std::max({ m_maxExtent, bounds.max[i] - center[i], center[i] - bounds.min[i] });
+                }
+
+                auto& cell = m_cells[cellKey(center)];
+                cell.bounds = cell.entries.empty() ? bounds : vm::merge(cell.bounds, bounds);
+                cell.entries.push_back(&entry);
+            }
+
+            /**
+             * Removes the given entry from this index. The bounds of its cell are not shrunk, so they remain
+             * conservative until the cell becomes empty.
+             */
+            void remove(Entry& entry) {
+                const auto it = m_cells.find(cellKey(handleCenter(entry.first)));
+                assert(it != std::end(m_cells));
+
+                auto& entries = it->second.entries;
+                const auto entryIt = std::find(std::begin(entries), std::end(entries), &entry);
+                assert(entryIt != std::end(entries));
+
+                *entryIt = entries.back();
+                entries.pop_back();
+
+                if (entries.empty()) {
+                    m_cells.erase(it);
+                    if (m_cells.empty()) {
+                        m_maxExtent = static_cast<FloatType>(0.0);
+                    }
+                }
+            }
+
+            /**
+             * Removes all entries from this index.
+             */
+            void clear() {
+                m_cells.clear();
+                m_maxExtent = static_cast<FloatType>(0.0);
+            }
+
+            /**
+             * Calls the given function for every entry whose handle center may lie within the given bounds. Only the
+             * cells overlapping the given bounds are visited, so the given function must check the handles itself.
+             *
+             * @tparam F the type of the function, must accept an Entry&
+             * @param bounds the bounds to search
+             * @param f the function to call
+             */
+            template <typename F>
+            void findByCenter(const vm::bbox3& bounds, F&& f) const {
+                const auto min = cellCoords(bounds.min);
+                const auto max = cellCoords(bounds.max);
+                for (auto x = min[0]; x <= max[0]; ++x) {
+                    for (auto y = min[1]; y <= max[1]; ++y) {
+                        for (auto z = min[2]; z <= max[2]; ++z) {
+                            const auto it = m_cells.find(cellKey(x, y, z));
+                            if (it != std::end(m_cells)) {
+                                for (auto* entry : it->second.entries) {
+                                    f(*entry);
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+
+            /**
+             * Calls the given function for every entry in every cell whose bounds intersect with the given bounds and
+             * pass the given test. Only the cells whose handles may intersect with the given bounds are visited, or
+             * all cells if there are fewer of them. The test must be conservative, that is, it must accept every cell
+             * that contains a handle that might be hit.
+             *
+             * @tparam T the type of the cell test, must accept a const vm::bbox3& and return bool
+             * @tparam F the type of the function, must accept an Entry&
+             * @param bounds the bounds to search
+             * @param cellTest the cell test
+             * @param f the function to call
+             */
+            template <typename T, typename F>
+            void findByCellBounds(const vm::bbox3& bounds, const T& cellTest, F&& f) const {
+                if (m_cells.empty() || !bounds.intersects(m_bounds)) {
+                    return;
+                }
+
+                const auto visitCell = [&](const Cell& cell) {
+                    if (cell.bounds.intersects(bounds) && cellTest(cell.bounds)) {
+                        for (auto* entry : cell.entries) {
+                            f(*entry);
+                        }
+                    }
+                };
+
+                // the centers of the handles that intersect with the given bounds are at most m_maxExtent away from
+                // them, and the search is limited to the bounds of all handles
+                const auto searchMin = vm::max(bounds.min, m_bounds.min) - vm::vec3::fill(m_maxExtent);
+                const auto searchMax = vm::min(bounds.max, m_bounds.max) + vm::vec3::fill(m_maxExtent);
+                const auto min = cellCoords(searchMin);
+                const auto max = cellCoords(searchMax);
+
+                auto cellCount = 1.0;
+                for (size_t i = 0; i < 3; ++i) {
+                    cellCount *= static_cast<double>(max[i] - min[i] + 1);
+                }
+
+                if (cellCount < static_cast<double>(m_cells.size())) {
+                    for (auto x = min[0]; x <= max[0]; ++x) {
+                        for (auto y = min[1]; y <= max[1]; ++y) {
+                            for (auto z = min[2]; z <= max[2]; ++z) {
+                                const auto it = m_cells.find(cellKey(x, y, z));
+                                if (it != std::end(m_cells)) {
+                                    visitCell(it->second);
+                                }
+                            }
+                        }
+                    }
+                } else {
+                    for (const auto& keyAndCell : m_cells) {
+                        visitCell(keyAndCell.second);
+                    }
+                }
+            }
+        private:
+            static std::array<long, 3> cellCoords(const vm::vec3& position) {
+                std::array<long, 3> result;
+                for (size_t i = 0; i < 3; ++i) {
+                    result[i] = static_cast<long>(std::floor(position[i] / CellSize));
+                }
+                return result;
+            }
+
+            static CellKey cellKey(const vm::vec3& position) {
+                const auto coords = cellCoords(position);
+                return cellKey(coords[0], coords[1], coords[2]);
+            }
+
+            /**
+             * Packs the given cell coordinates into a key, using 21 bits per coordinate. This covers far more than the
+             * maximum world bounds.
+             */
+            static CellKey cellKey(const long x, const long y, const long z) {
+                static const auto mask = (CellKey(1) << 21u) - 1u;
+                return ((static_cast<CellKey>(x) & mask) << 42u)
+                     | ((static_cast<CellKey>(y) & mask) << 21u)
+                     |  (static_cast<CellKey>(z) & mask);
+            }
+        };
+    }
+}
+
+#endif /* VertexHandleIndex_h */
@@ -25,28 +25,113 @@
 #include "Model/Polyhedron.h"
 #include "View/Grid.h"
 
+#include <vecmath/bbox.h>
 #include <vecmath/distance.h>
 #include <vecmath/vec.h>
 #include <vecmath/ray.h>
 #include <vecmath/plane.h>
 #include <vecmath/intersection.h>
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <optional>
+
 namespace TrenchBroom {
     namespace View {
         VertexHandleManagerBase::~VertexHandleManagerBase() {}
 
+        /**
+         * Returns the maximum distance from the given pick ray at which a handle within the given bounds may be hit.
+         * The radius of a handle is scaled by the camera's perspective scaling factor at the handle position. For both
+         * camera types, the absolute value of that factor is a convex function of the position, so its maximum within
+         * the bounds is attained at one of their corners.
+         */
+        static FloatType maxPickDistance(const Renderer::Camera& camera, const FloatType handleRadius, const vm::bbox3& bounds) {
+            auto maxScaling = FloatType(0);
+            for (size_t i = 0; i < 8u; ++i) {
+                vm::vec3 corner;
+                for (size_t j = 0; j < 3u; ++j) {
+                    corner[j] = (i >> j) & 1u ? bounds.max[j] : bounds.min[j];
+                }
+                const auto scaling = std::abs(static_cast<FloatType>(camera.perspectiveScalingFactor(vm::vec3f(corner))));
+                maxScaling = std::max(maxScaling, scaling);
+            }
+
+            // pickPointHandle uses twice the handle radius, and we add some slack for the float conversions
+            return FloatType(2.0) * handleRadius * maxScaling + FloatType(1.0);
+        }
+
+        /**
+         * Returns a conservative test for whether the given pick ray may hit a handle within some bounds.
+         */
+        static auto makeCellTest(const vm::ray3& pickRay, const Renderer::Camera& camera, const FloatType handleRadius) {
+            return [&pickRay, &camera, handleRadius](const vm::bbox3& bounds) {
+                const auto maxDistance = maxPickDistance(camera, handleRadius, bounds) + vm::length(bounds.size()) / FloatType(2.0);
+                return vm::squared_distance(pickRay, bounds.center()).distance <= maxDistance * maxDistance;
+            };
+        }
+
+        /**
+         * Returns the bounds of the part of the given ray that lies within the given bounds, or an empty optional if
+         * the ray misses the bounds.
+         */
+        static std::optional<vm::bbox3> clipRay(const vm::ray3& ray, const vm::bbox3& bounds) {
+            auto minDistance = FloatType(0);
+            auto maxDistance = std::numeric_limits<FloatType>::max();
+            for (size_t i = 0; i < 3u; ++i) {
+                if (ray.direction[i] == FloatType(0)) {
+                    if (ray.origin[i] < bounds.min[i] || ray.origin[i] > bounds.max[i]) {
+                        return std::nullopt;
+                    }
+                } else {
+                    const auto distance1 = (bounds.min[i] - ray.origin[i]) / ray.direction[i];
+                    const auto distance2 = (bounds.max[i] - ray.origin[i]) / ray.direction[i];
+                    minDistance = std::max(minDistance, std::min(distance1, distance2));
+                    maxDistance = std::min(maxDistance, std::max(distance1, distance2));
+                    if (minDistance > maxDistance) {
+                        return std::nullopt;
+                    }
+                }
+            }
+
+            const auto start = vm::point_at_distance(ray, minDistance);
+            const auto end = vm::point_at_distance(ray, maxDistance);
+            return vm::bbox3(vm::min(start, end), vm::max(start, end));
+        }
+
+        /**
+         * Calls the given function for every entry of the given index that may be hit by the given pick ray. Only the
+         * cells around the part of the ray that passes through the bounds of the handles are searched.
+         */
+        template <typename H, typename V, typename F>
+        static void findPickableHandles(const VertexHandleIndex<H, V>& index, const vm::ray3& pickRay, const Renderer::Camera& camera, const FloatType handleRadius, F&& f) {
+            if (index.empty()) {
+                return;
+            }
+
+            // a handle can only be hit from a point on the ray that is within the pick distance of the handle
+            const auto distance = vm::vec3::fill(maxPickDistance(camera, handleRadius, index.bounds()));
+            const auto bounds = vm::bbox3(index.bounds().min - distance, index.bounds().max + distance);
+            if (const auto rayBounds = clipRay(pickRay, bounds)) {
+                const auto searchBounds = vm::bbox3(rayBounds->min - distance, rayBounds->max + distance);
+                index.findByCellBounds(searchBounds, makeCellTest(pickRay, camera, handleRadius), std::forward<F>(f));
+            }
+        }
+
         const Model::HitType::Type VertexHandleManager::HandleHitType = Model::HitType::freeType();
 
         void VertexHandleManager::pick(const vm::ray3& pickRay, const Renderer::Camera& camera, Model::PickResult& pickResult) const {
-            for (const auto& entry : m_handles) {
+            const auto handleRadius = static_cast<FloatType>(pref(Preferences::HandleRadius));
+            findPickableHandles(m_index, pickRay, camera, handleRadius, [&](const HandleEntry& entry) {
                 const auto& position = entry.first;
-                const auto distance = camera.pickPointHandle(pickRay, position, static_cast<FloatType>(pref(Preferences::HandleRadius)));
+                const auto distance = camera.pickPointHandle(pickRay, position, handleRadius);
                 if (!vm::is_nan(distance)) {
                     const auto hitPoint = vm::point_at_distance(pickRay, distance);
                     const auto error = vm::squared_distance(pickRay, position).distance;
                     pickResult.addHit(Model::Hit::hit(HandleHitType, distance, hitPoint, position, error));
                 }
-            }
+            });
         }
 
         void VertexHandleManager::addHandles(const Model::BrushNode* brushNode) {
@@ -75,31 +160,33 @@ namespace TrenchBroom {
         const Model::HitType::Type EdgeHandleManager::HandleHitType = Model::HitType::freeType();
 
         void EdgeHandleManager::pickGridHandle(const vm::ray3& pickRay, const Renderer::Camera& camera, const Grid& grid, Model::PickResult& pickResult) const {
-            for (const HandleEntry& entry : m_handles) {
+            const auto handleRadius = static_cast<FloatType>(pref(Preferences::HandleRadius));
+            findPickableHandles(m_index, pickRay, camera, handleRadius, [&](const HandleEntry& entry) {
                 const vm::segment3& position = entry.first;
-                const FloatType edgeDist = camera.pickLineSegmentHandle(pickRay, position, static_cast<FloatType>(pref(Preferences::HandleRadius)));
+                const FloatType edgeDist = camera.pickLineSegmentHandle(pickRay, position, handleRadius);
                 if (!vm::is_nan(edgeDist)) {
                     const vm::vec3 pointHandle = grid.snap(vm::point_at_distance(pickRay, edgeDist), position);
-                    const FloatType pointDist = camera.pickPointHandle(pickRay, pointHandle, static_cast<FloatType>(pref(Preferences::HandleRadius)));
+                    const FloatType pointDist = camera.pickPointHandle(pickRay, pointHandle, handleRadius);
                     if (!vm::is_nan(pointDist)) {
                         const vm::vec3 hitPoint = vm::point_at_distance(pickRay, pointDist);
                         pickResult.addHit(Model::Hit::hit(HandleHitType, pointDist, hitPoint, HitType(position, pointHandle)));
                     }
                 }
-            }
+            });
         }
 
         void EdgeHandleManager::pickCenterHandle(const vm::ray3& pickRay, const Renderer::Camera& camera, Model::PickResult& pickResult) const {
-            for (const HandleEntry& entry : m_handles) {
+            const auto handleRadius = static_cast<FloatType>(pref(Preferences::HandleRadius));
+            findPickableHandles(m_index, pickRay, camera, handleRadius, [&](const HandleEntry& entry) {
                 const vm::segment3& position = entry.first;
                 const vm::vec3 pointHandle = position.center();
 
-                const FloatType pointDist = camera.pickPointHandle(pickRay, pointHandle, static_cast<FloatType>(pref(Preferences::HandleRadius)));
+                const FloatType pointDist = camera.pickPointHandle(pickRay, pointHandle, handleRadius);
                 if (!vm::is_nan(pointDist)) {
                     const vm::vec3 hitPoint = vm::point_at_distance(pickRay, pointDist);
                     pickResult.addHit(Model::Hit::hit(HandleHitType, pointDist, hitPoint, position));
                 }
-            }
+            });
         }
 
         void EdgeHandleManager::addHandles(const Model::BrushNode* brushNode) {
@@ -128,38 +215,40 @@ namespace TrenchBroom {
         const Model::HitType::Type FaceHandleManager::HandleHitType = Model::HitType::freeType();
 
         void FaceHandleManager::pickGridHandle(const vm::ray3& pickRay, const Renderer::Camera& camera, const Grid& grid, Model::PickResult& pickResult) const {
-            for (const auto& entry : m_handles) {
+            const auto handleRadius = static_cast<FloatType>(pref(Preferences::HandleRadius));
+            findPickableHandles(m_index, pickRay, camera, handleRadius, [&](const HandleEntry& entry) {
                 const auto& position = entry.first;
 
                 const auto [valid, plane] = vm::from_points(std::begin(position), std::end(position));
                 if (!valid) {
-                    continue;
+                    return;
                 }
 
                 const auto distance = vm::intersect_ray_polygon(pickRay, plane, std::begin(position), std::end(position));
                 if (!vm::is_nan(distance)) {
                     const auto pointHandle = grid.snap(vm::point_at_distance(pickRay, distance), plane);
 
-                    const auto pointDist = camera.pickPointHandle(pickRay, pointHandle, static_cast<FloatType>(pref(Preferences::HandleRadius)));
+                    const auto pointDist = camera.pickPointHandle(pickRay, pointHandle, handleRadius);
                     if (!vm::is_nan(pointDist)) {
                         const auto hitPoint = vm::point_at_distance(pickRay, pointDist);
                         pickResult.addHit(Model::Hit::hit(HandleHitType, pointDist, hitPoint, HitType(position, pointHandle)));
                     }
                 }
-            }
+            });
         }
 
         void FaceHandleManager::pickCenterHandle(const vm::ray3& pickRay, const Renderer::Camera& camera, Model::PickResult& pickResult) const {
-            for (const HandleEntry& entry : m_handles) {
+            const auto handleRadius = static_cast<FloatType>(pref(Preferences::HandleRadius));
+            findPickableHandles(m_index, pickRay, camera, handleRadius, [&](const HandleEntry& entry) {
                 const auto& position = entry.first;
                 const auto pointHandle = position.center();
 
-                const auto pointDist = camera.pickPointHandle(pickRay, pointHandle, static_cast<FloatType>(pref(Preferences::HandleRadius)));
+                const auto pointDist = camera.pickPointHandle(pickRay, pointHandle, handleRadius);
                 if (!vm::is_nan(pointDist)) {
                     const auto hitPoint = vm::point_at_distance(pickRay, pointDist);
                     pickResult.addHit(Model::Hit::hit(HandleHitType, pointDist, hitPoint, position));
                 }
-            }
+            });
         }
 
         void FaceHandleManager::addHandles(const Model::BrushNode* brushNode) {
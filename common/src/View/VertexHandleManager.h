@@ -26,6 +26,7 @@
 #include "Model/HitType.h"
 #include "Model/PickResult.h"
 #include "Renderer/Camera.h"
+#include "View/VertexHandleIndex.h"
 
 #include <kdl/vector_set.h>
 
@@ -166,6 +167,11 @@ namespace TrenchBroom {
              */
             HandleMap m_handles;
 
+            /**
+             * Spatial index of the entries of m_handles.
+             */
+            VertexHandleIndex<H, HandleInfo> m_index;
+
             /**
              * The total number of selected handles, not counting duplicates.
              */
@@ -303,7 +309,11 @@ namespace TrenchBroom {
              * @param handle the handle to add
              */
             void add(const Handle& handle) {
-                m_handles[handle].inc(); // unknown value gets value constructed, which for HandleInfo means its default constructor is called
+                auto [it, inserted] = m_handles.try_emplace(handle); // unknown value gets value constructed, which for HandleInfo means its default constructor is called
+                it->second.inc();
+                if (inserted) {
+                    m_index.insert(*it);
+                }
             }
 
             /**
@@ -320,6 +330,7 @@ namespace TrenchBroom {
 
                     if (info.count == 0) {
                         deselect(info);
+                        m_index.remove(*it);
                         m_handles.erase(it);
                     }
                     return true;
@@ -333,6 +344,7 @@ namespace TrenchBroom {
              */
             void clear() {
                 m_handles.clear();
+                m_index.clear();
                 m_selectedHandleCount = 0;
             }
 
@@ -423,11 +435,15 @@ namespace TrenchBroom {
             template <typename F>
             void forEachCloseHandle(const H& handle, F fun) {
                 static const auto epsilon = 0.001 * 0.001;
-                for (auto& entry : m_handles) {
+
+                // the centers of close handles are close, too, so only the cells around the center need to be searched
+                const auto center = handleCenter(handle);
+                const auto searchBounds = vm::bbox3(center - vm::vec3::fill(0.001), center + vm::vec3::fill(0.001));
+                m_index.findByCenter(searchBounds, [&](HandleEntry& entry) {
                     if (compare(handle, entry.first, epsilon) == 0) {
                         fun(entry.second);
                     }
-                }
+                });
             }
 
             void select(HandleInfo& info) {
@@ -521,8 +537,12 @@ namespace TrenchBroom {
              */
             template <typename I, typename O>
             void findIncidentBrushes(const Handle& handle, I begin, I end, O out) const {
+                // a brush can only be incident to the handle if its bounds contain the handle, which is much cheaper
+                // to check than searching the brush geometry
+                const auto bounds = handleBounds(handle);
+                const auto searchBounds = vm::bbox3(bounds.min - vm::vec3::fill(0.001), bounds.max + vm::vec3::fill(0.001));
                 for (auto cur = begin; cur != end; ++cur) {
-                    if (isIncident(handle, *cur)) {
+                    if ((*cur)->logicalBounds().intersects(searchBounds) && isIncident(handle, *cur)) {
                         out++ = *cur;
                     }
                 }
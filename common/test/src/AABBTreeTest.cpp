@@ -22,16 +22,20 @@
 #include "GTestCompat.h"
 
 #include <vecmath/vec.h>
+#include <vecmath/plane.h>
 #include <vecmath/ray.h>
 #include "AABBTree.h"
 
+#include <algorithm>
 #include <set>
 #include <sstream>
+#include <vector>
 
 namespace TrenchBroom {
     using AABB = AABBTree<double, 3, size_t>;
     using BOX = AABB::Box;
     using RAY = vm::ray<AABB::FloatType, AABB::Components>;
+    using PLANE = vm::plane<AABB::FloatType, AABB::Components>;
     using VEC = vm::vec<AABB::FloatType, AABB::Components>;
 
     void assertTree(const std::string& exp, const AABB& actual);
@@ -489,6 +493,148 @@ L [ ( -1 -1 -1 ) ( 1 1 1 ) ]: 1
         assertIntersectors(tree, RAY(VEC(0.0,  0.0,  0.0), VEC::pos_x()), { 2u });
     }
 
+    TEST_CASE("AABBTreeTest.clearAndBuild", "[AABBTreeTest]") {
+        std::vector<std::pair<BOX, size_t>> objects;
+        for (size_t x = 0; x < 10u; ++x) {
+            for (size_t y = 0; y < 10u; ++y) {
+                for (size_t z = 0; z < 4u; ++z) {
+                    const auto min = VEC(static_cast<double>(x) * 3.0, static_cast<double>(y) * 3.0, static_cast<double>(z) * 3.0);
+                    objects.emplace_back(BOX(min, min + VEC(2.0, 2.0, 2.0)), objects.size());
+                }
+            }
+        }
+
+        std::vector<size_t> data;
+        for (const auto& object : objects) {
+            data.push_back(object.second);
+        }
+
+        AABB tree;
+        tree.insert(BOX(VEC(-1.0, -1.0, -1.0), VEC(1.0, 1.0, 1.0)), 1000u);
+
+        tree.clearAndBuild(data, [&](const size_t i) { return objects[i].first; });
+        ASSERT_FALSE(tree.contains(1000u));
+        ASSERT_EQ(BOX(VEC(0.0, 0.0, 0.0), VEC(29.0, 29.0, 11.0)), tree.bounds());
+        ASSERT_LE(tree.height(), 12u);
+
+        for (const auto& [bounds, i] : objects) {
+            assertTreeContains(tree, bounds, i);
+        }
+
+        for (size_t i = 0; i < 10u; ++i) {
+            const auto rowY = static_cast<double>(i) * 3.0 + 1.0;
+            const auto ray = RAY(VEC(-1.0, rowY, 1.0), VEC::pos_x());
+
+            std::vector<size_t> expected;
+            for (const auto& [bounds, j] : objects) {
+                if (bounds.contains(VEC(bounds.min.x(), rowY, 1.0))) {
+                    expected.push_back(j);
+                }
+            }
+
+            auto actual = tree.findIntersectors(ray);
+            std::sort(std::begin(actual), std::end(actual));
+            ASSERT_EQ(expected, actual);
+        }
+
+        // building again replaces the previous contents
+        tree.clearAndBuild(std::vector<size_t>{ 1u, 2u }, [&](const size_t i) { return objects[i].first; });
+        ASSERT_TRUE(tree.contains(1u));
+        ASSERT_TRUE(tree.contains(2u));
+        ASSERT_FALSE(tree.contains(3u));
+        ASSERT_EQ(2u, tree.height());
+
+        tree.clearAndBuild(std::vector<size_t>{}, [&](const size_t i) { return objects[i].first; });
+        ASSERT_TRUE(tree.empty());
+    }
+
+    TEST_CASE("AABBTreeTest.findIntersectorsOfConvexVolume", "[AABBTreeTest]") {
+        AABB tree;
+        for (size_t i = 0; i < 16u; ++i) {
+            const auto x = static_cast<double>(i % 4u) * 3.0;
+            const auto y = static_cast<double>(i / 4u) * 3.0;
+            tree.insert(BOX(VEC(x, y, -1.0), VEC(x + 2.0, y + 2.0, 1.0)), i);
+        }
+
+        const auto find = [&](const std::vector<PLANE>& planes) {
+            auto result = tree.findIntersectors(planes);
+            std::sort(std::begin(result), std::end(result));
+            return result;
+        };
+
+        // a box around the center of the grid, intersecting with the boxes of items 5, 6, 9 and 10
+        const std::vector<PLANE> centerBox {
+            PLANE(VEC(4.5, 0.0, 0.0), VEC::neg_x()),
+            PLANE(VEC(7.5, 0.0, 0.0), VEC::pos_x()),
+            PLANE(VEC(0.0, 4.5, 0.0), VEC( 0.0, -1.0, 0.0)),
+            PLANE(VEC(0.0, 7.5, 0.0), VEC::pos_y()),
+        };
+        ASSERT_EQ(std::vector<size_t>({ 5u, 6u, 9u, 10u }), find(centerBox));
+
+        // the volume bounded by x <= 4.5 and x >= 7.5 is empty
+        ASSERT_EQ(std::vector<size_t>({}), find({ PLANE(VEC(4.5, 0.0, 0.0), VEC::pos_x()), PLANE(VEC(7.5, 0.0, 0.0), VEC::neg_x()) }));
+
+        // the half space x <= 4.5 contains the boxes of the first two columns completely
+        ASSERT_EQ(std::vector<size_t>({ 0u, 1u, 4u, 5u, 8u, 9u, 12u, 13u }), find({ PLANE(VEC(4.5, 0.0, 0.0), VEC::pos_x()) }));
+
+        // everything is inside of a volume without any planes, and nothing is in front of a plane below the grid
+        ASSERT_EQ(16u, find({}).size());
+        ASSERT_EQ(std::vector<size_t>({}), find({ PLANE(VEC(0.0, 0.0, -2.0), VEC::pos_z()) }));
+    }
+
+    TEST_CASE("AABBTreeTest.findIntersectorsOfBox", "[AABBTreeTest]") {
+        AABB tree;
+        ASSERT_EQ(std::vector<size_t>({}), tree.findIntersectors(BOX(VEC(0.0, 0.0, 0.0), VEC(1.0, 1.0, 1.0))));
+
+        for (size_t i = 0; i < 16u; ++i) {
+            const auto x = static_cast<double>(i % 4u) * 3.0;
+            const auto y = static_cast<double>(i / 4u) * 3.0;
+            tree.insert(BOX(VEC(x, y, -1.0), VEC(x + 2.0, y + 2.0, 1.0)), i);
+        }
+
+        const auto find = [&](const BOX& box) {
+            auto result = tree.findIntersectors(box);
+            std::sort(std::begin(result), std::end(result));
+            return result;
+        };
+
+        ASSERT_EQ(std::vector<size_t>({ 5u, 6u, 9u, 10u }), find(BOX(VEC(4.5, 4.5, 0.0), VEC(7.5, 7.5, 0.0))));
+
+        // boxes that touch count as intersecting
+        ASSERT_EQ(std::vector<size_t>({ 0u, 1u }), find(BOX(VEC(2.0, 0.0, 1.0), VEC(3.0, 1.0, 2.0))));
+
+        // the gaps between the boxes are empty
+        ASSERT_EQ(std::vector<size_t>({}), find(BOX(VEC(2.5, 0.0, -1.0), VEC(2.5, 11.0, 1.0))));
+        ASSERT_EQ(16u, find(tree.bounds()).size());
+    }
+
+    TEST_CASE("AABBTreeTest.clearAndBuildWithDuplicates", "[AABBTreeTest]") {
+        const auto bounds = BOX(VEC(-1.0, -1.0, -1.0), VEC(1.0, 1.0, 1.0));
+
+        AABB tree;
+        ASSERT_THROW(tree.clearAndBuild(std::vector<size_t>{ 1u, 2u, 1u }, [&](const size_t) { return bounds; }), NodeTreeException);
+        ASSERT_TRUE(tree.empty());
+        ASSERT_FALSE(tree.contains(1u));
+    }
+
+    TEST_CASE("AABBTreeTest.clearAndBuildWithCoincidentCenters", "[AABBTreeTest]") {
+        std::vector<size_t> data;
+        for (size_t i = 0; i < 8u; ++i) {
+            data.push_back(i);
+        }
+
+        AABB tree;
+        tree.clearAndBuild(data, [](const size_t i) {
+            const auto size = static_cast<double>(i + 1u);
+            return BOX(VEC(-size, -size, -size), VEC(size, size, size));
+        });
+
+        ASSERT_EQ(4u, tree.height());
+        for (const auto i : data) {
+            ASSERT_TRUE(tree.contains(i));
+        }
+    }
+
     void assertTree(const std::string& exp, const AABB& actual) {
         std::stringstream str;
         actual.print(str);
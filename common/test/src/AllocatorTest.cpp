@@ -0,0 +1,72 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <catch2/catch.hpp>
+
+#include "GTestCompat.h"
+
+#include "Allocator.h"
+
+#include <thread>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace {
+        struct Element : public Allocator<Element> {
+            double values[6];
+        };
+    }
+
+    TEST_CASE("AllocatorTest.releaseFreeChunks", "[AllocatorTest]") {
+        const auto initialChunkCount = Element::chunkCount();
+
+        std::vector<Element*> elements;
+        for (size_t i = 0u; i < 100000u; ++i) {
+            elements.push_back(new Element());
+        }
+        ASSERT_GT(Element::chunkCount(), initialChunkCount + 100u);
+
+        for (auto* element : elements) {
+            delete element;
+        }
+        elements.clear();
+
+        // a thread keeps up to two chunks' worth of free blocks in its cache
+        ASSERT_LE(Element::chunkCount(), initialChunkCount + 3u);
+    }
+
+    TEST_CASE("AllocatorTest.releaseChunksFreedOnOtherThread", "[AllocatorTest]") {
+        const auto initialChunkCount = Element::chunkCount();
+
+        std::vector<Element*> elements;
+        for (size_t i = 0u; i < 100000u; ++i) {
+            elements.push_back(new Element());
+        }
+
+        std::thread thread([&]() {
+            for (auto* element : elements) {
+                delete element;
+            }
+        });
+        thread.join();
+
+        // the exiting thread returned all blocks, and this thread has taken at most one chunk's worth
+        ASSERT_LE(Element::chunkCount(), initialChunkCount + 1u);
+    }
+}
@@ -0,0 +1,131 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <catch2/catch.hpp>
+
+#include "GTestCompat.h"
+
+#include "Exceptions.h"
+#include "Logger.h"
+#include "Assets/EntityModel.h"
+#include "Assets/EntityModelLoadQueue.h"
+#include "Assets/Palette.h"
+#include "IO/DiskFileSystem.h"
+#include "IO/DiskIO.h"
+#include "IO/EntityModelLoader.h"
+#include "IO/File.h"
+#include "IO/FileMatcher.h"
+#include "IO/MdlParser.h"
+#include "IO/Path.h"
+#include "IO/Reader.h"
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Assets {
+        /**
+         * Loads the MDL files from a directory without creating a game.
+         */
+        class MdlLoader : public IO::EntityModelLoader {
+        private:
+            IO::DiskFileSystem m_fs;
+            Palette m_palette;
+        public:
+            explicit MdlLoader(const IO::Path& modelDirectory) :
+            m_fs(modelDirectory),
+            m_palette(Palette::loadFile(IO::DiskFileSystem(IO::Disk::getCurrentWorkingDir()), IO::Path("fixture/test/palette.lmp"))) {}
+
+            std::vector<IO::Path> modelPaths() const {
+                return m_fs.findItems(IO::Path(""), IO::FileExtensionMatcher("mdl"));
+            }
+        private:
+            std::unique_ptr<EntityModel> doInitializeModel(const IO::Path& path, Logger& logger) const override {
+                const auto file = m_fs.openFile(path);
+                auto reader = file->reader().buffer();
+                auto parser = IO::MdlParser(path.lastComponent().asString(), std::begin(reader), std::end(reader), m_palette);
+                return parser.initializeModel(logger);
+            }
+
+            void doLoadFrame(const IO::Path& path, const size_t frameIndex, EntityModel& model, Logger& logger) const override {
+                const auto file = m_fs.openFile(path);
+                auto reader = file->reader().buffer();
+                auto parser = IO::MdlParser(path.lastComponent().asString(), std::begin(reader), std::end(reader), m_palette);
+                parser.loadFrame(frameIndex, model, logger);
+            }
+        };
+
+        static std::unique_ptr<EntityModel> loadModel(const IO::EntityModelLoader& loader, const IO::Path& path) {
+            NullLogger logger;
+            try {
+                auto model = loader.initializeModel(path, logger);
+                loader.loadFrame(path, 0, *model, logger);
+                return model;
+            } catch (const Exception&) {
+                return nullptr;
+            }
+        }
+
+        TEST_CASE("EntityModelLoadQueueTest.loadDirectoryConcurrently", "[EntityModelLoadQueueTest]") {
+            const auto loader = MdlLoader(IO::Disk::getCurrentWorkingDir() + IO::Path("fixture/test/IO/Mdl"));
+
+            const auto paths = loader.modelPaths();
+            REQUIRE(paths.size() > 1u);
+
+            auto results = std::vector<EntityModelLoadQueue::Result>();
+            {
+                EntityModelLoadQueue queue(loader, 4u);
+                for (const auto& path : paths) {
+                    queue.enqueue(path, 0u);
+                    // requesting a model again while it is pending has no effect
+                    queue.enqueue(path, 0u);
+                }
+
+                queue.waitUntilIdle();
+                CHECK(queue.busy());
+
+                results = queue.takeResults();
+                CHECK_FALSE(queue.busy());
+                CHECK(queue.takeResults().empty());
+            }
+
+            REQUIRE(results.size() == paths.size());
+            for (const auto& path : paths) {
+                const auto it = std::find_if(std::begin(results), std::end(results), [&](const auto& result) { return result.path == path; });
+                REQUIRE(it != std::end(results));
+
+                const auto expected = loadModel(loader, path);
+                const auto& actual = it->model;
+                if (expected == nullptr) {
+                    CHECK(actual == nullptr);
+                    CHECK_FALSE(it->messages.empty());
+                } else {
+                    REQUIRE(actual != nullptr);
+                    CHECK(actual->frameCount() == expected->frameCount());
+                    CHECK(actual->surfaceCount() == expected->surfaceCount());
+                    REQUIRE(actual->frame(0)->loaded());
+                    CHECK(actual->frame(0)->name() == expected->frame(0)->name());
+                    CHECK(actual->frame(0)->bounds() == expected->frame(0)->bounds());
+                }
+            }
+        }
+    }
+}
@@ -142,6 +142,26 @@ namespace TrenchBroom {
             ASSERT_TRUE(Disk::openFile(env.dir() + Path("anotherDir/subDirTest/test2.map")) != nullptr);
         }
 
+        TEST_CASE("DiskTest.openFileContents", "[DiskTest]") {
+            FSTestEnvironment env;
+
+            const auto file = Disk::openFile(env.dir() + Path("test.txt"));
+            ASSERT_EQ(12u, file->size());
+
+            auto reader = file->reader().buffer();
+            ASSERT_EQ("some content", std::string(std::begin(reader), std::end(reader)));
+        }
+
+        TEST_CASE("DiskTest.mapFile", "[DiskTest]") {
+            FSTestEnvironment env;
+
+            ASSERT_THROW(Disk::mapFile(env.dir() + Path("does_not_exist.txt")), FileNotFoundException);
+
+            const auto file = Disk::mapFile(env.dir() + Path("test.txt"));
+            ASSERT_EQ(12u, file->size());
+            ASSERT_EQ("some content", std::string(file->begin(), file->end()));
+        }
+
         TEST_CASE("DiskTest.resolvePath", "[DiskTest]") {
             FSTestEnvironment env;
 
@@ -0,0 +1,280 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <catch2/catch.hpp>
+
+#include "GTestCompat.h"
+
+#include "Logger.h"
+#include "IO/MapCache.h"
+#include "IO/NodeWriter.h"
+#include "IO/Path.h"
+#include "IO/TestEnvironment.h"
+#include "IO/TestParserStatus.h"
+#include "IO/WorldReader.h"
+#include "Model/BrushNode.h"
+#include "Model/LayerNode.h"
+#include "Model/WorldNode.h"
+
+#include <vecmath/bbox.h>
+
+#include <map>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <QString>
+
+namespace TrenchBroom {
+    namespace IO {
+        static const std::string CachedMap(R"(
+{
+"classname" "worldspawn"
+"message" "cached"
+"_tb_layer_color" "0.1 0.2 0.3"
+{
+( -800 288 1024 ) ( -736 288 1024 ) ( -736 224 1024 ) METAL4_5 [ 1 0 0 64 ] [ 0 -1 0 0 ] 0 1 1
+( -800 288 1024 ) ( -800 224 1024 ) ( -800 224 576 ) METAL4_5 [ 0 1 0 0 ] [ 0 0 -1 0 ] 0 1 1
+( -736 224 1024 ) ( -736 288 1024 ) ( -736 288 576 ) METAL4_5 [ 0 1 0 0 ] [ 0 0 -1 0 ] 0 1 1
+( -736 288 1024 ) ( -800 288 1024 ) ( -800 288 576 ) METAL4_5 [ 1 0 0 64 ] [ 0 0 -1 0 ] 0 1 1
+( -800 224 1024 ) ( -736 224 1024 ) ( -736 224 576 ) METAL4_5 [ 1 0 0 64 ] [ 0 0 -1 0 ] 0 1 1
+( -800 224 576 ) ( -736 224 576 ) ( -736 288 576 ) METAL4_5 [ 1 0 0 64 ] [ 0 -1 0 0 ] 0 1.5 0.25
+}
+}
+{
+"classname" "func_group"
+"_tb_type" "_tb_layer"
+"_tb_name" "My Layer"
+"_tb_id" "7"
+"_tb_layer_sort_index" "3"
+}
+{
+"classname" "func_group"
+"_tb_type" "_tb_group"
+"_tb_name" "My Group"
+"_tb_id" "2"
+"_tb_layer" "7"
+{
+( -800 288 1024 ) ( -736 288 1024 ) ( -736 224 1024 ) __TB_empty [ 0.6 0.8 0 12.5 ] [ 0 0 -1 -3 ] 33 0.5 0.5
+( -800 288 1024 ) ( -800 224 1024 ) ( -800 224 576 ) __TB_empty [ 0 1 0 0 ] [ 0 0 -1 0 ] 0 1 1
+( -736 224 1024 ) ( -736 288 1024 ) ( -736 288 576 ) __TB_empty [ 0 1 0 0.125 ] [ 0 0 -1 0 ] 0 1 1
+( -736 288 1024 ) ( -800 288 1024 ) ( -800 288 576 ) __TB_empty [ 1 0 0 64 ] [ 0 0 -1 0 ] 0 1 1
+( -800 224 1024 ) ( -736 224 1024 ) ( -736 224 576 ) __TB_empty [ 1 0 0 64 ] [ 0 0 -1 0 ] 0 1 1
+( -800 224 576 ) ( -736 224 576 ) ( -736 288 576 ) __TB_empty [ 1 0 0 64 ] [ 0 -1 0 0 ] 0 1 1
+}
+}
+{
+"classname" "light"
+"origin" "1 2 3"
+"_tb_group" "2"
+}
+{
+"classname" "func_door"
+"target" "some \"quoted\" value"
+{
+( -800 288 1024 ) ( -736 288 1024 ) ( -736 224 1024 ) METAL4_5 [ 1 0 0 64 ] [ 0 -1 0 0 ] 0 1 1
+( -800 288 1024 ) ( -800 224 1024 ) ( -800 224 576 ) METAL4_5 [ 0 1 0 0 ] [ 0 0 -1 0 ] 0 1 1
+( -736 224 1024 ) ( -736 288 1024 ) ( -736 288 576 ) METAL4_5 [ 0 1 0 0 ] [ 0 0 -1 0 ] 0 1 1
+( -736 288 1024 ) ( -800 288 1024 ) ( -800 288 576 ) METAL4_5 [ 1 0 0 64 ] [ 0 0 -1 0 ] 0 1 1
+( -800 224 1024 ) ( -736 224 1024 ) ( -736 224 576 ) METAL4_5 [ 1 0 0 64 ] [ 0 0 -1 0 ] 0 1 1
+( -800 224 576 ) ( -736 224 576 ) ( -736 288 576 ) METAL4_5 [ 1 0 0 64 ] [ 0 -1 0 0 ] 0 1 1
+}
+}
+)");
+
+        /**
+         * The node serializer assigns new layer and group ids whenever it writes a map, so the ids are renumbered in
+         * order of appearance before comparing two serialized maps.
+         */
+        static std::string normalizeIds(const std::string& str) {
+            static const std::regex idPattern(R"re("(_tb_id|_tb_layer|_tb_group)" "(\d+)")re");
+
+            std::map<std::string, std::string> ids;
+            std::string result;
+            auto last = std::cbegin(str);
+            for (auto it = std::sregex_iterator(std::cbegin(str), std::cend(str), idPattern); it != std::sregex_iterator(); ++it) {
+                const auto& match = *it;
+                const auto id = ids.emplace(match[2].str(), std::to_string(ids.size() + 1u)).first->second;
+                result.append(last, match[0].first);
+                result += "\"" + match[1].str() + "\" \"" + id + "\"";
+                last = match[0].second;
+            }
+            result.append(last, std::cend(str));
+            return result;
+        }
+
+        static std::string writeWorld(const Model::WorldNode& world) {
+            std::stringstream str;
+            NodeWriter writer(world, str);
+            writer.writeMap();
+            return str.str();
+        }
+
+        TEST_CASE("MapCacheTest.roundTrip", "[MapCacheTest]") {
+            TestEnvironment env("MapCacheTest");
+            const auto cachePath = MapCache::cachePath(env.dir() + Path("test.map"));
+            const auto key = MapCache::computeKey(CachedMap.data(), CachedMap.data() + CachedMap.size(), "Quake", Model::MapFormat::Valve);
+
+            const vm::bbox3 worldBounds(8192.0);
+
+            TestParserStatus status;
+            WorldReader mapReader(CachedMap);
+            auto mapWorld = mapReader.read(Model::MapFormat::Valve, worldBounds, status);
+
+            MapCache::write(*mapWorld, {}, key, cachePath);
+            const auto cache = MapCache::open(cachePath, key);
+            REQUIRE(cache.has_value());
+
+            WorldReader cacheReader(CachedMap);
+            auto cacheWorld = cacheReader.read(*cache, Model::MapFormat::Valve, worldBounds, status);
+
+            CHECK(normalizeIds(writeWorld(*cacheWorld)) == normalizeIds(writeWorld(*mapWorld)));
+
+            const auto mapLayers = mapWorld->allLayers();
+            const auto cacheLayers = cacheWorld->allLayers();
+            REQUIRE(cacheLayers.size() == mapLayers.size());
+            for (size_t i = 0; i < mapLayers.size(); ++i) {
+                CHECK(cacheLayers[i]->name() == mapLayers[i]->name());
+                CHECK(cacheLayers[i]->sortIndex() == mapLayers[i]->sortIndex());
+                CHECK(cacheLayers[i]->childCount() == mapLayers[i]->childCount());
+            }
+
+            const auto* mapBrush = static_cast<const Model::BrushNode*>(mapWorld->defaultLayer()->children().front());
+            const auto* cacheBrush = static_cast<const Model::BrushNode*>(cacheWorld->defaultLayer()->children().front());
+            CHECK(cacheBrush->lineNumber() == mapBrush->lineNumber());
+            CHECK(cacheBrush->lineCount() == mapBrush->lineCount());
+            CHECK(cacheBrush->logicalBounds() == mapBrush->logicalBounds());
+        }
+
+        TEST_CASE("MapCacheTest.messages", "[MapCacheTest]") {
+            TestEnvironment env("MapCacheTest");
+            const auto cachePath = MapCache::cachePath(env.dir() + Path("test.map"));
+            const auto key = MapCache::computeKey(CachedMap.data(), CachedMap.data() + CachedMap.size(), "Quake", Model::MapFormat::Valve);
+
+            const vm::bbox3 worldBounds(8192.0);
+
+            TestParserStatus status;
+            WorldReader mapReader(CachedMap);
+            auto world = mapReader.read(Model::MapFormat::Valve, worldBounds, status);
+
+            const auto messages = std::vector<MapCache::LogMessage>{
+                { LogLevel::Warn, "some warning (line 3)" },
+                { LogLevel::Error, "some error (line 7)" }
+            };
+            MapCache::write(*world, messages, key, cachePath);
+            CHECK_FALSE(env.fileExists(Path("test.map.tbcache.tmp")));
+
+            const auto cache = MapCache::open(cachePath, key);
+            REQUIRE(cache.has_value());
+            REQUIRE(cache->messages().size() == messages.size());
+            for (size_t i = 0; i < messages.size(); ++i) {
+                CHECK(cache->messages()[i].level == messages[i].level);
+                CHECK(cache->messages()[i].message == messages[i].message);
+            }
+
+            WorldReader cacheReader(CachedMap);
+            auto cacheWorld = cacheReader.read(*cache, Model::MapFormat::Valve, worldBounds, status);
+            CHECK(normalizeIds(writeWorld(*cacheWorld)) == normalizeIds(writeWorld(*world)));
+        }
+
+        class MessageLogger : public Logger {
+        private:
+            std::vector<std::pair<LogLevel, std::string>> m_messages;
+        public:
+            const std::vector<std::pair<LogLevel, std::string>>& messages() const {
+                return m_messages;
+            }
+        private:
+            void doLog(const LogLevel level, const std::string& message) override {
+                m_messages.emplace_back(level, message);
+            }
+
+            void doLog(const LogLevel level, const QString& message) override {
+                m_messages.emplace_back(level, message.toStdString());
+            }
+        };
+
+        TEST_CASE("MapCacheTest.readWorldLogsMessagesOnce", "[MapCacheTest]") {
+            const std::string data(R"(
+{
+"classname" "worldspawn"
+{
+( -800 288 1024 ) ( -736 288 1024 ) ( -736 224 1024 ) METAL4_5 [ 1 0 0 64 ] [ 0 -1 0 0 ] 0 1 1
+( -800 288 1024 ) ( -800 224 1024 ) ( -800 224 576 ) METAL4_5 [ 0 1 0 0 ] [ 0 0 -1 0 ] 0 1 1
+( -736 224 1024 ) ( -736 288 1024 ) ( -736 288 576 ) METAL4_5 [ 0 1 0 0 ] [ 0 0 -1 0 ] 0 1 1
+}
+}
+{
+"classname" "func_group"
+"_tb_type" "_tb_layer"
+"_tb_id" "1"
+}
+{
+"classname" "light"
+"origin" "0 0 0"
+"_tb_layer" "2"
+}
+)");
+
+            TestEnvironment env("MapCacheTest");
+            const auto cachePath = MapCache::cachePath(env.dir() + Path("test.map"));
+            const vm::bbox3 worldBounds(8192.0);
+
+            MessageLogger mapLogger;
+            auto mapWorld = MapCache::readWorld(data.data(), data.data() + data.size(), "Quake", Model::MapFormat::Valve, worldBounds, cachePath, mapLogger);
+            REQUIRE(env.fileExists(Path("test.map.tbcache")));
+
+            const auto& messages = mapLogger.messages();
+            REQUIRE(messages.size() == 3u);
+            CHECK(messages[0].first == LogLevel::Error);
+            CHECK(messages[0].second.find("Skipping brush") != std::string::npos);
+            CHECK(messages[1].first == LogLevel::Error);
+            CHECK(messages[1].second.find("Skipping layer entity: missing name") != std::string::npos);
+            CHECK(messages[2].first == LogLevel::Warn);
+            CHECK(messages[2].second.find("invalid parent id '2'") != std::string::npos);
+
+            // a failure to read the cache would be logged as an additional warning
+            MessageLogger cacheLogger;
+            auto cacheWorld = MapCache::readWorld(data.data(), data.data() + data.size(), "Quake", Model::MapFormat::Valve, worldBounds, cachePath, cacheLogger);
+            CHECK(cacheLogger.messages() == messages);
+            CHECK(normalizeIds(writeWorld(*cacheWorld)) == normalizeIds(writeWorld(*mapWorld)));
+        }
+
+        TEST_CASE("MapCacheTest.openInvalidCache", "[MapCacheTest]") {
+            TestEnvironment env("MapCacheTest");
+            const auto cachePath = MapCache::cachePath(env.dir() + Path("test.map"));
+            const auto key = MapCache::computeKey(CachedMap.data(), CachedMap.data() + CachedMap.size(), "Quake", Model::MapFormat::Valve);
+
+            CHECK_FALSE(MapCache::open(cachePath, key).has_value());
+
+            const vm::bbox3 worldBounds(8192.0);
+
+            TestParserStatus status;
+            WorldReader mapReader(CachedMap);
+            auto world = mapReader.read(Model::MapFormat::Valve, worldBounds, status);
+            MapCache::write(*world, {}, key, cachePath);
+
+            CHECK(MapCache::open(cachePath, key).has_value());
+            CHECK_FALSE(MapCache::open(cachePath, MapCache::computeKey(CachedMap.data(), CachedMap.data() + CachedMap.size(), "Quake 2", Model::MapFormat::Valve)).has_value());
+            CHECK_FALSE(MapCache::open(cachePath, MapCache::computeKey(CachedMap.data(), CachedMap.data() + CachedMap.size() - 1u, "Quake", Model::MapFormat::Valve)).has_value());
+        }
+    }
+}
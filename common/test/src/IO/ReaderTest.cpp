@@ -28,6 +28,8 @@
 
 #include <memory>
 #include <string>
+#include <thread>
+#include <vector>
 
 namespace TrenchBroom {
     namespace IO {
@@ -193,5 +195,28 @@ namespace TrenchBroom {
         TEST_CASE("FileReaderTest.testSubReader", "[FileReaderTest]") {
             subReader(file()->reader());
         }
+
+        TEST_CASE("FileReaderTest.concurrentSubReaders", "[FileReaderTest]") {
+            const auto f = Disk::openFile(Disk::getCurrentWorkingDir() + Path("fixture/test/IO/Reader/10byte"));
+
+            // every thread reads a different byte of the same file over and over
+            std::vector<std::string> results(10u);
+            std::vector<std::thread> threads;
+            for (size_t i = 0u; i < results.size(); ++i) {
+                threads.emplace_back([&, i]() {
+                    for (size_t j = 0u; j < 1000u; ++j) {
+                        auto reader = f->reader().subReaderFromBegin(i, 1u);
+                        results[i] += reader.readChar<char>();
+                    }
+                });
+            }
+            for (auto& thread : threads) {
+                thread.join();
+            }
+
+            for (size_t i = 0u; i < results.size(); ++i) {
+                ASSERT_EQ(std::string(1000u, buff()[i]), results[i]);
+            }
+        }
     }
 }
@@ -22,15 +22,23 @@
 #include "GTestCompat.h"
 
 #include "Logger.h"
+#include "Assets/Palette.h"
 #include "Assets/Texture.h"
+#include "Assets/TextureCollection.h"
 #include "Assets/TextureManager.h"
 #include "IO/DiskFileSystem.h"
 #include "IO/DiskIO.h"
+#include "IO/FileMatcher.h"
+#include "IO/IdMipTextureReader.h"
 #include "IO/Path.h"
+#include "IO/TextureCollectionLoader.h"
 #include "IO/TextureLoader.h"
+#include "IO/WadFileSystem.h"
 #include "Model/GameConfig.h"
 
+#include <memory>
 #include <string>
+#include <vector>
 
 namespace TrenchBroom {
     namespace IO {
@@ -140,5 +148,78 @@ namespace TrenchBroom {
             assertTexture("blowjob_machine", 128, 128, textureManager);
             assertTexture("lasthopeofhuman", 128, 128, textureManager);
         }
+
+        TEST_CASE("TextureLoaderTest.testLoadOrder", "[TextureLoaderTest]") {
+            const auto wadPath = Path("fixture/test/IO/Wad/cr8_czg.wad");
+
+            const IO::Path root = IO::Disk::getCurrentWorkingDir();
+            const IO::DiskFileSystem fileSystem(root, true);
+
+            auto logger = NullLogger();
+            const auto palette = Assets::Palette::loadFile(fileSystem, Path("fixture/test/palette.lmp"));
+            const TextureReader::TextureNameStrategy nameStrategy;
+            const IdMipTextureReader textureReader(nameStrategy, fileSystem, logger, palette);
+
+            std::vector<std::string> expectedNames;
+            WadFileSystem wadFS(root + wadPath, logger);
+            for (const auto& texturePath : wadFS.findItems(Path(""), FileExtensionMatcher("D"))) {
+                auto texture = std::unique_ptr<Assets::Texture>(textureReader.readTexture(wadFS.openFile(texturePath)));
+                expectedNames.push_back(texture->name());
+            }
+
+            // the textures are decoded concurrently, but they must be added in the order of the files
+            FileTextureCollectionLoader collectionLoader(logger, { root }, {});
+            const auto collection = collectionLoader.loadTextureCollection(wadPath, { "D" }, textureReader);
+
+            std::vector<std::string> actualNames;
+            for (const auto* texture : collection->textures()) {
+                actualNames.push_back(texture->name());
+            }
+
+            CHECK_FALSE(expectedNames.empty());
+            CHECK(actualNames == expectedNames);
+        }
+
+        TEST_CASE("TextureLoaderTest.testLoadLazily", "[TextureLoaderTest]") {
+            const auto path = Path("fixture/test/IO/Wad/cr8_czg.wad");
+
+            const IO::Path root = IO::Disk::getCurrentWorkingDir();
+            const std::vector<IO::Path> fileSearchPaths{ root };
+            const IO::DiskFileSystem fileSystem(root, true);
+
+            const Model::TextureConfig textureConfig(
+                Model::TexturePackageConfig(
+                    Model::PackageFormatConfig("wad", "idmip")),
+                    Model::PackageFormatConfig("D", "idmip"),
+                    IO::Path("fixture/test/palette.lmp"),
+                    "wad",
+                    IO::Path(),
+                    {});
+
+            auto logger = NullLogger();
+            IO::TextureLoader eagerLoader(fileSystem, fileSearchPaths, textureConfig, logger, false);
+            IO::TextureLoader lazyLoader(fileSystem, fileSearchPaths, textureConfig, logger, true);
+
+            const auto eagerCollection = eagerLoader.loadTextureCollection(path);
+            const auto lazyCollection = lazyLoader.loadTextureCollection(path);
+            REQUIRE(lazyCollection->textureCount() == eagerCollection->textureCount());
+
+            for (size_t i = 0; i < eagerCollection->textureCount(); ++i) {
+                const auto* eagerTexture = eagerCollection->textureByIndex(i);
+                const auto* lazyTexture = lazyCollection->textureByIndex(i);
+
+                CHECK_FALSE(eagerTexture->lazy());
+                CHECK(lazyTexture->lazy());
+                CHECK(lazyTexture->name() == eagerTexture->name());
+                CHECK(lazyTexture->width() == eagerTexture->width());
+                CHECK(lazyTexture->height() == eagerTexture->height());
+                CHECK(lazyTexture->averageColor() == eagerTexture->averageColor());
+                CHECK(lazyTexture->type() == eagerTexture->type());
+
+                // the contents are only decoded on demand
+                CHECK(lazyTexture->buffersIfUnprepared().empty());
+                CHECK(lazyTexture->loadBuffers() == eagerTexture->buffersIfUnprepared());
+            }
+        }
     }
 }
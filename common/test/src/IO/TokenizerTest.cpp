@@ -242,5 +242,27 @@ namespace TrenchBroom {
             ASSERT_EQ(SimpleToken::CBrace, (token = tokenizer.nextToken()).type());
             ASSERT_EQ(SimpleToken::Eof, tokenizer.nextToken().type());
         }
+
+        TEST_CASE("TokenizerTest.parseNumbers", "[TokenizerTest]") {
+            const auto parseDoubleFromString = [](const std::string& str) {
+                return parseDouble(str.data(), str.data() + str.size());
+            };
+            const auto parseLongFromString = [](const std::string& str) {
+                return parseLong(str.data(), str.data() + str.size());
+            };
+
+            for (const std::string str : { "0", "-0", "+3", "-1280", "505.37931034482756", "-.25", ".5", "1e5", "2.5e-3", "123456789012345678901", "1.5abc" }) {
+                ASSERT_EQ(kdl::str_to_double(str).value_or(0.0), parseDoubleFromString(str));
+            }
+            ASSERT_EQ(0.0, parseDoubleFromString("."));
+            ASSERT_EQ(0.0, parseDoubleFromString("-"));
+            ASSERT_EQ(0.0, parseDoubleFromString("1e999"));
+
+            for (const std::string str : { "0", "-0", "+3", "-1280", "2147483647", "12abc" }) {
+                ASSERT_EQ(kdl::str_to_long(str).value_or(0l), parseLongFromString(str));
+            }
+            ASSERT_EQ(0l, parseLongFromString("-"));
+            ASSERT_EQ(0l, parseLongFromString("123456789012345678901"));
+        }
     }
 }
@@ -21,8 +21,11 @@
 
 #include "GTestCompat.h"
 
+#include "Logger.h"
 #include "IO/DiskIO.h"
 #include "IO/File.h"
+#include "IO/NodeWriter.h"
+#include "IO/ParserStatus.h"
 #include "IO/TestParserStatus.h"
 #include "IO/WorldReader.h"
 #include "Model/BrushNode.h"
@@ -35,7 +38,9 @@
 
 #include <vecmath/vec.h>
 
+#include <sstream>
 #include <string>
+#include <vector>
 
 namespace TrenchBroom {
     namespace IO {
@@ -1374,5 +1379,152 @@ common/caulk
                 CHECK(face.attributes().textureName() == Model::BrushFaceAttributes::NoTextureName);
             }
         }
+
+        TEST_CASE("WorldReaderTest.parallelBrushCreation", "[WorldReaderTest]") {
+            // brushes of the worldspawn, a layer and an entity, interleaved with entities that reference the layer, and
+            // an invalid brush in the middle
+            const std::string data(R"(
+{
+"classname" "worldspawn"
+{
+( -64 -64 -16 ) ( -64 -63 -16 ) ( -64 -64 -15 ) tex1 0 0 0 1 1
+( -64 -64 -16 ) ( -64 -64 -15 ) ( -63 -64 -16 ) tex1 0 0 0 1 1
+( -64 -64 -16 ) ( -63 -64 -16 ) ( -64 -63 -16 ) tex1 0 0 0 1 1
+( 64 64 16 ) ( 64 65 16 ) ( 65 64 16 ) tex1 0 0 0 1 1
+( 64 64 16 ) ( 65 64 16 ) ( 64 64 17 ) tex1 0 0 0 1 1
+( 64 64 16 ) ( 64 64 17 ) ( 64 65 16 ) tex1 0 0 0 1 1
+}
+{
+( -64 -64 -16 ) ( -64 -63 -16 ) ( -64 -64 -15 ) tex2 0 0 0 1 1
+( 64 64 16 ) ( 64 65 16 ) ( 65 64 16 ) tex2 0 0 0 1 1
+( 64 64 16 ) ( 65 64 16 ) ( 64 64 17 ) tex2 0 0 0 1 1
+}
+{
+( -32 -32 -16 ) ( -32 -31 -16 ) ( -32 -32 -15 ) tex3 0 0 0 1 1
+( -32 -32 -16 ) ( -32 -32 -15 ) ( -31 -32 -16 ) tex3 0 0 0 1 1
+( -32 -32 -16 ) ( -31 -32 -16 ) ( -32 -31 -16 ) tex3 0 0 0 1 1
+( 32 32 16 ) ( 32 33 16 ) ( 33 32 16 ) tex3 0 0 0 1 1
+( 32 32 16 ) ( 33 32 16 ) ( 32 32 17 ) tex3 0 0 0 1 1
+( 32 32 16 ) ( 32 32 17 ) ( 32 33 16 ) tex3 0 0 0 1 1
+}
+}
+{
+"classname" "func_group"
+"_tb_type" "_tb_layer"
+"_tb_name" "layer"
+"_tb_id" "1"
+{
+( -64 -64 -16 ) ( -64 -63 -16 ) ( -64 -64 -15 ) tex4 0 0 0 1 1
+( -64 -64 -16 ) ( -64 -64 -15 ) ( -63 -64 -16 ) tex4 0 0 0 1 1
+( -64 -64 -16 ) ( -63 -64 -16 ) ( -64 -63 -16 ) tex4 0 0 0 1 1
+( 64 64 16 ) ( 64 65 16 ) ( 65 64 16 ) tex4 0 0 0 1 1
+( 64 64 16 ) ( 65 64 16 ) ( 64 64 17 ) tex4 0 0 0 1 1
+( 64 64 16 ) ( 64 64 17 ) ( 64 65 16 ) tex4 0 0 0 1 1
+}
+}
+{
+"classname" "info_player_start"
+"_tb_layer" "1"
+"origin" "32 32 0"
+}
+{
+"classname" "func_door"
+{
+( -16 -16 -16 ) ( -16 -15 -16 ) ( -16 -16 -15 ) tex5 0 0 0 1 1
+( -16 -16 -16 ) ( -16 -16 -15 ) ( -15 -16 -16 ) tex5 0 0 0 1 1
+( -16 -16 -16 ) ( -15 -16 -16 ) ( -16 -15 -16 ) tex5 0 0 0 1 1
+( 16 16 16 ) ( 16 17 16 ) ( 17 16 16 ) tex5 0 0 0 1 1
+( 16 16 16 ) ( 17 16 16 ) ( 16 16 17 ) tex5 0 0 0 1 1
+( 16 16 16 ) ( 16 16 17 ) ( 16 17 16 ) tex5 0 0 0 1 1
+}
+}
+{
+"classname" "light"
+"origin" "0 0 0"
+}
+)");
+
+            const vm::bbox3 worldBounds(8192.0);
+
+            const auto readAndWrite = [&](const MapReader::BrushCreation brushCreation, IO::TestParserStatus& status) {
+                WorldReader reader(data, brushCreation);
+                auto world = reader.read(Model::MapFormat::Standard, worldBounds, status);
+                REQUIRE(world != nullptr);
+
+                std::stringstream str;
+                NodeWriter writer(*world, str);
+                writer.writeMap();
+                return str.str();
+            };
+
+            IO::TestParserStatus immediateStatus;
+            const auto immediate = readAndWrite(MapReader::BrushCreation::Immediate, immediateStatus);
+
+            IO::TestParserStatus parallelStatus;
+            const auto parallel = readAndWrite(MapReader::BrushCreation::Parallel, parallelStatus);
+
+            CHECK(parallel == immediate);
+            CHECK(immediateStatus.countStatus(LogLevel::Error) == 1u);
+            CHECK(parallelStatus.countStatus(LogLevel::Error) == 1u);
+        }
+
+        /**
+         * Records the messages logged while reading a map in the order in which they were logged.
+         */
+        class RecordingParserStatus : public ParserStatus {
+        private:
+            static NullLogger _logger;
+            std::vector<std::string> m_messages;
+        public:
+            RecordingParserStatus() :
+            ParserStatus(_logger, "") {}
+
+            const std::vector<std::string>& messages() const {
+                return m_messages;
+            }
+        private:
+            void doProgress(const double /* progress */) override {}
+
+            void doLog(const LogLevel /* level */, const std::string& str) override {
+                m_messages.push_back(str);
+            }
+        };
+
+        NullLogger RecordingParserStatus::_logger;
+
+        TEST_CASE("WorldReaderTest.parallelBrushCreationMessageOrder", "[WorldReaderTest]") {
+            // warnings logged while parsing before and after an invalid brush
+            const std::string data(R"(
+{
+"classname" "light"
+"_tb_layer" "abc"
+}
+{
+"classname" "worldspawn"
+{
+( -64 -64 -16 ) ( -64 -63 -16 ) ( -64 -64 -15 ) tex2 0 0 0 1 1
+( 64 64 16 ) ( 64 65 16 ) ( 65 64 16 ) tex2 0 0 0 1 1
+( 64 64 16 ) ( 65 64 16 ) ( 64 64 17 ) tex2 0 0 0 1 1
+}
+}
+{
+"classname" "info_player_start"
+"_tb_layer" "xyz"
+}
+)");
+
+            const vm::bbox3 worldBounds(8192.0);
+
+            RecordingParserStatus immediateStatus;
+            WorldReader immediateReader(data, MapReader::BrushCreation::Immediate);
+            immediateReader.read(Model::MapFormat::Standard, worldBounds, immediateStatus);
+
+            RecordingParserStatus parallelStatus;
+            WorldReader parallelReader(data, MapReader::BrushCreation::Parallel);
+            parallelReader.read(Model::MapFormat::Standard, worldBounds, parallelStatus);
+
+            REQUIRE(immediateStatus.messages().size() == 3u);
+            CHECK(parallelStatus.messages() == immediateStatus.messages());
+        }
     }
 }
@@ -49,6 +49,7 @@
 #include <vecmath/ray.h>
 
 #include <algorithm>
+#include <cmath>
 #include <fstream>
 #include <memory>
 #include <string>
@@ -389,6 +390,75 @@ namespace TrenchBroom {
             ASSERT_TRUE(hits2.empty());
         }
 
+        TEST_CASE("BrushNodeTest.pickBrushWithSlantedFace", "[BrushNodeTest]") {
+            const vm::bbox3 worldBounds(4096.0);
+
+            // build a cube with length 16 at the origin and cut off one of its vertical edges
+            BrushNode brush(Brush(worldBounds, {
+                // left
+                BrushFace::createParaxial(
+                    vm::vec3(0.0, 0.0, 0.0),
+                    vm::vec3(0.0, 1.0, 0.0),
+                    vm::vec3(0.0, 0.0, 1.0)),
+                // right
+                BrushFace::createParaxial(
+                    vm::vec3(16.0, 0.0, 0.0),
+                    vm::vec3(16.0, 0.0, 1.0),
+                    vm::vec3(16.0, 1.0, 0.0)),
+                // front
+                BrushFace::createParaxial(
+                    vm::vec3(0.0, 0.0, 0.0),
+                    vm::vec3(0.0, 0.0, 1.0),
+                    vm::vec3(1.0, 0.0, 0.0)),
+                // back
+                BrushFace::createParaxial(
+                    vm::vec3(0.0, 16.0, 0.0),
+                    vm::vec3(1.0, 16.0, 0.0),
+                    vm::vec3(0.0, 16.0, 1.0)),
+                // top
+                BrushFace::createParaxial(
+                    vm::vec3(0.0, 0.0, 16.0),
+                    vm::vec3(0.0, 1.0, 16.0),
+                    vm::vec3(1.0, 0.0, 16.0)),
+                // bottom
+                BrushFace::createParaxial(
+                    vm::vec3(0.0, 0.0, 0.0),
+                    vm::vec3(1.0, 0.0, 0.0),
+                    vm::vec3(0.0, 1.0, 0.0)),
+                // slanted, x + y = 24
+                BrushFace::createParaxial(
+                    vm::vec3(24.0, 0.0, 0.0),
+                    vm::vec3(24.0, 0.0, 1.0),
+                    vm::vec3(0.0, 24.0, 0.0)),
+            }));
+
+            // passes through the bounds, but not through the brush
+            PickResult hits1;
+            brush.pick(vm::ray3(vm::vec3(15.0, 15.0, -8.0), vm::vec3::pos_z()), hits1);
+            ASSERT_TRUE(hits1.empty());
+
+            PickResult hits2;
+            brush.pick(vm::ray3(vm::vec3(10.0, 10.0, -8.0), vm::vec3::pos_z()), hits2);
+            ASSERT_EQ(1u, hits2.size());
+
+            const auto hit2 = hits2.all().front();
+            ASSERT_DOUBLE_EQ(8.0, hit2.distance());
+            ASSERT_EQ(vm::vec3::neg_z(), hitToFaceHandle(hit2)->face().boundary().normal);
+
+            PickResult hits3;
+            brush.pick(vm::ray3(vm::vec3(20.0, 20.0, 8.0), vm::normalize(vm::vec3(-1.0, -1.0, 0.0))), hits3);
+            ASSERT_EQ(1u, hits3.size());
+
+            const auto hit3 = hits3.all().front();
+            ASSERT_TRUE(vm::is_equal(8.0 * std::sqrt(2.0), hit3.distance(), 0.001));
+            ASSERT_VEC_EQ(vm::normalize(vm::vec3(1.0, 1.0, 0.0)), hitToFaceHandle(hit3)->face().boundary().normal);
+
+            // starts inside of the brush
+            PickResult hits4;
+            brush.pick(vm::ray3(vm::vec3(8.0, 8.0, 8.0), vm::vec3::pos_x()), hits4);
+            ASSERT_TRUE(hits4.empty());
+        }
+
         TEST_CASE("BrushNodeTest.clone", "[BrushNodeTest]") {
             const vm::bbox3 worldBounds(4096.0);
 
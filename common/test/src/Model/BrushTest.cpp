@@ -34,6 +34,8 @@
 #include "Model/Polyhedron.h"
 #include "Model/WorldNode.h"
 
+#include <vecmath/mat.h>
+#include <vecmath/mat_ext.h>
 #include <vecmath/polygon.h>
 #include <vecmath/ray.h>
 #include <vecmath/segment.h>
@@ -448,6 +450,88 @@ namespace TrenchBroom {
             EXPECT_FALSE(brush1.canMoveBoundary(worldBounds, *rightFaceIndex, vm::vec3(8000, 0, 0)));
         }
 
+        static void checkTranslationMatchesRebuild(const Brush& brush, const vm::vec3& offset, const vm::bbox3& worldBounds) {
+            const auto transformation = vm::translation_matrix(offset);
+
+            // rebuilding the brush from its transformed faces is what Brush::transform does for general transformations
+            auto expectedFaces = brush.faces();
+            for (auto& face : expectedFaces) {
+                face.transform(transformation, false);
+            }
+            const Brush expected(worldBounds, std::move(expectedFaces));
+
+            Brush actual = brush;
+            REQUIRE(actual.canTransform(transformation, worldBounds));
+            actual.transform(transformation, false, worldBounds);
+
+            CHECK(actual.bounds() == expected.bounds());
+            REQUIRE(actual.vertexCount() == expected.vertexCount());
+            for (const auto& position : expected.vertexPositions()) {
+                CHECK(actual.hasVertex(position, 0.0));
+            }
+            REQUIRE(actual.faceCount() == expected.faceCount());
+            for (const auto& expectedFace : expected.faces()) {
+                const auto actualFaceIndex = actual.findFace(expectedFace.boundary().normal);
+                REQUIRE(actualFaceIndex);
+                const auto& actualFace = actual.face(*actualFaceIndex);
+                CHECK(actualFace.points() == expectedFace.points());
+                CHECK(actualFace.boundary() == expectedFace.boundary());
+                CHECK(actualFace.attributes() == expectedFace.attributes());
+                CHECK(actualFace.hasVertices(expectedFace.polygon(), 0.0));
+            }
+        }
+
+        TEST_CASE("BrushTest.translateIntegral", "[BrushTest]") {
+            const vm::bbox3 worldBounds(8192.0);
+            WorldNode world(MapFormat::Valve);
+            const BrushBuilder builder(&world, worldBounds);
+
+            const Brush cube = builder.createCube(64.0, "texture");
+            const Brush wedge = builder.createBrush(std::vector<vm::vec3>{vm::vec3(64, -64, 16), vm::vec3(64, 64, 16), vm::vec3(64, -64, -16), vm::vec3(64, 64, -16), vm::vec3(48, 64, 16), vm::vec3(48, 64, -16)}, "texture");
+
+            for (const auto& offset : { vm::vec3(16, 0, 0), vm::vec3(-3, 7, 1024), vm::vec3(0, 0, 0) }) {
+                checkTranslationMatchesRebuild(cube, offset, worldBounds);
+                checkTranslationMatchesRebuild(wedge, offset, worldBounds);
+            }
+
+            // translating past the world bounds fails like any other transformation
+            CHECK_FALSE(cube.canTransform(vm::translation_matrix(vm::vec3(8192, 0, 0)), worldBounds));
+        }
+
+        TEST_CASE("BrushTest.copySharesGeometryUntilModified", "[BrushTest]") {
+            const vm::bbox3 worldBounds(8192.0);
+            WorldNode world(MapFormat::Standard);
+            const BrushBuilder builder(&world, worldBounds);
+
+            const Brush original = builder.createCube(64.0, "texture");
+            const auto originalBounds = original.bounds();
+
+            Brush translated = original;
+            CHECK(translated.sharesGeometryWith(original));
+
+            translated.transform(vm::translation_matrix(vm::vec3(16, 0, 0)), false, worldBounds);
+            CHECK_FALSE(translated.sharesGeometryWith(original));
+            CHECK(original.bounds() == originalBounds);
+            CHECK(translated.bounds() == vm::bbox3(vm::vec3(-16, -32, -32), vm::vec3(48, 32, 32)));
+            for (const auto& face : translated.faces()) {
+                for (const auto& position : face.vertexPositions()) {
+                    CHECK(translated.bounds().contains(position));
+                }
+            }
+            for (const auto& face : original.faces()) {
+                for (const auto& position : face.vertexPositions()) {
+                    CHECK(originalBounds.contains(position));
+                }
+            }
+
+            Brush expanded = original;
+            CHECK(expanded.sharesGeometryWith(original));
+            CHECK(expanded.expand(worldBounds, 8, false));
+            CHECK_FALSE(expanded.sharesGeometryWith(original));
+            CHECK(original.bounds() == originalBounds);
+            CHECK(expanded.bounds() == vm::bbox3(40.0));
+        }
+
         TEST_CASE("BrushTest.expand", "[BrushTest]") {
             const vm::bbox3 worldBounds(8192.0);
             WorldNode world(MapFormat::Standard);
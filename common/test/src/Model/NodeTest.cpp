@@ -26,6 +26,7 @@
 #include "Model/BrushBuilder.h"
 #include "Model/BrushFace.h"
 #include "Model/BrushFaceAttributes.h"
+#include "Model/CollectContainedNodesVisitor.h"
 #include "Model/CollectTouchingNodesVisitor.h"
 #include "Model/EditorContext.h"
 #include "Model/GroupNode.h"
@@ -43,6 +44,7 @@
 #include <vecmath/ray.h>
 #include <vecmath/mat_ext.h>
 
+#include <algorithm>
 #include <vector>
 #include <variant>
 
@@ -509,5 +511,64 @@ namespace TrenchBroom {
 
             CHECK(std::vector<Node*>{brush2} == visitor.nodes());
         }
+
+        TEST_CASE("CollectTouchingAndContainedNodesInWorldVisitor", "[NodeVisitorTest]") {
+            const vm::bbox3 worldBounds(8192.0);
+            EditorContext context;
+
+            WorldNode map(Model::MapFormat::Standard);
+            map.addOrUpdateAttribute("classname", "worldspawn");
+
+            BrushBuilder builder(&map, worldBounds);
+            const auto createBrush = [&](const vm::vec3& min, const vm::vec3& max) {
+                return map.createBrush(builder.createCuboid(vm::bbox3(min, max), "none"));
+            };
+
+            // a grid of brushes which overlap their neighbours
+            std::vector<BrushNode*> gridBrushes;
+            for (int x = 0; x < 8; ++x) {
+                for (int y = 0; y < 8; ++y) {
+                    const auto min = vm::vec3(48.0 * x, 48.0 * y, 0.0);
+                    gridBrushes.push_back(createBrush(min, min + vm::vec3(64.0, 64.0, 64.0)));
+                    map.defaultLayer()->addChild(gridBrushes.back());
+                }
+            }
+
+            // a group whose bounds enclose the query brushes, but whose brushes do not touch them
+            auto* group = new GroupNode("group");
+            group->addChild(createBrush(vm::vec3(-512.0, -512.0, 512.0), vm::vec3(-448.0, -448.0, 576.0)));
+            group->addChild(createBrush(vm::vec3(512.0, 512.0, 512.0), vm::vec3(576.0, 576.0, 576.0)));
+            map.defaultLayer()->addChild(group);
+
+            auto* query1 = createBrush(vm::vec3(40.0, 40.0, -32.0), vm::vec3(160.0, 160.0, 544.0));
+            auto* query2 = createBrush(vm::vec3(200.0, 0.0, -32.0), vm::vec3(264.0, 104.0, 96.0));
+            map.defaultLayer()->addChild(query1);
+            map.defaultLayer()->addChild(query2);
+            const auto query = std::vector<BrushNode*>{query1, query2};
+
+            const auto sorted = [](std::vector<Node*> nodes) {
+                std::sort(std::begin(nodes), std::end(nodes));
+                return nodes;
+            };
+
+            auto touching = CollectTouchingNodesVisitor(std::begin(query), std::end(query), context);
+            map.acceptAndRecurse(touching);
+
+            auto touchingInWorld = CollectTouchingNodesInWorldVisitor(map, query, context);
+            map.acceptAndRecurse(touchingInWorld);
+
+            CHECK(kdl::vec_contains(touching.nodes(), group));
+            CHECK_FALSE(kdl::vec_contains(touching.nodes(), gridBrushes.back()));
+            CHECK(sorted(touchingInWorld.nodes()) == sorted(touching.nodes()));
+
+            auto contained = CollectContainedNodesVisitor(std::begin(query), std::end(query), context);
+            map.acceptAndRecurse(contained);
+
+            auto containedInWorld = CollectContainedNodesInWorldVisitor(map, query, context);
+            map.acceptAndRecurse(containedInWorld);
+
+            CHECK_FALSE(contained.nodes().empty());
+            CHECK(sorted(containedInWorld.nodes()) == sorted(contained.nodes()));
+        }
     }
 }
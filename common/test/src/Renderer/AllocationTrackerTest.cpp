@@ -22,6 +22,8 @@
 #include "GTestCompat.h"
 #include <random>
 #include <algorithm>
+#include <iterator>
+#include <limits>
 #include <vector>
 
 #include "Renderer/AllocationTracker.h"
@@ -246,6 +248,148 @@ namespace TrenchBroom {
             }
         }
 
+        TEST_CASE("AllocationTrackerTest.fragmentation", "[AllocationTrackerTest]") {
+            AllocationTracker t(500);
+            EXPECT_EQ(0u, t.usedSize());
+            EXPECT_EQ(500u, t.freeSize());
+            EXPECT_EQ(0u, t.fragmentedSize());
+            EXPECT_EQ(0.0, t.fragmentation());
+
+            AllocationTracker::Block* blocks[5];
+            for (size_t i = 0; i < 5; ++i) {
+                blocks[i] = t.allocate(100);
+                ASSERT_NE(nullptr, blocks[i]);
+            }
+            EXPECT_EQ(500u, t.usedSize());
+            EXPECT_EQ(0u, t.freeSize());
+            EXPECT_EQ(0u, t.fragmentedSize());
+
+            t.free(blocks[1]);
+            t.free(blocks[3]);
+            EXPECT_EQ(300u, t.usedSize());
+            EXPECT_EQ(200u, t.freeSize());
+            EXPECT_EQ(200u, t.fragmentedSize());
+            EXPECT_DOUBLE_EQ(0.4, t.fragmentation());
+
+            // free space at the end is not a hole
+            t.free(blocks[4]);
+            EXPECT_EQ(200u, t.usedSize());
+            EXPECT_EQ(300u, t.freeSize());
+            EXPECT_EQ(100u, t.fragmentedSize());
+            EXPECT_DOUBLE_EQ(0.2, t.fragmentation());
+        }
+
+        TEST_CASE("AllocationTrackerTest.compactEmpty", "[AllocationTrackerTest]") {
+            size_t moveCount = 0;
+            const auto move = [&](AllocationTracker::Block*, size_t) { ++moveCount; };
+
+            AllocationTracker t;
+            EXPECT_TRUE(t.compact(100, move));
+
+            t.expand(100);
+            EXPECT_TRUE(t.compact(100, move));
+            EXPECT_EQ((std::vector<AllocationTracker::Range>{{0, 100}}), t.freeBlocks());
+            EXPECT_EQ(0u, moveCount);
+        }
+
+        TEST_CASE("AllocationTrackerTest.compactMovesBlocksTowardsStart", "[AllocationTrackerTest]") {
+            AllocationTracker t(500);
+
+            AllocationTracker::Block* blocks[5];
+            for (size_t i = 0; i < 5; ++i) {
+                blocks[i] = t.allocate(100);
+            }
+            t.free(blocks[0]);
+            t.free(blocks[2]);
+
+            std::vector<std::pair<AllocationTracker::Block*, size_t>> moves;
+            EXPECT_TRUE(t.compact(1000, [&](AllocationTracker::Block* block, const size_t oldPos) {
+                moves.emplace_back(block, oldPos);
+            }));
+
+            EXPECT_EQ((std::vector<std::pair<AllocationTracker::Block*, size_t>>{
+                {blocks[1], 100},
+                {blocks[3], 300},
+                {blocks[4], 400}
+            }), moves);
+
+            EXPECT_EQ(0u, blocks[1]->pos);
+            EXPECT_EQ(100u, blocks[3]->pos);
+            EXPECT_EQ(200u, blocks[4]->pos);
+            EXPECT_EQ((std::vector<AllocationTracker::Range>{{0, 100}, {100, 100}, {200, 100}}), t.usedBlocks());
+            EXPECT_EQ((std::vector<AllocationTracker::Range>{{300, 200}}), t.freeBlocks());
+            EXPECT_EQ(0u, t.fragmentedSize());
+            EXPECT_EQ(200u, t.largestPossibleAllocation());
+
+            // blocks can still be freed and allocated after compaction
+            t.free(blocks[3]);
+            EXPECT_EQ((std::vector<AllocationTracker::Range>{{100, 100}, {300, 200}}), t.freeBlocks());
+            EXPECT_NE(nullptr, t.allocate(200));
+        }
+
+        /**
+         * Randomly allocates and frees blocks, filling each block's range of the given buffer with a value unique to
+         * the block, and then compacts the tracker in steps of the given size, moving the buffer contents along.
+         * Checks that every block still has its contents afterwards.
+         */
+        static void checkCompactPreservesContents(const size_t maxMoveSize) {
+            std::mt19937 randEngine;
+            std::uniform_int_distribution<size_t> sizeDist(1, 64);
+
+            AllocationTracker t(4096);
+            std::vector<size_t> buffer(t.capacity(), 0u);
+            std::vector<std::pair<AllocationTracker::Block*, size_t>> blocks;
+
+            size_t nextValue = 1;
+            for (size_t i = 0; i < 256; ++i) {
+                if (!blocks.empty() && randEngine() % 3u == 0u) {
+                    const auto index = randEngine() % blocks.size();
+                    t.free(blocks[index].first);
+                    blocks.erase(std::next(std::begin(blocks), static_cast<std::ptrdiff_t>(index)));
+                } else if (auto* block = t.allocate(sizeDist(randEngine))) {
+                    std::fill_n(std::next(std::begin(buffer), static_cast<std::ptrdiff_t>(block->pos)), block->size, nextValue);
+                    blocks.emplace_back(block, nextValue++);
+                }
+            }
+            ASSERT_GT(t.fragmentedSize(), 0u);
+
+            const auto usedSize = t.usedSize();
+            size_t stepCount = 0;
+            bool done = false;
+            while (!done) {
+                done = t.compact(maxMoveSize, [&](AllocationTracker::Block* block, const size_t oldPos) {
+                    ASSERT_LT(block->pos, oldPos);
+                    const auto first = std::next(std::begin(buffer), static_cast<std::ptrdiff_t>(oldPos));
+                    std::copy(first, std::next(first, static_cast<std::ptrdiff_t>(block->size)),
+                              std::next(std::begin(buffer), static_cast<std::ptrdiff_t>(block->pos)));
+                });
+                ++stepCount;
+                ASSERT_LE(stepCount, usedSize);
+            }
+
+            if (maxMoveSize < usedSize) {
+                EXPECT_GT(stepCount, 1u);
+            }
+
+            EXPECT_EQ(usedSize, t.usedSize());
+            EXPECT_EQ(0u, t.fragmentedSize());
+            EXPECT_EQ((std::vector<AllocationTracker::Range>{{usedSize, t.capacity() - usedSize}}), t.freeBlocks());
+
+            for (const auto& [block, value] : blocks) {
+                for (size_t i = block->pos; i < block->pos + block->size; ++i) {
+                    ASSERT_EQ(value, buffer[i]);
+                }
+            }
+        }
+
+        TEST_CASE("AllocationTrackerTest.compactPreservesContents", "[AllocationTrackerTest]") {
+            checkCompactPreservesContents(std::numeric_limits<size_t>::max());
+        }
+
+        TEST_CASE("AllocationTrackerTest.compactIncrementallyPreservesContents", "[AllocationTrackerTest]") {
+            checkCompactPreservesContents(32);
+        }
+
         static constexpr size_t NumBrushes = 64'000;
 
         // between 12 and 140, inclusive.
@@ -0,0 +1,95 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <catch2/catch.hpp>
+
+#include "GTestCompat.h"
+
+#include "Model/BrushBuilder.h"
+#include "Model/BrushNode.h"
+#include "Model/MapFormat.h"
+#include "Model/WorldNode.h"
+#include "Renderer/BrushRenderer.h"
+#include "Renderer/FontManager.h"
+#include "Renderer/PerspectiveCamera.h"
+#include "Renderer/RenderBatch.h"
+#include "Renderer/RenderContext.h"
+#include "Renderer/ShaderManager.h"
+#include "Renderer/VboManager.h"
+
+#include <kdl/vector_utils.h>
+
+#include <vecmath/bbox.h>
+
+#include <unordered_set>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Renderer {
+        static std::vector<Model::BrushNode*> makeBrushes(Model::WorldNode& world, const size_t count) {
+            const vm::bbox3 worldBounds(4096.0);
+            Model::BrushBuilder builder(&world, worldBounds);
+
+            std::vector<Model::BrushNode*> result;
+            for (size_t i = 0; i < count; ++i) {
+                result.push_back(world.createBrush(builder.createCube(64.0, "")));
+            }
+            return result;
+        }
+
+        TEST_CASE("BrushRendererTest.frustumCulling", "[BrushRendererTest]") {
+            Model::WorldNode world(Model::MapFormat::Standard);
+
+            // these brushes are never added to the world, like the brushes previewed by the tools
+            auto brushes = makeBrushes(world, 3u);
+
+            FontManager fontManager;
+            ShaderManager shaderManager;
+            VboManager vboManager(&shaderManager);
+            PerspectiveCamera camera;
+
+            // the visible nodes only contain the first brush
+            RenderContext renderContext(RenderMode::Render3D, camera, fontManager, shaderManager);
+            renderContext.setVisibleNodes({ brushes[0] }, { brushes[0] });
+            ASSERT_TRUE(renderContext.frustumCulling());
+
+            SECTION("Renderers render all brushes by default") {
+                BrushRenderer renderer;
+                renderer.addBrushes(brushes);
+
+                RenderBatch renderBatch(vboManager);
+                renderer.render(renderContext, renderBatch);
+                ASSERT_EQ(0u, renderContext.culledBrushCount());
+            }
+
+            SECTION("Renderers with frustum culling skip brushes that are not visible") {
+                BrushRenderer renderer;
+                renderer.setFrustumCulling(true);
+                renderer.addBrushes(brushes);
+
+                RenderBatch renderBatch(vboManager);
+                renderer.render(renderContext, renderBatch);
+                ASSERT_EQ(2u, renderContext.culledBrushCount());
+            }
+
+            kdl::vec_clear_and_delete(brushes);
+        }
+    }
+}
@@ -0,0 +1,83 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <catch2/catch.hpp>
+
+#include "GTestCompat.h"
+
+#include "Renderer/EntityModelBatches.h"
+#include "Renderer/TexturedIndexRangeRenderer.h"
+
+#include <vecmath/mat.h>
+#include <vecmath/mat_ext.h>
+#include <vecmath/vec.h>
+
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Renderer {
+        TEST_CASE("EntityModelBatchesTest.groupInstancesByRenderer", "[EntityModelBatchesTest]") {
+            TexturedIndexRangeRenderer renderer1;
+            TexturedIndexRangeRenderer renderer2;
+
+            const auto t1 = vm::translation_matrix(vm::vec3f(1, 0, 0));
+            const auto t2 = vm::translation_matrix(vm::vec3f(2, 0, 0));
+            const auto t3 = vm::translation_matrix(vm::vec3f(3, 0, 0));
+            const auto t4 = vm::translation_matrix(vm::vec3f(4, 0, 0));
+
+            EntityModelBatches batches;
+            CHECK(batches.empty());
+            CHECK(batches.instanceCount() == 0u);
+
+            batches.add(&renderer2, t1);
+            batches.add(&renderer1, t2);
+            batches.add(&renderer2, t3);
+            batches.add(&renderer2, t4);
+
+            CHECK_FALSE(batches.empty());
+            CHECK(batches.instanceCount() == 4u);
+
+            const auto& result = batches.batches();
+            REQUIRE(result.size() == 2u);
+            CHECK(result[0].renderer == &renderer2);
+            CHECK(result[0].transformations == std::vector<vm::mat4x4f>{ t1, t3, t4 });
+            CHECK(result[1].renderer == &renderer1);
+            CHECK(result[1].transformations == std::vector<vm::mat4x4f>{ t2 });
+        }
+
+        TEST_CASE("EntityModelBatchesTest.clear", "[EntityModelBatchesTest]") {
+            TexturedIndexRangeRenderer renderer1;
+            TexturedIndexRangeRenderer renderer2;
+
+            EntityModelBatches batches;
+            batches.add(&renderer1, vm::mat4x4f::identity());
+            batches.add(&renderer2, vm::mat4x4f::identity());
+
+            batches.clear();
+            CHECK(batches.empty());
+            CHECK(batches.instanceCount() == 0u);
+
+            batches.add(&renderer2, vm::mat4x4f::identity());
+            REQUIRE(batches.batches().size() == 1u);
+            CHECK(batches.batches()[0].renderer == &renderer2);
+            CHECK(batches.batches()[0].transformations.size() == 1u);
+        }
+    }
+}
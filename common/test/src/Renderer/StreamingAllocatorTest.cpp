@@ -0,0 +1,112 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <catch2/catch.hpp>
+
+#include "GTestCompat.h"
+
+#include "Renderer/StreamingAllocator.h"
+
+namespace TrenchBroom {
+    namespace Renderer {
+        TEST_CASE("StreamingAllocatorTest.allocateInFrame", "[StreamingAllocatorTest]") {
+            StreamingAllocator allocator(100u);
+            ASSERT_EQ(0u, allocator.bufferCount());
+
+            auto block = allocator.allocate(30u, 16u);
+            CHECK(block.buffer == 0u);
+            CHECK(block.offset == 0u);
+            CHECK(block.firstInFrame);
+            CHECK(block.newBuffer);
+            CHECK(allocator.bufferCount() == 1u);
+
+            block = allocator.allocate(30u, 16u);
+            CHECK(block.buffer == 0u);
+            CHECK(block.offset == 32u);
+            CHECK_FALSE(block.firstInFrame);
+            CHECK_FALSE(block.newBuffer);
+
+            // does not fit into the remaining space of the first buffer
+            block = allocator.allocate(50u, 16u);
+            CHECK(block.buffer == 1u);
+            CHECK(block.offset == 0u);
+            CHECK(block.firstInFrame);
+            CHECK(block.newBuffer);
+            CHECK(allocator.bufferCount() == 2u);
+            CHECK(allocator.totalCapacity() == 200u);
+        }
+
+        TEST_CASE("StreamingAllocatorTest.reuseBuffersAfterFramesInFlight", "[StreamingAllocatorTest]") {
+            StreamingAllocator allocator(100u);
+
+            auto block = allocator.allocate(60u, 16u);
+            CHECK(block.buffer == 0u);
+            CHECK(block.newBuffer);
+
+            // the first buffer may still be in use by the GPU
+            allocator.beginFrame();
+            block = allocator.allocate(60u, 16u);
+            CHECK(block.buffer == 1u);
+            CHECK(block.newBuffer);
+
+            for (size_t i = 0u; i < 6u; ++i) {
+                allocator.beginFrame();
+                block = allocator.allocate(60u, 16u);
+                CHECK(block.offset == 0u);
+                CHECK(block.firstInFrame);
+            }
+
+            // the ring stops growing once it holds the data of the frames in flight
+            CHECK(allocator.bufferCount() == StreamingAllocator::FramesInFlight);
+            CHECK_FALSE(block.newBuffer);
+        }
+
+        TEST_CASE("StreamingAllocatorTest.allocateOversizedBlock", "[StreamingAllocatorTest]") {
+            StreamingAllocator allocator(100u);
+
+            allocator.allocate(60u, 16u);
+            const auto block = allocator.allocate(500u, 16u);
+            CHECK(block.offset == 0u);
+            CHECK(block.newBuffer);
+            CHECK(allocator.bufferCapacity(block.buffer) == 500u);
+            CHECK(allocator.bufferCount() == 2u);
+        }
+
+        TEST_CASE("StreamingAllocatorTest.frameStatistics", "[StreamingAllocatorTest]") {
+            StreamingAllocator allocator(100u);
+
+            allocator.allocate(30u, 16u);
+            allocator.allocate(30u, 16u);
+            CHECK(allocator.bytesThisFrame() == 62u);
+            CHECK(allocator.bytesLastFrame() == 0u);
+
+            allocator.beginFrame();
+            CHECK(allocator.currentFrame() == 1u);
+            CHECK(allocator.bytesThisFrame() == 0u);
+            CHECK(allocator.bytesLastFrame() == 62u);
+            CHECK(allocator.peakBytesPerFrame() == 62u);
+
+            allocator.allocate(10u, 16u);
+            allocator.beginFrame();
+            CHECK(allocator.bytesLastFrame() == 10u);
+            CHECK(allocator.peakBytesPerFrame() == 62u);
+        }
+    }
+}
@@ -54,6 +54,7 @@
 #include <vecmath/scalar.h>
 #include <vecmath/ray.h>
 
+#include "kdl/parallel.h"
 #include "kdl/vector_utils.h"
 
 namespace TrenchBroom {
@@ -493,6 +494,34 @@ namespace TrenchBroom {
             EXPECT_EQ(expectedBBox2, remainder2->logicalBounds());
         }
 
+        TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.csgSubtractManyMinuendsKeepsOrder") {
+            const Model::BrushBuilder builder(document->world(), document->worldBounds());
+
+            auto* entity = new Model::EntityNode();
+            document->addNode(entity, document->parentForNodes());
+
+            const size_t minuendCount = 32u;
+            std::vector<Model::Node*> minuends;
+            for (size_t i = 0u; i < minuendCount; ++i) {
+                const auto x = static_cast<FloatType>(i * 64u);
+                minuends.push_back(document->world()->createBrush(builder.createCuboid(vm::bbox3(vm::vec3(x, 0, 0), vm::vec3(x + 64, 64, 64)), "texture")));
+            }
+            document->addNodes(minuends, entity);
+
+            const auto length = static_cast<FloatType>(minuendCount * 64u);
+            Model::BrushNode* subtrahend = document->world()->createBrush(builder.createCuboid(vm::bbox3(vm::vec3(0, 0, 32), vm::vec3(length, 64, 64)), "texture"));
+            document->addNode(subtrahend, entity);
+
+            document->select(subtrahend);
+            ASSERT_TRUE(document->csgSubtract());
+            ASSERT_EQ(minuendCount, entity->children().size());
+
+            for (size_t i = 0u; i < minuendCount; ++i) {
+                const auto x = static_cast<FloatType>(i * 64u);
+                EXPECT_EQ(vm::bbox3(vm::vec3(x, 0, 0), vm::vec3(x + 64, 64, 32)), entity->children()[i]->logicalBounds());
+            }
+        }
+
         TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.csgSubtractAndUndoRestoresSelection") {
             const Model::BrushBuilder builder(document->world(), document->worldBounds());
 
@@ -1116,6 +1145,48 @@ namespace TrenchBroom {
             kdl::vec_clear_and_delete(issueGenerators);
         }
 
+        TEST_CASE_METHOD(MapDocumentTest, "IssueGenerator.validateIssuesInParallel") {
+            std::vector<Model::Node*> entities;
+            for (size_t i = 0; i < 1000u; ++i) {
+                Model::EntityNode* entity = document->createPointEntity(m_pointEntityDef, vm::vec3::zero());
+                entity->addOrUpdateAttribute("", "");
+                entities.push_back(entity);
+            }
+
+            auto issueGenerators = std::vector<Model::IssueGenerator*>{
+                new Model::EmptyAttributeNameIssueGenerator(),
+                new Model::EmptyAttributeValueIssueGenerator()
+            };
+
+            for (auto* entity : entities) {
+                CHECK_FALSE(entity->issuesValid());
+            }
+
+            kdl::parallel_for(entities.size(), [&](const size_t i) {
+                entities[i]->validateIssues(issueGenerators);
+            });
+
+            std::vector<size_t> seqIds;
+            for (auto* entity : entities) {
+                CHECK(entity->issuesValid());
+
+                const auto& issues = entity->issues(issueGenerators);
+                CHECK(issues.size() == 2u);
+                for (const auto* issue : issues) {
+                    seqIds.push_back(issue->seqId());
+                }
+            }
+
+            // every issue must have a unique sequence id even though they were created on different threads
+            kdl::vec_sort_and_remove_duplicates(seqIds);
+            CHECK(seqIds.size() == 2u * entities.size());
+
+            entities.front()->invalidateIssues();
+            CHECK_FALSE(entities.front()->issuesValid());
+
+            kdl::vec_clear_and_delete(issueGenerators);
+        }
+
         TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.defaultLayerSortIndexImmutable", "[LayerTest]") {
             Model::LayerNode* defaultLayer = document->world()->defaultLayer();
 
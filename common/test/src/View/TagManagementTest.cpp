@@ -601,5 +601,51 @@ namespace TrenchBroom {
                 CHECK(!faces[i].hasTag(tag));
             }
         }
+
+        TEST_CASE_METHOD(TagManagementTest, "TagManagementTest.tagUpdateBrushFaceTagsAfterChangingTexture", "[TagManagementTest]") {
+            auto* brushNode1 = createBrushNode("asdf");
+            auto* brushNode2 = createBrushNode("some_texture");
+            document->addNode(brushNode1, document->parentForNodes());
+            document->addNode(brushNode2, document->parentForNodes());
+
+            const auto& textureTag = document->smartTag("texture");
+            const auto& patternTag = document->smartTag("texturePattern");
+            const auto& surfaceParmTag = document->smartTag("surfaceparm_multi");
+
+            for (const auto& face : brushNode2->brush().faces()) {
+                CHECK(face.hasTag(textureTag));
+                CHECK(face.hasTag(surfaceParmTag));
+                CHECK(!face.hasTag(patternTag));
+            }
+
+            const auto faceHandle = Model::BrushFaceHandle(brushNode1, 0u);
+            document->select(faceHandle);
+
+            Model::ChangeBrushFaceAttributesRequest request;
+            request.setTextureName("some_texture");
+            document->setFaceAttributes(request);
+
+            CHECK(faceHandle.face().hasTag(textureTag));
+            CHECK(faceHandle.face().hasTag(surfaceParmTag));
+            CHECK(!faceHandle.face().hasTag(patternTag));
+
+            request.setTextureName("other_texture");
+            document->setFaceAttributes(request);
+
+            CHECK(!faceHandle.face().hasTag(textureTag));
+            CHECK(faceHandle.face().hasTag(surfaceParmTag));
+            CHECK(faceHandle.face().hasTag(patternTag));
+
+            request.setTextureName("asdf");
+            document->setFaceAttributes(request);
+
+            CHECK(!faceHandle.face().hasTag(textureTag));
+            CHECK(!faceHandle.face().hasTag(surfaceParmTag));
+            CHECK(!faceHandle.face().hasTag(patternTag));
+
+            for (const auto& face : brushNode2->brush().faces()) {
+                CHECK(face.hasTag(textureTag));
+            }
+        }
     }
 }
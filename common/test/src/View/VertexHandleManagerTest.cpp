@@ -0,0 +1,320 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <catch2/catch.hpp>
+
+#include "GTestCompat.h"
+
+#include "PreferenceManager.h"
+#include "Preferences.h"
+#include "Model/Hit.h"
+#include "Model/PickResult.h"
+#include "Renderer/OrthographicCamera.h"
+#include "Renderer/PerspectiveCamera.h"
+#include "View/Grid.h"
+#include "View/VertexHandleManager.h"
+
+#include <vecmath/distance.h>
+#include <vecmath/intersection.h>
+#include <vecmath/plane.h>
+#include <vecmath/polygon.h>
+#include <vecmath/ray.h>
+#include <vecmath/segment.h>
+#include <vecmath/vec.h>
+
+#include <algorithm>
+#include <random>
+#include <tuple>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace View {
+        static std::vector<vm::vec3> makeHandlePositions(const size_t count) {
+            std::mt19937 rng(1337u);
+            std::uniform_int_distribution<int> coord(-64, 64);
+
+            std::vector<vm::vec3> result;
+            result.reserve(count);
+            for (size_t i = 0; i < count; ++i) {
+                result.emplace_back(16.0 * coord(rng), 16.0 * coord(rng), 16.0 * coord(rng));
+            }
+            return result;
+        }
+
+        /**
+         * Returns edge handles along the axes with random lengths.
+         */
+        static std::vector<vm::segment3> makeEdgeHandles(const size_t count) {
+            std::mt19937 rng(1337u);
+            std::uniform_int_distribution<int> coord(-64, 64);
+            std::uniform_int_distribution<int> length(1, 8);
+            std::uniform_int_distribution<size_t> axis(0u, 2u);
+
+            std::vector<vm::segment3> result;
+            result.reserve(count);
+            for (size_t i = 0; i < count; ++i) {
+                const auto start = vm::vec3(16.0 * coord(rng), 16.0 * coord(rng), 16.0 * coord(rng));
+                auto end = start;
+                end[axis(rng)] += 16.0 * length(rng);
+                result.emplace_back(start, end);
+            }
+            return result;
+        }
+
+        /**
+         * Returns axis aligned rectangular face handles with random sizes.
+         */
+        static std::vector<vm::polygon3> makeFaceHandles(const size_t count) {
+            std::mt19937 rng(1337u);
+            std::uniform_int_distribution<int> coord(-64, 64);
+            std::uniform_int_distribution<int> length(1, 8);
+            std::uniform_int_distribution<size_t> axis(0u, 2u);
+
+            std::vector<vm::polygon3> result;
+            result.reserve(count);
+            for (size_t i = 0; i < count; ++i) {
+                const auto normalAxis = axis(rng);
+                const auto uAxis = (normalAxis + 1u) % 3u;
+                const auto vAxis = (normalAxis + 2u) % 3u;
+
+                const auto origin = vm::vec3(16.0 * coord(rng), 16.0 * coord(rng), 16.0 * coord(rng));
+                auto u = vm::vec3::zero();
+                u[uAxis] = 16.0 * length(rng);
+                auto v = vm::vec3::zero();
+                v[vAxis] = 16.0 * length(rng);
+
+                result.emplace_back(std::vector<vm::vec3>({ origin, origin + u, origin + u + v, origin + v }));
+            }
+            return result;
+        }
+
+        template <typename T>
+        static std::vector<T> sortedHitTargets(const Model::PickResult& pickResult) {
+            auto result = std::vector<T>();
+            for (const auto& hit : pickResult.all()) {
+                result.push_back(hit.target<T>());
+            }
+            std::sort(std::begin(result), std::end(result));
+            return result;
+        }
+
+        /**
+         * Checks that both given pick functions find the same handles for pick rays spread over the viewport of a
+         * perspective and an orthographic camera, and that they find some handles.
+         */
+        template <typename P1, typename P2>
+        static void checkPicks(const P1& pickAll, const P2& pickIndexed) {
+            const Renderer::Camera::Viewport viewport(0, 0, 1024, 768);
+            const Renderer::PerspectiveCamera perspectiveCamera(90.0f, 1.0f, 8000.0f, viewport, vm::vec3f(-2048.0f, 0.0f, 0.0f), vm::vec3f::pos_x(), vm::vec3f::pos_z());
+            const Renderer::OrthographicCamera orthographicCamera(1.0f, 8000.0f, viewport, vm::vec3f(0.0f, 0.0f, 2048.0f), vm::vec3f::neg_z(), vm::vec3f::pos_y());
+
+            const auto cameras = std::vector<const Renderer::Camera*>({ &perspectiveCamera, &orthographicCamera });
+            for (const auto* camera : cameras) {
+                auto hitCount = size_t(0);
+                for (int x = 0; x < viewport.width; x += 64) {
+                    for (int y = 0; y < viewport.height; y += 64) {
+                        const auto pickRay = vm::ray3(camera->pickRay(x, y));
+                        const auto expected = pickAll(pickRay, *camera);
+                        CHECK(pickIndexed(pickRay, *camera) == expected);
+                        hitCount += expected.size();
+                    }
+                }
+                CHECK(hitCount > 0u);
+            }
+        }
+
+        /**
+         * Picks the handles of the given manager by testing every handle and returns the hit handles in sorted order.
+         */
+        static std::vector<vm::vec3> pickAllHandles(const VertexHandleManager& manager, const vm::ray3& pickRay, const Renderer::Camera& camera) {
+            const auto handleRadius = static_cast<FloatType>(pref(Preferences::HandleRadius));
+
+            Model::PickResult pickResult;
+            manager.pick([&](const vm::vec3& position) {
+                const auto distance = camera.pickPointHandle(pickRay, position, handleRadius);
+                if (vm::is_nan(distance)) {
+                    return Model::Hit::NoHit;
+                }
+                return Model::Hit::hit(VertexHandleManager::HandleHitType, distance, vm::point_at_distance(pickRay, distance), position);
+            }, pickResult);
+
+            return sortedHitTargets<vm::vec3>(pickResult);
+        }
+
+        static std::vector<vm::vec3> pickIndexedHandles(const VertexHandleManager& manager, const vm::ray3& pickRay, const Renderer::Camera& camera) {
+            Model::PickResult pickResult;
+            manager.pick(pickRay, camera, pickResult);
+
+            return sortedHitTargets<vm::vec3>(pickResult);
+        }
+
+        TEST_CASE("VertexHandleManagerTest.pickMatchesExhaustiveSearch", "[VertexHandleManagerTest]") {
+            VertexHandleManager manager;
+            const auto positions = makeHandlePositions(10000u);
+            for (const auto& position : positions) {
+                manager.add(position);
+            }
+
+            checkPicks([&](const vm::ray3& pickRay, const Renderer::Camera& camera) {
+                return pickAllHandles(manager, pickRay, camera);
+            }, [&](const vm::ray3& pickRay, const Renderer::Camera& camera) {
+                return pickIndexedHandles(manager, pickRay, camera);
+            });
+        }
+
+        TEST_CASE("VertexHandleManagerTest.pickEdgeHandlesMatchesExhaustiveSearch", "[VertexHandleManagerTest]") {
+            EdgeHandleManager manager;
+            for (const auto& edge : makeEdgeHandles(5000u)) {
+                manager.add(edge);
+            }
+
+            const auto handleRadius = static_cast<FloatType>(pref(Preferences::HandleRadius));
+            const Grid grid(4);
+
+            SECTION("center handles") {
+                checkPicks([&](const vm::ray3& pickRay, const Renderer::Camera& camera) {
+                    Model::PickResult pickResult;
+                    manager.pick([&](const vm::segment3& edge) {
+                        const auto distance = camera.pickPointHandle(pickRay, edge.center(), handleRadius);
+                        if (vm::is_nan(distance)) {
+                            return Model::Hit::NoHit;
+                        }
+                        return Model::Hit::hit(EdgeHandleManager::HandleHitType, distance, vm::point_at_distance(pickRay, distance), edge);
+                    }, pickResult);
+                    return sortedHitTargets<vm::segment3>(pickResult);
+                }, [&](const vm::ray3& pickRay, const Renderer::Camera& camera) {
+                    Model::PickResult pickResult;
+                    manager.pickCenterHandle(pickRay, camera, pickResult);
+                    return sortedHitTargets<vm::segment3>(pickResult);
+                });
+            }
+
+            SECTION("grid handles") {
+                checkPicks([&](const vm::ray3& pickRay, const Renderer::Camera& camera) {
+                    Model::PickResult pickResult;
+                    manager.pick([&](const vm::segment3& edge) {
+                        const auto edgeDistance = camera.pickLineSegmentHandle(pickRay, edge, handleRadius);
+                        if (vm::is_nan(edgeDistance)) {
+                            return Model::Hit::NoHit;
+                        }
+
+                        const auto pointHandle = grid.snap(vm::point_at_distance(pickRay, edgeDistance), edge);
+                        const auto distance = camera.pickPointHandle(pickRay, pointHandle, handleRadius);
+                        if (vm::is_nan(distance)) {
+                            return Model::Hit::NoHit;
+                        }
+                        return Model::Hit::hit(EdgeHandleManager::HandleHitType, distance, vm::point_at_distance(pickRay, distance), EdgeHandleManager::HitType(edge, pointHandle));
+                    }, pickResult);
+                    return sortedHitTargets<EdgeHandleManager::HitType>(pickResult);
+                }, [&](const vm::ray3& pickRay, const Renderer::Camera& camera) {
+                    Model::PickResult pickResult;
+                    manager.pickGridHandle(pickRay, camera, grid, pickResult);
+                    return sortedHitTargets<EdgeHandleManager::HitType>(pickResult);
+                });
+            }
+        }
+
+        TEST_CASE("VertexHandleManagerTest.pickFaceHandlesMatchesExhaustiveSearch", "[VertexHandleManagerTest]") {
+            FaceHandleManager manager;
+            for (const auto& face : makeFaceHandles(5000u)) {
+                manager.add(face);
+            }
+
+            const auto handleRadius = static_cast<FloatType>(pref(Preferences::HandleRadius));
+            const Grid grid(4);
+
+            SECTION("center handles") {
+                checkPicks([&](const vm::ray3& pickRay, const Renderer::Camera& camera) {
+                    Model::PickResult pickResult;
+                    manager.pick([&](const vm::polygon3& face) {
+                        const auto distance = camera.pickPointHandle(pickRay, face.center(), handleRadius);
+                        if (vm::is_nan(distance)) {
+                            return Model::Hit::NoHit;
+                        }
+                        return Model::Hit::hit(FaceHandleManager::HandleHitType, distance, vm::point_at_distance(pickRay, distance), face);
+                    }, pickResult);
+                    return sortedHitTargets<vm::polygon3>(pickResult);
+                }, [&](const vm::ray3& pickRay, const Renderer::Camera& camera) {
+                    Model::PickResult pickResult;
+                    manager.pickCenterHandle(pickRay, camera, pickResult);
+                    return sortedHitTargets<vm::polygon3>(pickResult);
+                });
+            }
+
+            SECTION("grid handles") {
+                checkPicks([&](const vm::ray3& pickRay, const Renderer::Camera& camera) {
+                    Model::PickResult pickResult;
+                    manager.pick([&](const vm::polygon3& face) {
+                        const auto [valid, plane] = vm::from_points(std::begin(face), std::end(face));
+                        if (!valid) {
+                            return Model::Hit::NoHit;
+                        }
+
+                        const auto faceDistance = vm::intersect_ray_polygon(pickRay, plane, std::begin(face), std::end(face));
+                        if (vm::is_nan(faceDistance)) {
+                            return Model::Hit::NoHit;
+                        }
+
+                        const auto pointHandle = grid.snap(vm::point_at_distance(pickRay, faceDistance), plane);
+                        const auto distance = camera.pickPointHandle(pickRay, pointHandle, handleRadius);
+                        if (vm::is_nan(distance)) {
+                            return Model::Hit::NoHit;
+                        }
+                        return Model::Hit::hit(FaceHandleManager::HandleHitType, distance, vm::point_at_distance(pickRay, distance), FaceHandleManager::HitType(face, pointHandle));
+                    }, pickResult);
+                    return sortedHitTargets<FaceHandleManager::HitType>(pickResult);
+                }, [&](const vm::ray3& pickRay, const Renderer::Camera& camera) {
+                    Model::PickResult pickResult;
+                    manager.pickGridHandle(pickRay, camera, grid, pickResult);
+                    return sortedHitTargets<FaceHandleManager::HitType>(pickResult);
+                });
+            }
+        }
+
+        TEST_CASE("VertexHandleManagerTest.selectCloseHandles", "[VertexHandleManagerTest]") {
+            VertexHandleManager manager;
+            manager.add(vm::vec3(64, 0, 0));
+            manager.add(vm::vec3(64, 0, 0));
+            manager.add(vm::vec3(0, 0, 0));
+            manager.add(vm::vec3(63.9, 0, 0));
+            ASSERT_EQ(3u, manager.totalHandleCount());
+
+            manager.select(vm::vec3(64.0000001, 0, 0));
+            CHECK(manager.selected(vm::vec3(64, 0, 0)));
+            CHECK_FALSE(manager.selected(vm::vec3(63.9, 0, 0)));
+            CHECK_FALSE(manager.selected(vm::vec3(0, 0, 0)));
+            CHECK(manager.selectedHandleCount() == 1u);
+
+            CHECK(manager.remove(vm::vec3(64, 0, 0)));
+            CHECK(manager.selected(vm::vec3(64, 0, 0)));
+
+            CHECK(manager.remove(vm::vec3(64, 0, 0)));
+            CHECK_FALSE(manager.contains(vm::vec3(64, 0, 0)));
+            CHECK(manager.selectedHandleCount() == 0u);
+
+            manager.select(vm::vec3(64, 0, 0));
+            CHECK(manager.selectedHandleCount() == 0u);
+
+            manager.clear();
+            manager.add(vm::vec3(0, 0, 0));
+            manager.select(vm::vec3(0, 0, 0));
+            CHECK(manager.selected(vm::vec3(0, 0, 0)));
+        }
+    }
+}
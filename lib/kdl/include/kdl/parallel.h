@@ -0,0 +1,139 @@
+/*
+ Copyright 2010-2019 Kristian Duske
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef KDL_PARALLEL_H
+#define KDL_PARALLEL_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace kdl {
+    /**
+     * Returns the number of worker threads to use by default. This is the number of hardware threads, but at least 1.
+     */
+    inline std::size_t parallel_default_thread_count() {
+        return std::max(static_cast<std::size_t>(std::thread::hardware_concurrency()), static_cast<std::size_t>(1u));
+    }
+
+    /**
+     * Calls the given function for every index in [0, count). The calls are distributed over the given number of
+     * threads, with the calling thread acting as one of them. The order in which the indices are processed is
+     * unspecified, so the given function must not depend on it.
+     *
+     * If any invocation throws an exception, the remaining indices are skipped and the first exception thrown is
+     * rethrown on the calling thread once all threads have finished.
+     *
+     * @tparam F the type of the function to call, must be callable with a single std::size_t argument
+     * @param count the number of indices
+     * @param f the function to call
+     * @param thread_count the maximum number of threads to use, if 1, all indices are processed on the calling thread
+     */
+    template <typename F>
+    void parallel_for(const std::size_t count, F&& f, const std::size_t thread_count = parallel_default_thread_count()) {
+        if (count == 0u) {
+            return;
+        }
+
+        const auto actual_thread_count = std::min(std::max(thread_count, static_cast<std::size_t>(1u)), count);
+        if (actual_thread_count == 1u) {
+            for (std::size_t i = 0u; i < count; ++i) {
+                f(i);
+            }
+            return;
+        }
+
+        std::atomic<std::size_t> next_index(0u);
+        std::atomic<bool> failed(false);
+        std::exception_ptr first_exception;
+        std::mutex exception_mutex;
+
+        const auto work = [&]() {
+            while (!failed) {
+                const auto i = next_index++;
+                if (i >= count) {
+                    break;
+                }
+
+                try {
+                    f(i);
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(exception_mutex);
+                    if (!first_exception) {
+                        first_exception = std::current_exception();
+                    }
+                    failed = true;
+                }
+            }
+        };
+
+        std::vector<std::thread> threads;
+        threads.reserve(actual_thread_count - 1u);
+        for (std::size_t i = 0u; i < actual_thread_count - 1u; ++i) {
+            threads.emplace_back(work);
+        }
+
+        work();
+
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        if (first_exception) {
+            std::rethrow_exception(first_exception);
+        }
+    }
+
+    /**
+     * Applies the given transformation to every element of the given vector and returns a vector containing the
+     * results. The transformation is applied in parallel, but the order of the results corresponds to the order of the
+     * elements in the given vector.
+     *
+     * @tparam T the type of the vector elements
+     * @tparam A the allocator type of the vector
+     * @tparam L the type of the transformation, must be callable with a const T& argument
+     * @param v the vector to transform
+     * @param lambda the transformation
+     * @param thread_count the maximum number of threads to use
+     * @return a vector containing the transformed values in the order of the elements of v
+     */
+    template <typename T, typename A, typename L>
+    auto vec_parallel_transform(const std::vector<T, A>& v, L&& lambda, const std::size_t thread_count = parallel_default_thread_count()) {
+        using ResultType = std::invoke_result_t<L, const T&>;
+
+        // results are stored in optionals so that ResultType need not be default constructible
+        std::vector<std::optional<ResultType>> slots(v.size());
+        parallel_for(v.size(), [&](const std::size_t i) {
+            slots[i] = lambda(v[i]);
+        }, thread_count);
+
+        std::vector<ResultType> result;
+        result.reserve(slots.size());
+        for (auto& slot : slots) {
+            result.push_back(std::move(*slot));
+        }
+        return result;
+    }
+}
+
+#endif //KDL_PARALLEL_H
@@ -0,0 +1,71 @@
+/*
+ Copyright 2010-2019 Kristian Duske
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include <catch2/catch.hpp>
+
+#include "GTestCompat.h"
+
+#include "kdl/parallel.h"
+
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace kdl {
+    TEST_CASE("parallel_test.parallel_for", "[parallel_test]") {
+        for (const std::size_t thread_count : { 1u, 2u, 4u, 16u }) {
+            std::vector<std::atomic<int>> counts(1000u);
+            parallel_for(counts.size(), [&](const std::size_t i) {
+                ++counts[i];
+            }, thread_count);
+
+            for (const auto& count : counts) {
+                ASSERT_EQ(1, count.load());
+            }
+        }
+    }
+
+    TEST_CASE("parallel_test.parallel_for_empty", "[parallel_test]") {
+        std::atomic<int> calls(0);
+        parallel_for(0u, [&](const std::size_t) { ++calls; });
+        ASSERT_EQ(0, calls.load());
+    }
+
+    TEST_CASE("parallel_test.parallel_for_rethrows", "[parallel_test]") {
+        ASSERT_THROW(parallel_for(100u, [](const std::size_t i) {
+            if (i == 50u) {
+                throw std::runtime_error("fail");
+            }
+        }, 4u), std::runtime_error);
+    }
+
+    TEST_CASE("parallel_test.vec_parallel_transform", "[parallel_test]") {
+        std::vector<int> input;
+        for (int i = 0; i < 1000; ++i) {
+            input.push_back(i);
+        }
+
+        const auto result = vec_parallel_transform(input, [](const int i) { return std::to_string(i * 2); }, 8u);
+        ASSERT_EQ(input.size(), result.size());
+        for (std::size_t i = 0u; i < input.size(); ++i) {
+            ASSERT_EQ(std::to_string(input[i] * 2), result[i]);
+        }
+
+        ASSERT_TRUE(vec_parallel_transform(std::vector<int>{}, [](const int i) { return i; }).empty());
+    }
+}